@@ -0,0 +1,494 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fmt/format.h"
+
+#include "ies/Time/TimeUtilFormat.hxx"
+
+#include "score2dx/Core/Core.hpp"
+#include "score2dx/Core/MusicDatabase.hpp"
+#include "score2dx/Csv/Csv.hpp"
+#include "score2dx/Csv/CsvCache.hpp"
+#include "score2dx/Csv/CsvColumn.hpp"
+#include "score2dx/Csv/CsvRowTokenizer.hpp"
+#include "score2dx/Iidx/Version.hpp"
+
+//! @brief Count of global operator new calls in process, used to report allocations per CSV row.
+std::atomic<std::size_t> AllocationCount{0};
+
+void*
+operator new(std::size_t size)
+{
+    ++AllocationCount;
+    if (auto* pointer = std::malloc(size==0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void
+operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void
+operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+//! @brief Get worker counts 1, 2, 4, ... hardware concurrency.
+std::vector<std::size_t>
+GetBenchmarkThreadCounts()
+{
+    std::vector<std::size_t> threadCounts;
+    auto hardwareConcurrency = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    for (std::size_t threadCount = 1; threadCount<hardwareConcurrency; threadCount *= 2)
+    {
+        threadCounts.emplace_back(threadCount);
+    }
+    threadCounts.emplace_back(hardwareConcurrency);
+    return threadCounts;
+}
+
+//! @brief Build MusicDatabase from Json (snapshot disabled) with 1, 2, 4, ... hardware concurrency workers,
+//! print median construction time of each worker count.
+void
+BenchmarkMusicDatabaseConstruction(const std::string &filename, std::size_t repeatCount)
+{
+    auto threadCounts = GetBenchmarkThreadCounts();
+
+    std::vector<std::string> results;
+    double singleThreadMs = 0.0;
+    for (auto threadCount : threadCounts)
+    {
+        std::vector<double> durationMs;
+        for (std::size_t i = 0; i<repeatCount; ++i)
+        {
+            auto begin = ies::Time::Now();
+            score2dx::MusicDatabase musicDatabase{filename, {threadCount, false}};
+            durationMs.emplace_back(static_cast<double>(ies::Time::CountNs(begin))/1e6);
+        }
+
+        std::sort(durationMs.begin(), durationMs.end());
+        auto medianMs = durationMs[durationMs.size()/2];
+        if (threadCount==1) { singleThreadMs = medianMs; }
+        results.emplace_back(fmt::format("threads {:>3}: median {:>8.1f} ms, speedup {:.2f}x",
+                                         threadCount, medianMs, singleThreadMs/medianMs));
+    }
+
+    std::cout << "MusicDatabase construction [" << filename << "], repeat " << repeatCount << ":\n";
+    for (auto &result : results)
+    {
+        std::cout << "    " << result << "\n";
+    }
+}
+
+//! @brief Load MusicDatabase from snapshot eagerly and lazily, then touch only latest version's first music,
+//! print median time of each.
+void
+BenchmarkMusicDatabaseLazyLoad(const std::string &filename, std::size_t repeatCount)
+{
+    //'' make sure snapshot exists.
+    score2dx::MusicDatabase{filename};
+
+    auto latestMusicId = score2dx::ToMusicId(score2dx::GetLatestVersionIndex(), 0);
+    std::vector<std::string> results;
+    for (auto lazyMaterialize : {false, true})
+    {
+        std::vector<double> durationMs;
+        for (std::size_t i = 0; i<repeatCount; ++i)
+        {
+            auto begin = ies::Time::Now();
+            score2dx::MusicDatabase musicDatabase{filename, {0, true, lazyMaterialize}};
+            musicDatabase.GetMusic(latestMusicId);
+            durationMs.emplace_back(static_cast<double>(ies::Time::CountNs(begin))/1e6);
+        }
+
+        std::sort(durationMs.begin(), durationMs.end());
+        results.emplace_back(fmt::format("{:<5}: median {:>8.1f} ms",
+                                         lazyMaterialize ? "lazy" : "eager", durationMs[durationMs.size()/2]));
+    }
+
+    std::cout << "MusicDatabase snapshot load and access latest version [" << filename << "], repeat " << repeatCount << ":\n";
+    for (auto &result : results)
+    {
+        std::cout << "    " << result << "\n";
+    }
+}
+
+//! @brief Make official-like CSV content with one row for every music in database.
+std::string
+MakeCsvContent(const std::string &musicDatabaseFilename)
+{
+    score2dx::MusicDatabase musicDatabase{musicDatabaseFilename};
+    std::string content = "version,title,genre,artist,play count,...\n";
+    auto &allTimeMusics = musicDatabase.GetAllTimeMusics();
+    for (std::size_t versionIndex = 0; versionIndex<allTimeMusics.size(); ++versionIndex)
+    {
+        auto &csvVersion = versionIndex<2 ? score2dx::Official1stSubVersionName : score2dx::VersionNames[versionIndex];
+        for (auto &music : allTimeMusics[versionIndex])
+        {
+            auto title = music.GetMusicInfo().GetField(score2dx::MusicInfoField::Title);
+            std::replace(title.begin(), title.end(), ',', '.');
+            content += csvVersion+","+title
+                       +",GENRE,ARTIST,4,0,0,0,0,---,NO PLAY,---,5,980,443,94,1,FULLCOMBO CLEAR,AAA,9,1679,747,185,2,"
+                        "FULLCOMBO CLEAR,AA,11,1881,757,367,59,EASY CLEAR,A,0,0,0,0,---,NO PLAY,---,2021-12-04 15:33\n";
+        }
+    }
+    return content;
+}
+
+//! @brief Parse all rows of CSV content with ParseCsvLine per line and with CsvRowTokenizer over whole buffer,
+//! print median rows per second and heap allocations per row of each.
+void
+BenchmarkCsvParse(const std::string &csvContent, const std::string &source, std::size_t repeatCount)
+{
+    std::vector<std::string> results;
+    for (auto useTokenizer : {false, true})
+    {
+        std::vector<double> rowsPerSecond;
+        double allocationsPerRow = 0.0;
+        for (std::size_t i = 0; i<repeatCount; ++i)
+        {
+            std::size_t rowCount = 0;
+            auto allocationCountBegin = AllocationCount.load();
+            auto begin = ies::Time::Now();
+            if (useTokenizer)
+            {
+                score2dx::CsvRowTokenizer tokenizer{csvContent};
+                score2dx::CsvRowToken row;
+                score2dx::CsvParser parser;
+                tokenizer.Next(row);
+                while (tokenizer.Next(row))
+                {
+                    parser.ParseRow(row);
+                    ++rowCount;
+                }
+            }
+            else
+            {
+                std::string_view contentView{csvContent};
+                auto start = contentView.find('\n')+1;
+                while (start<contentView.size())
+                {
+                    auto end = std::min(contentView.find('\n', start), contentView.size());
+                    score2dx::ParseCsvLine(contentView.substr(start, end-start));
+                    ++rowCount;
+                    start = end+1;
+                }
+            }
+            rowsPerSecond.emplace_back(static_cast<double>(rowCount)*1e9/static_cast<double>(ies::Time::CountNs(begin)));
+            allocationsPerRow = static_cast<double>(AllocationCount.load()-allocationCountBegin)/static_cast<double>(std::max<std::size_t>(rowCount, 1));
+        }
+
+        std::sort(rowsPerSecond.begin(), rowsPerSecond.end());
+        results.emplace_back(fmt::format("{:<15}: median {:>12.0f} rows/s, {:.2f} allocations/row",
+                                         useTokenizer ? "CsvRowTokenizer" : "ParseCsvLine", rowsPerSecond[rowsPerSecond.size()/2], allocationsPerRow));
+    }
+
+    std::cout << "CSV parse [" << source << "], repeat " << repeatCount << ":\n";
+    for (auto &result : results)
+    {
+        std::cout << "    " << result << "\n";
+    }
+}
+
+//! @brief Construct Csv from official CSV file of rowCount rows with 1, 2, 4, ... hardware concurrency parse workers,
+//! print median construction time and heap allocations per row of each worker count, and median CsvCache restore time.
+void
+BenchmarkCsvConstruct(const std::string &musicDatabaseFilename,
+                      const std::string &csvFilename,
+                      std::size_t rowCount,
+                      std::size_t repeatCount)
+{
+    score2dx::MusicDatabase musicDatabase{musicDatabaseFilename};
+
+    std::vector<std::string> results;
+    double singleThreadMs = 0.0;
+    for (auto threadCount : GetBenchmarkThreadCounts())
+    {
+        std::vector<double> durationMs;
+        double allocationsPerRow = 0.0;
+        for (std::size_t i = 0; i<repeatCount; ++i)
+        {
+            auto allocationCountBegin = AllocationCount.load();
+            auto begin = ies::Time::Now();
+            score2dx::Csv csv{csvFilename, musicDatabase, false, false, threadCount};
+            durationMs.emplace_back(static_cast<double>(ies::Time::CountNs(begin))/1e6);
+            allocationsPerRow = static_cast<double>(AllocationCount.load()-allocationCountBegin)/static_cast<double>(std::max<std::size_t>(rowCount, 1));
+        }
+
+        std::sort(durationMs.begin(), durationMs.end());
+        auto medianMs = durationMs[durationMs.size()/2];
+        if (threadCount==1) { singleThreadMs = medianMs; }
+        results.emplace_back(fmt::format("threads {:>3}: median {:>8.1f} ms, speedup {:.2f}x, {:.2f} allocations/row",
+                                         threadCount, medianMs, singleThreadMs/medianMs, allocationsPerRow));
+    }
+
+    //'' restore from cache file written by previous CsvCache, as repeated LoadDirectory does.
+    auto cacheFilename = (std::filesystem::temp_directory_path()/score2dx::CsvCacheFilename).string();
+    std::filesystem::remove(cacheFilename);
+    {
+        score2dx::CsvCache csvCache{cacheFilename, musicDatabase};
+        csvCache.Load(csvFilename);
+        csvCache.Save(true);
+    }
+    score2dx::CsvCache csvCache{cacheFilename, musicDatabase};
+    std::vector<double> restoreUs;
+    for (std::size_t i = 0; i<repeatCount; ++i)
+    {
+        auto begin = ies::Time::Now();
+        csvCache.Load(csvFilename);
+        restoreUs.emplace_back(static_cast<double>(ies::Time::CountNs(begin))/1e3);
+    }
+    std::filesystem::remove(cacheFilename);
+    std::sort(restoreUs.begin(), restoreUs.end());
+    results.emplace_back(fmt::format("CsvCache restore: median {:>8.1f} us", restoreUs[restoreUs.size()/2]));
+
+    std::cout << "Csv construction [" << csvFilename << "], repeat " << repeatCount << ":\n";
+    for (auto &result : results)
+    {
+        std::cout << "    " << result << "\n";
+    }
+}
+
+//! @brief Load player directory into new Core with 1, 2, 4, ... hardware concurrency workers,
+//! print median load time of each worker count. CSV cache is disabled to measure parsing.
+void
+BenchmarkLoadDirectory(const std::string &musicDatabaseFilename, const std::string &directory, std::size_t repeatCount)
+{
+    auto musicDatabase = std::make_shared<const score2dx::MusicDatabase>(musicDatabaseFilename);
+
+    std::vector<std::string> results;
+    double singleThreadMs = 0.0;
+    for (auto threadCount : GetBenchmarkThreadCounts())
+    {
+        std::vector<double> durationMs;
+        for (std::size_t i = 0; i<repeatCount; ++i)
+        {
+            score2dx::Core core{musicDatabase};
+            auto begin = ies::Time::Now();
+            if (!core.LoadDirectory(directory, false, false, threadCount, false))
+            {
+                throw std::runtime_error("cannot load directory ["+directory+"].");
+            }
+            durationMs.emplace_back(static_cast<double>(ies::Time::CountNs(begin))/1e6);
+        }
+
+        std::sort(durationMs.begin(), durationMs.end());
+        auto medianMs = durationMs[durationMs.size()/2];
+        if (threadCount==1) { singleThreadMs = medianMs; }
+        results.emplace_back(fmt::format("threads {:>3}: median {:>8.1f} ms, speedup {:.2f}x",
+                                         threadCount, medianMs, singleThreadMs/medianMs));
+    }
+
+    std::cout << "Core::LoadDirectory [" << directory << "], repeat " << repeatCount << ":\n";
+    for (auto &result : results)
+    {
+        std::cout << "    " << result << "\n";
+    }
+}
+
+//! @brief Export SP scores of player directory, then import the exported file into new Core,
+//! print median import throughput in MB/s and heap allocations per imported MusicScore.
+void
+BenchmarkImport(const std::string &musicDatabaseFilename, const std::string &directory, std::size_t repeatCount)
+{
+    auto musicDatabase = std::make_shared<const score2dx::MusicDatabase>(musicDatabaseFilename);
+    score2dx::Core core{musicDatabase};
+    if (!core.LoadDirectory(directory, false, false, 1, false))
+    {
+        throw std::runtime_error("cannot load directory ["+directory+"].");
+    }
+
+    auto iidxId = std::filesystem::canonical(directory).filename().string().substr(0, 9);
+    auto outputDirectory = std::filesystem::temp_directory_path()/"score2dx_benchmark_import";
+    std::filesystem::remove_all(outputDirectory);
+    std::filesystem::create_directories(outputDirectory);
+    core.Export(iidxId, score2dx::PlayStyle::SinglePlay, outputDirectory.string(), "official", "benchmark");
+
+    for (auto &entry : std::filesystem::directory_iterator{outputDirectory})
+    {
+        auto exportedFilename = entry.path().string();
+        auto fileSize = static_cast<double>(std::filesystem::file_size(entry.path()));
+
+        std::vector<double> megabytesPerSecond;
+        double allocationsPerScore = 0.0;
+        for (std::size_t i = 0; i<repeatCount; ++i)
+        {
+            score2dx::Core importCore{musicDatabase};
+            importCore.AddPlayer(iidxId);
+            auto allocationCountBegin = AllocationCount.load();
+            auto begin = ies::Time::Now();
+            importCore.Import(iidxId, exportedFilename);
+            megabytesPerSecond.emplace_back(fileSize*1e3/static_cast<double>(ies::Time::CountNs(begin)));
+
+            std::size_t scoreCount = 0;
+            for (auto &[musicId, versionScoreTable] : importCore.GetPlayerScore(iidxId).GetVersionScoreTables())
+            {
+                (void)musicId;
+                for (auto scoreVersionIndex : score2dx::GetSupportScoreVersionRange())
+                {
+                    scoreCount += versionScoreTable.GetMusicScores(scoreVersionIndex, score2dx::PlayStyle::SinglePlay).size();
+                }
+            }
+            allocationsPerScore = static_cast<double>(AllocationCount.load()-allocationCountBegin)/static_cast<double>(std::max<std::size_t>(scoreCount, 1));
+        }
+
+        std::sort(megabytesPerSecond.begin(), megabytesPerSecond.end());
+        std::cout << "Core::Import [" << exportedFilename << "] " << fmt::format("{:.1f}", fileSize/1e6) << " MB, repeat " << repeatCount << ":\n"
+                  << "    " << fmt::format("median {:>8.1f} MB/s, {:.2f} allocations/score", megabytesPerSecond[megabytesPerSecond.size()/2], allocationsPerScore) << "\n";
+    }
+    std::filesystem::remove_all(outputDirectory);
+}
+
+//! @brief Make playerCount players from scores of player directory (exported Json imported with other IIDX IDs),
+//! print median time of exporting SP and DP of all players by Core::Export calls and by Core::ExportPlayers
+//! with 1, 2, 4, ... hardware concurrency workers.
+void
+BenchmarkExportPlayers(const std::string &musicDatabaseFilename,
+                       const std::string &directory,
+                       std::size_t playerCount,
+                       std::size_t repeatCount)
+{
+    auto musicDatabase = std::make_shared<const score2dx::MusicDatabase>(musicDatabaseFilename);
+    score2dx::Core sourceCore{musicDatabase};
+    if (!sourceCore.LoadDirectory(directory, false, false, 1, false))
+    {
+        throw std::runtime_error("cannot load directory ["+directory+"].");
+    }
+
+    auto iidxId = std::filesystem::canonical(directory).filename().string().substr(0, 9);
+    auto outputDirectory = std::filesystem::temp_directory_path()/"score2dx_benchmark_export_players";
+    std::filesystem::remove_all(outputDirectory);
+    std::filesystem::create_directories(outputDirectory/"source");
+    for (auto playStyle : {score2dx::PlayStyle::SinglePlay, score2dx::PlayStyle::DoublePlay})
+    {
+        sourceCore.Export(iidxId, playStyle, (outputDirectory/"source").string());
+    }
+
+    score2dx::Core core{musicDatabase};
+    std::vector<std::string> iidxIds;
+    for (auto &entry : std::filesystem::directory_iterator{outputDirectory/"source"})
+    {
+        std::ifstream exportedFile{entry.path()};
+        std::stringstream exportedStream;
+        exportedStream << exportedFile.rdbuf();
+        auto exported = exportedStream.str();
+        auto idPosition = exported.rfind("\"id\":\""+iidxId+"\"");
+        if (idPosition==std::string::npos)
+        {
+            throw std::runtime_error("cannot find id in ["+entry.path().string()+"].");
+        }
+
+        auto playerFilename = outputDirectory/entry.path().filename();
+        for (std::size_t i = 0; i<playerCount; ++i)
+        {
+            auto playerIidxId = fmt::format("{:04}-{:04}", 1000+i, 5000+i);
+            exported.replace(idPosition+std::string_view{"\"id\":\""}.size(), playerIidxId.size(), playerIidxId);
+            std::ofstream{playerFilename} << exported;
+            core.Import(playerIidxId, playerFilename.string());
+            if (iidxIds.size()<playerCount) { iidxIds.emplace_back(playerIidxId); }
+        }
+        std::filesystem::remove(playerFilename);
+    }
+
+    auto exportDirectory = outputDirectory/"export";
+    std::filesystem::create_directories(exportDirectory);
+    auto MeasureMs = [&](auto &&exportAll)
+    {
+        std::vector<double> durationMs;
+        for (std::size_t i = 0; i<repeatCount; ++i)
+        {
+            auto begin = ies::Time::Now();
+            exportAll();
+            durationMs.emplace_back(static_cast<double>(ies::Time::CountNs(begin))/1e6);
+        }
+        std::sort(durationMs.begin(), durationMs.end());
+        return durationMs[durationMs.size()/2];
+    };
+
+    auto exportCallMs = MeasureMs([&]()
+    {
+        for (auto &playerIidxId : iidxIds)
+        {
+            auto playerDirectory = exportDirectory/playerIidxId;
+            std::filesystem::create_directories(playerDirectory);
+            core.Export(playerIidxId, score2dx::PlayStyle::SinglePlay, playerDirectory.string());
+            core.Export(playerIidxId, score2dx::PlayStyle::DoublePlay, playerDirectory.string());
+        }
+    });
+
+    std::cout << "Export SP and DP of " << iidxIds.size() << " players, repeat " << repeatCount << ":\n"
+              << "    " << fmt::format("Core::Export calls:      median {:>8.1f} ms", exportCallMs) << "\n";
+    for (auto threadCount : GetBenchmarkThreadCounts())
+    {
+        auto exportPlayersMs = MeasureMs([&]()
+        {
+            core.ExportPlayers(exportDirectory.string(), iidxIds, "official", "", threadCount);
+        });
+        std::cout << "    " << fmt::format("ExportPlayers threads {:>3}: median {:>8.1f} ms, speedup {:.2f}x",
+                                           threadCount, exportPlayersMs, exportCallMs/exportPlayersMs) << "\n";
+    }
+    std::filesystem::remove_all(outputDirectory);
+}
+
+int
+main(int argc, char* argv[])
+{
+    //'' usage: benchmark [musicDatabaseFilename] [repeatCount] [csvFilename|-] [playerDirectory]
+    //'' csvFilename "-" or omitted: generate CSV from music database.
+    try
+    {
+        std::string filename = argc>1 ? argv[1] : score2dx::GetUsingMusicDatabaseFilename();
+        std::size_t repeatCount = argc>2 ? std::stoull(argv[2]) : 5;
+        repeatCount = std::max<std::size_t>(repeatCount, 1);
+        BenchmarkMusicDatabaseConstruction(filename, repeatCount);
+        BenchmarkMusicDatabaseLazyLoad(filename, repeatCount);
+
+        if (argc>3&&std::string{argv[3]}!="-")
+        {
+            std::ifstream csvFile{argv[3]};
+            std::stringstream csvStream;
+            csvStream << csvFile.rdbuf();
+            auto csvContent = csvStream.str();
+            BenchmarkCsvParse(csvContent, argv[3], repeatCount);
+            //'' rows exclude header line.
+            auto rowCount = static_cast<std::size_t>(std::count(csvContent.begin(), csvContent.end(), '\n'));
+            BenchmarkCsvConstruct(filename, argv[3], rowCount>0 ? rowCount-1 : 0, repeatCount);
+        }
+        else
+        {
+            BenchmarkCsvParse(MakeCsvContent(filename), "generated from "+filename, repeatCount);
+        }
+
+        if (argc>4)
+        {
+            BenchmarkLoadDirectory(filename, argv[4], repeatCount);
+            BenchmarkImport(filename, argv[4], repeatCount);
+            BenchmarkExportPlayers(filename, argv[4], 64, repeatCount);
+        }
+
+        return 0;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception:\n" << e.what() << std::endl;
+        return 1;
+    }
+}
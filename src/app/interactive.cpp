@@ -119,7 +119,7 @@ main(int argc, char* argv[])
                     auto musicId = std::stoull(tokens[1]);
                     auto styleDifficulty = score2dx::ToStyleDifficulty(tokens[2]);
                     auto [playStyle, difficulty] = score2dx::Split(styleDifficulty);
-                    auto &playerScore = core.GetPlayerScores().at("5483-7391");
+                    auto &playerScore = core.GetPlayerScore("5483-7391");
                     std::cout << "Music ["+musicDatabase.GetTitle(musicId)+"]:\n";
 
                     auto findVersionScoreTable = ies::Find(playerScore.GetVersionScoreTables(), musicId);
@@ -1,6 +1,8 @@
 #include "score2dx/Analysis/Analyzer.hpp"
 
 #include <iostream>
+#include <stdexcept>
+#include <utility>
 
 #include "ies/StdUtil/Find.hxx"
 #include "ies/Time/ScopeTimePrinter.hxx"
@@ -12,9 +14,14 @@ namespace score2dx
 {
 
 Analyzer::
-Analyzer(const MusicDatabase &musicDatabase)
-:   mMusicDatabase(musicDatabase)
+Analyzer(std::shared_ptr<const MusicDatabase> musicDatabase)
+:   mMusicDatabase(std::move(musicDatabase))
 {
+    if (!mMusicDatabase)
+    {
+        throw std::runtime_error("Analyzer: musicDatabase is null.");
+    }
+
     SetActiveVersionIndex(GetLatestVersionIndex());
 }
 
@@ -22,7 +29,7 @@ void
 Analyzer::
 SetActiveVersionIndex(std::size_t activeVersionIndex)
 {
-    if (!ies::Find(mMusicDatabase.GetActiveVersions(), activeVersionIndex))
+    if (!ies::Find(mMusicDatabase->GetActiveVersions(), activeVersionIndex))
     {
         throw std::runtime_error("ActiveVersion "+std::to_string(activeVersionIndex)+" is not supported.");
     }
@@ -52,7 +59,7 @@ const
     analysis.StatisticsByVersionStyle.resize(mActiveVersionIndex+1);
     analysis.StatisticsByVersionStyleDifficulty.resize(mActiveVersionIndex+1);
 
-    auto* activeVersionPtr = mMusicDatabase.FindActiveVersion(mActiveVersionIndex);
+    auto* activeVersionPtr = mMusicDatabase->FindActiveVersion(mActiveVersionIndex);
     if (!activeVersionPtr)
     {
         throw std::runtime_error("invalid active version");
@@ -72,7 +79,7 @@ const
     auto &versionScoreTables = playerScore.GetVersionScoreTables();
     for (auto& [musicId, chartIdSet] : musicIdSortedChartIdSets)
     {
-        auto& music = mMusicDatabase.GetMusic(musicId);
+        auto& music = mMusicDatabase->GetMusic(musicId);
 
         auto findScoreTable = ies::Find(versionScoreTables, musicId);
         if (!findScoreTable) { continue; }
@@ -83,24 +90,24 @@ const
             auto [chartMusicId, chartPlayStyle, difficulty] = ToMusicStyleDiffculty(chartId);
             auto styleDifficulty = ConvertToStyleDifficulty(chartPlayStyle, difficulty);
 
-            auto &availability = music.GetChartAvailability(styleDifficulty, mActiveVersionIndex);
+            auto availability = music.GetChartAvailability(styleDifficulty, mActiveVersionIndex);
             if (availability.ChartAvailableStatus==ChartStatus::NotAvailable
                 ||availability.ChartAvailableStatus==ChartStatus::Removed)
             {
                 throw std::runtime_error("active chart is not available.");
             }
 
-            auto* chartInfoPtr = mMusicDatabase.FindChartInfo(musicId, styleDifficulty, mActiveVersionIndex);
-            if (!chartInfoPtr)
+            auto findChartInfo = mMusicDatabase->FindChartInfo(musicId, styleDifficulty, mActiveVersionIndex);
+            if (!findChartInfo)
             {
                 throw std::runtime_error("cannot find chart info");
             }
 
-            auto &chartInfo = *chartInfoPtr;
+            auto &chartInfo = *findChartInfo;
             if (chartInfo.Note<=0)
             {
                 std::cout << "[" << ToMusicIdString(musicId)
-                          << "][" << mMusicDatabase.GetTitle(musicId)
+                          << "][" << mMusicDatabase->GetTitle(musicId)
                           << "][" << ToString(styleDifficulty)
                           << "] Note is non-positive\nLevel: " << chartInfo.Level
                           << ", Note: " << chartInfo.Note
@@ -112,7 +119,7 @@ const
 
             std::map<std::size_t, std::vector<ChartScoreRecord>> versionRecords;
 
-            for (auto versionIndex : sameChartVersions)
+            for (std::size_t versionIndex : sameChartVersions)
             {
                 if (versionIndex!=mActiveVersionIndex)
                 {
@@ -236,7 +243,7 @@ const
     }
     auto activeVersionIndex = findActiveVersionIndex.value();
 
-    auto* activeVersionPtr = mMusicDatabase.FindActiveVersion(activeVersionIndex);
+    auto* activeVersionPtr = mMusicDatabase->FindActiveVersion(activeVersionIndex);
     if (!activeVersionPtr)
     {
         throw std::runtime_error("invalid active version");
@@ -358,7 +365,7 @@ const
     }
 
     auto styleDifficulty = ConvertToStyleDifficulty(playStyle, difficulty);
-    auto findContainingAvailableRange = mMusicDatabase.FindContainingAvailableVersionRange(musicId, styleDifficulty, versionIndex);
+    auto findContainingAvailableRange = mMusicDatabase->FindContainingAvailableVersionRange(musicId, styleDifficulty, versionIndex);
     if (!findContainingAvailableRange)
     {
         return std::nullopt;
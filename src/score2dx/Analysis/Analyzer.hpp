@@ -99,7 +99,7 @@ struct ScoreAnalysis
 class Analyzer
 {
 public:
-        explicit Analyzer(const MusicDatabase &musicDatabase);
+        explicit Analyzer(std::shared_ptr<const MusicDatabase> musicDatabase);
 
         void
         SetActiveVersionIndex(std::size_t activeVersionIndex);
@@ -129,7 +129,7 @@ public:
         const;
 
 private:
-    const MusicDatabase &mMusicDatabase;
+    std::shared_ptr<const MusicDatabase> mMusicDatabase;
     //! @brief Current active version, default to latest version in music database.
     std::size_t mActiveVersionIndex{0};
 
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace score2dx
+{
+
+//! @brief FNV-1a 64 bit hash, used to detect content change of source files.
+inline std::uint64_t
+ToFnv1aHash(std::string_view bytes)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (auto c : bytes)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+//! @brief Append trivially copyable values and length-prefixed strings to byte buffer.
+//! @note Byte order is native, binary files are cache of same machine, not for exchange.
+class BinaryWriter
+{
+public:
+        template <typename T>
+        void
+        Write(const T &value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "BinaryWriter::Write requires trivially copyable type.");
+            mBuffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void
+        WriteString(std::string_view s)
+        {
+            Write(static_cast<std::uint32_t>(s.size()));
+            mBuffer.append(s);
+        }
+
+        const std::string &
+        GetBuffer()
+        const
+        {
+            return mBuffer;
+        }
+
+private:
+    std::string mBuffer;
+};
+
+//! @brief Read values written by BinaryWriter from byte view, throws if read out of bound.
+//! @note Strings are returned as view into source bytes, no copy.
+class BinaryReader
+{
+public:
+        explicit BinaryReader(std::string_view bytes)
+        :   mBytes(bytes)
+        {}
+
+        template <typename T>
+        T
+        Read()
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "BinaryReader::Read requires trivially copyable type.");
+            T value;
+            std::memcpy(&value, Take(sizeof(T)).data(), sizeof(T));
+            return value;
+        }
+
+        std::string_view
+        ReadString()
+        {
+            auto size = Read<std::uint32_t>();
+            return Take(size);
+        }
+
+        std::size_t
+        GetRemainSize()
+        const
+        {
+            return mBytes.size()-mPosition;
+        }
+
+private:
+    std::string_view mBytes;
+    std::size_t mPosition{0};
+
+        std::string_view
+        Take(std::size_t size)
+        {
+            if (size>GetRemainSize())
+            {
+                throw std::runtime_error("BinaryReader: read out of bound.");
+            }
+            auto view = mBytes.substr(mPosition, size);
+            mPosition += size;
+            return view;
+        }
+};
+
+}
@@ -1,8 +1,17 @@
 #include "score2dx/Core/Core.hpp"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
 #include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <ranges>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 
 #include "curl/curl.h"
 
@@ -13,6 +22,12 @@
 #include "ies/Time/ScopeTimePrinter.hxx"
 #include "ies/Time/TimeUtilFormat.hxx"
 
+#include "score2dx/Core/ExportedScoreReader.hpp"
+#include "score2dx/Core/JsonStreamWriter.hpp"
+#include "score2dx/Core/MappedFile.hpp"
+#include "score2dx/Core/ParallelFor.hxx"
+#include "score2dx/Core/PlayerScoreArchive.hpp"
+#include "score2dx/Csv/CsvCache.hpp"
 #include "score2dx/Iidx/Version.hpp"
 
 namespace fs = std::filesystem;
@@ -20,9 +35,403 @@ namespace fs = std::filesystem;
 namespace score2dx
 {
 
+namespace
+{
+
+//! @brief Add filePath to csvPaths or exportedPaths if it's CSV or exported file of player iidxId.
+void
+CollectPlayerFile(const std::string &iidxId,
+                  const fs::path &filePath,
+                  bool verbose,
+                  std::vector<fs::path> &csvPaths,
+                  std::vector<fs::path> &exportedPaths)
+{
+    auto filename = filePath.filename().string();
+    if (filePath.extension()==".csv")
+    {
+        auto [isValid, invalidReason] = IsValidCsvFilename(filename);
+        if (!isValid)
+        {
+            if (verbose) { std::cout << "Skip CSV ["+filename+"] with invalid filename: "+invalidReason+".\n"; }
+            return;
+        }
+
+        if (!filename.starts_with(iidxId))
+        {
+            if (verbose) { std::cout << "Skip CSV ["+filename+"] with unmatch IIDX ID.\n"; }
+            return;
+        }
+
+        csvPaths.emplace_back(filePath);
+    }
+
+    if (filePath.extension()==".json"&&filename.starts_with("score2dx_export_"))
+    {
+        exportedPaths.emplace_back(filePath);
+    }
+}
+
+//! @brief See if dateTime is in format of "YYYY-MM-DD HH:MM", same as MusicScore DateTime.
+bool
+IsDateTimeFormat(std::string_view dateTime)
+{
+    constexpr std::string_view Format{"0000-00-00 00:00"};
+    if (dateTime.size()!=Format.size())
+    {
+        return false;
+    }
+
+    for (auto i : IndexRange{0, Format.size()})
+    {
+        auto isDigit = dateTime[i]>='0'&&dateTime[i]<='9';
+        if (Format[i]=='0' ? !isDigit : dateTime[i]!=Format[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! @brief Get local date in format of "YYYY-MM-DD", used in exported filenames.
+std::string
+GetCurrentDate()
+{
+    auto t = std::time(nullptr);
+    auto date = fmt::format("{:%Y-%m-%d}", fmt::localtime(t));
+    return date;
+}
+
+//! @brief Musics of exported Json in order of {VersionName, Title, MusicId}, version name and title are resolved
+//! once and shared by exports of all players.
+struct ExportMusicOrder
+{
+    struct Entry
+    {
+        std::size_t MusicId{0};
+        //! @brief '1st&substream' for both 1st style and substream.
+        std::string_view VersionName;
+        std::string_view Title;
+    };
+
+    std::vector<Entry> Entries;
+    //! @brief Map of {MusicId, Index of Entries}.
+    std::unordered_map<std::size_t, std::size_t> EntryIndexes;
+};
+
+//! @brief Build order of musics of any of playerScores.
+ExportMusicOrder
+BuildExportMusicOrder(const MusicDatabase &musicDatabase,
+                      const std::vector<const PlayerScore*> &playerScores)
+{
+    std::set<std::size_t> musicIds;
+    for (auto* playerScore : playerScores)
+    {
+        for (auto &[musicId, versionScoreTable] : playerScore->GetVersionScoreTables())
+        {
+            (void)versionScoreTable;
+            musicIds.insert(musicId);
+        }
+    }
+
+    ExportMusicOrder musicOrder;
+    musicOrder.Entries.reserve(musicIds.size());
+    for (auto musicId : musicIds)
+    {
+        auto versionIndex = ToIndexes(musicId).first;
+        std::string_view versionName = VersionNames[versionIndex];
+        if (versionIndex==0||versionIndex==1)
+        {
+            versionName = Official1stSubVersionName;
+        }
+
+        musicOrder.Entries.push_back({musicId, versionName, musicDatabase.GetTitle(musicId)});
+    }
+
+    std::sort(musicOrder.Entries.begin(), musicOrder.Entries.end(), [](const auto &lhs, const auto &rhs)
+    {
+        return std::tie(lhs.VersionName, lhs.Title, lhs.MusicId)<std::tie(rhs.VersionName, rhs.Title, rhs.MusicId);
+    });
+    for (auto i : IndexRange{0, musicOrder.Entries.size()})
+    {
+        musicOrder.EntryIndexes.emplace(musicOrder.Entries[i].MusicId, i);
+    }
+
+    return musicOrder;
+}
+
+//! @brief Write exported Json file of each of playStyles into directoryPath, see Core::Export for format.
+//! playerScore's tables are walked once for all play styles, files are written side by side.
+//! Only scores with DateTime after sinceDateTime are written if it's not empty (delta export).
+//! @note Only reads playerScore and musicOrder, safe to call concurrently for different players.
+void
+WriteExportedJsons(const PlayerScore &playerScore,
+                   const ExportMusicOrder &musicOrder,
+                   const std::vector<PlayStyle> &playStyles,
+                   const fs::path &directoryPath,
+                   const std::string &date,
+                   const std::string &dateTimeType,
+                   const std::string &suffix,
+                   const std::string &sinceDateTime)
+{
+    //'' stream Json without building DOM, keys are written in sorted order so output is same as dump of
+    //'' Json {"data": {Version: {Title: {DateTime: {"play", "score"}}}}, "metadata": {...}}.
+
+    //'' difficulties in order of acronym, i.e. order of "score" keys.
+    static const auto sortedDifficulties = []()
+    {
+        std::vector<Difficulty> difficulties;
+        for (auto difficulty : DifficultySmartEnum::ToRange())
+        {
+            difficulties.push_back(difficulty);
+        }
+        std::sort(difficulties.begin(), difficulties.end(), [](Difficulty lhs, Difficulty rhs)
+        {
+            return ToString(static_cast<DifficultyAcronym>(lhs))<ToString(static_cast<DifficultyAcronym>(rhs));
+        });
+        return difficulties;
+    }();
+
+    struct StyleExport
+    {
+        std::ofstream File;
+        std::optional<JsonStreamWriter> Writer;
+        //! @brief Version object currently written, empty if none.
+        std::string_view OpenVersionName;
+        bool IsDataOpen{false};
+        std::string_view LastDateTime;
+    };
+
+    //'' Array of {Index=PlayStyle, StyleExport}, exports are constructed in place since writer refers to file.
+    std::array<std::optional<StyleExport>, PlayStyleSmartEnum::Size()> styleExports;
+    for (auto playStyle : playStyles)
+    {
+        auto filename = "score2dx_export_"+ToString(static_cast<PlayStyleAcronym>(playStyle))+"_"+date;
+        if (!suffix.empty())
+        {
+            filename += "_"+suffix;
+        }
+        filename += ".json";
+
+        auto path = (directoryPath / filename).lexically_normal();
+        auto &styleExport = styleExports[static_cast<std::size_t>(playStyle)].emplace();
+        styleExport.File.open(path);
+        if (!styleExport.File)
+        {
+            throw std::runtime_error("cannot open file ["+path.string()+"].");
+        }
+
+        auto &writer = styleExport.Writer.emplace(styleExport.File);
+        styleExport.LastDateTime = sinceDateTime;
+        writer.BeginObject();
+        writer.Key("data");
+    }
+
+    auto WriteIntString = [](JsonStreamWriter &writer, int value)
+    {
+        char digits[16];
+        auto result = std::to_chars(digits, digits+sizeof(digits), value);
+        writer.String(std::string_view{digits, static_cast<std::size_t>(result.ptr-digits)});
+    };
+
+    //'' Vector of {Index of musicOrder entry, VersionScoreTable} of player's musics in export order.
+    std::vector<std::pair<std::size_t, const VersionScoreTable*>> playerMusics;
+    playerMusics.reserve(playerScore.GetVersionScoreTables().size());
+    for (auto &[musicId, versionScoreTable] : playerScore.GetVersionScoreTables())
+    {
+        playerMusics.emplace_back(musicOrder.EntryIndexes.at(musicId), &versionScoreTable);
+    }
+    std::sort(playerMusics.begin(), playerMusics.end());
+
+    //'' delta export only has scores after sinceDateTime, titles without such score are omitted.
+    auto isDelta = !sinceDateTime.empty();
+
+    //'' Map of {DateTime, MusicScores in score version order}.
+    //'' Later MusicScore of same DateTime overwrites play and difficulties, same as Json assignment.
+    std::map<std::string_view, std::vector<const MusicScore*>> dateTimeScores;
+
+    //'' musics of same {VersionName, Title} are one title entry.
+    for (std::size_t titleBegin = 0; titleBegin<playerMusics.size();)
+    {
+        auto &titleEntry = musicOrder.Entries[playerMusics[titleBegin].first];
+        auto titleEnd = titleBegin+1;
+        while (titleEnd<playerMusics.size())
+        {
+            auto &entry = musicOrder.Entries[playerMusics[titleEnd].first];
+            if (entry.VersionName!=titleEntry.VersionName||entry.Title!=titleEntry.Title) { break; }
+            ++titleEnd;
+        }
+
+        for (auto playStyle : playStyles)
+        {
+            auto &styleExport = styleExports[static_cast<std::size_t>(playStyle)].value();
+            auto &writer = styleExport.Writer.value();
+
+            dateTimeScores.clear();
+            for (auto i : IndexRange{titleBegin, titleEnd})
+            {
+                auto &versionScoreTable = *playerMusics[i].second;
+                for (auto scoreVersionIndex : GetSupportScoreVersionRange())
+                {
+                    auto &musicScores = versionScoreTable.GetMusicScores(scoreVersionIndex, playStyle);
+                    auto begin = isDelta ? musicScores.upper_bound(sinceDateTime) : musicScores.begin();
+                    for (auto &[dateTime, musicScore] : std::ranges::subrange{begin, musicScores.end()})
+                    {
+                        if (dateTime>styleExport.LastDateTime)
+                        {
+                            styleExport.LastDateTime = dateTime;
+                        }
+                        dateTimeScores[dateTime].push_back(&musicScore);
+                    }
+                }
+            }
+
+            if (isDelta&&dateTimeScores.empty())
+            {
+                continue;
+            }
+
+            if (!styleExport.IsDataOpen)
+            {
+                writer.BeginObject();
+                styleExport.IsDataOpen = true;
+            }
+            if (styleExport.OpenVersionName!=titleEntry.VersionName)
+            {
+                if (!styleExport.OpenVersionName.empty())
+                {
+                    writer.EndObject();
+                }
+                writer.Key(titleEntry.VersionName);
+                writer.BeginObject();
+                styleExport.OpenVersionName = titleEntry.VersionName;
+            }
+
+            writer.Key(titleEntry.Title);
+            if (dateTimeScores.empty())
+            {
+                writer.Null();
+                continue;
+            }
+
+            writer.BeginObject();
+            for (auto &[dateTime, musicScores] : dateTimeScores)
+            {
+                writer.Key(dateTime);
+                writer.BeginObject();
+                writer.Key("play");
+                writer.Unsigned(musicScores.back()->GetPlayCount());
+                writer.Key("score");
+
+                auto hasChartScore = false;
+                for (auto difficulty : sortedDifficulties)
+                {
+                    const ChartScore* chartScorePtr = nullptr;
+                    for (auto* musicScore : musicScores)
+                    {
+                        if (auto* findChartScore = musicScore->GetChartScore(difficulty))
+                        {
+                            chartScorePtr = findChartScore;
+                        }
+                    }
+                    if (!chartScorePtr)
+                    {
+                        continue;
+                    }
+
+                    if (!hasChartScore)
+                    {
+                        writer.BeginObject();
+                        hasChartScore = true;
+                    }
+
+                    //'' [score, pgreat, great, miss, clear, djLevel], same order as CSV.
+                    auto &chartScore = *chartScorePtr;
+                    writer.Key(ToString(static_cast<DifficultyAcronym>(difficulty)));
+                    writer.BeginArray();
+                    WriteIntString(writer, chartScore.ExScore);
+                    WriteIntString(writer, chartScore.PGreatCount);
+                    WriteIntString(writer, chartScore.GreatCount);
+                    if (chartScore.MissCount)
+                    {
+                        WriteIntString(writer, chartScore.MissCount.value());
+                    }
+                    else
+                    {
+                        writer.String("---");
+                    }
+                    writer.String(ToString(chartScore.ClearType));
+                    writer.String(chartScore.ExScore==0 ? "---" : ToString(chartScore.DjLevel));
+                    writer.EndArray();
+                }
+
+                if (hasChartScore)
+                {
+                    writer.EndObject();
+                }
+                else
+                {
+                    writer.Null();
+                }
+                writer.EndObject();
+            }
+            writer.EndObject();
+        }
+
+        titleBegin = titleEnd;
+    }
+
+    for (auto playStyle : playStyles)
+    {
+        auto &styleExport = styleExports[static_cast<std::size_t>(playStyle)].value();
+        auto &writer = styleExport.Writer.value();
+        if (styleExport.IsDataOpen)
+        {
+            writer.EndObject();
+            writer.EndObject();
+        }
+        else
+        {
+            writer.Null();
+        }
+
+        //'' todo: decide score version if all score in a version.
+        writer.Key("metadata");
+        writer.BeginObject();
+        writer.Key("dateTimeType");
+        writer.String(dateTimeType);
+        writer.Key("id");
+        writer.String(playerScore.GetIidxId());
+        writer.Key("lastDateTime");
+        writer.String(styleExport.LastDateTime);
+        writer.Key("playStyle");
+        writer.String(ToString(playStyle));
+        writer.Key("scoreVersion");
+        writer.String("");
+        if (isDelta)
+        {
+            writer.Key("sinceDateTime");
+            writer.String(sinceDateTime);
+        }
+        writer.EndObject();
+        writer.EndObject();
+        writer.Flush();
+
+        styleExport.File << std::endl;
+    }
+}
+
+}
+
 Core::
 Core()
-:   mAnalyzer(mMusicDatabase)
+:   Core(GetSharedMusicDatabase())
+{
+}
+
+Core::
+Core(std::shared_ptr<const MusicDatabase> musicDatabase)
+:   mMusicDatabase(std::move(musicDatabase)),
+    mAnalyzer(mMusicDatabase)
 {
 }
 
@@ -31,9 +440,248 @@ Core::
 GetMusicDatabase()
 const
 {
+    //'' owner thread is the only writer, no lock needed for it, and a lock cannot protect returned reference.
+    return *mMusicDatabase;
+}
+
+std::shared_ptr<const MusicDatabase>
+Core::
+GetMusicDatabasePtr()
+const
+{
+    std::lock_guard lock{mMusicDatabaseMutex};
     return mMusicDatabase;
 }
 
+void
+Core::
+BeginReloadMusicDatabase(const std::string &filename)
+{
+    if (IsReloadingMusicDatabase())
+    {
+        return;
+    }
+
+    //'' snapshot of what depends on database, background task never touches members.
+    //'' PlayerScores are shared instead of copied, they are copied before change until published.
+    auto isSameFile = filename==mMusicDatabase->GetFilename();
+    auto activeVersionIndex = mAnalyzer.GetActiveVersionIndex();
+    auto sourceDatabase = mMusicDatabase;
+    std::map<std::string, std::shared_ptr<const PlayerScore>> sourcePlayerScores;
+    for (auto &[iidxId, playerScore] : mPlayerScores)
+    {
+        sourcePlayerScores.emplace(iidxId, playerScore);
+        mSharedPlayerIidxIds.insert(iidxId);
+    }
+    auto sourcePlayerCsvs = mPlayerCsvs;
+    std::vector<std::string> analyzedIidxIds;
+    for (auto &[iidxId, analysis] : mPlayerAnalyses)
+    {
+        (void)analysis;
+        analyzedIidxIds.emplace_back(iidxId);
+    }
+    std::map<std::string, std::map<ies::RangeSide, std::string>> activityDateTimeRanges;
+    for (auto &[iidxId, activityAnalysis] : mPlayerActivityAnalyses)
+    {
+        activityDateTimeRanges.emplace(iidxId, activityAnalysis.DateTimeRange);
+    }
+
+    mReloadingMusicDatabase = std::async
+    (
+        std::launch::async,
+        [filename, isSameFile, activeVersionIndex,
+         sourceDatabase = std::move(sourceDatabase),
+         sourcePlayerScores = std::move(sourcePlayerScores),
+         sourcePlayerCsvs = std::move(sourcePlayerCsvs),
+         analyzedIidxIds = std::move(analyzedIidxIds),
+         activityDateTimeRanges = std::move(activityDateTimeRanges)]()
+        {
+            ReloadedMusicDatabase reloaded;
+            reloaded.Database = isSameFile ? ReloadSharedMusicDatabase(filename) : GetSharedMusicDatabase(filename);
+            reloaded.ActiveVersionIndex = activeVersionIndex;
+            reloaded.SourcePlayerScores = sourcePlayerScores;
+            for (auto &[iidxId, playerScore] : sourcePlayerScores)
+            {
+                reloaded.PlayerScores.emplace(iidxId, std::make_shared<PlayerScore>(reloaded.Database, *playerScore));
+            }
+            reloaded.SourcePlayerCsvs = sourcePlayerCsvs;
+            for (auto &[iidxId, playStyleCsvs] : sourcePlayerCsvs)
+            {
+                for (auto &[playStyle, csvs] : playStyleCsvs)
+                {
+                    auto &reloadedCsvs = reloaded.PlayerCsvs[iidxId][playStyle];
+                    for (auto &[dateTime, csv] : csvs)
+                    {
+                        reloadedCsvs.emplace(dateTime, std::make_shared<const Csv>(*csv, *sourceDatabase, *reloaded.Database));
+                    }
+                }
+            }
+
+            reloaded.DatabaseAnalyzer = std::make_unique<Analyzer>(reloaded.Database);
+            auto &analyzer = *reloaded.DatabaseAnalyzer;
+            if (ies::Find(reloaded.Database->GetActiveVersions(), activeVersionIndex))
+            {
+                analyzer.SetActiveVersionIndex(activeVersionIndex);
+            }
+
+            for (auto &iidxId : analyzedIidxIds)
+            {
+                auto &playerScore = *reloaded.PlayerScores.at(iidxId);
+                reloaded.PlayerAnalyses.emplace(iidxId, analyzer.Analyze(playerScore));
+                reloaded.PlayerVersionActivityAnalyses.emplace(iidxId, analyzer.AnalyzeVersionActivity(playerScore));
+            }
+            for (auto &[iidxId, dateTimeRange] : activityDateTimeRanges)
+            {
+                reloaded.PlayerActivityAnalyses.emplace
+                (
+                    iidxId,
+                    analyzer.AnalyzeActivity(*reloaded.PlayerScores.at(iidxId),
+                                             dateTimeRange.at(ies::RangeSide::Begin),
+                                             dateTimeRange.at(ies::RangeSide::End))
+                );
+            }
+
+            return reloaded;
+        }
+    );
+}
+
+bool
+Core::
+IsReloadingMusicDatabase()
+const
+{
+    return mReloadingMusicDatabase.valid();
+}
+
+bool
+Core::
+PublishReloadedMusicDatabase(bool wait)
+{
+    if (!IsReloadingMusicDatabase())
+    {
+        return false;
+    }
+
+    if (!wait&&mReloadingMusicDatabase.wait_for(std::chrono::seconds{0})!=std::future_status::ready)
+    {
+        return false;
+    }
+
+    //'' get() invalidates future, also when rethrowing exception. Task no longer reads shared players after it.
+    mSharedPlayerIidxIds.clear();
+    auto reloaded = mReloadingMusicDatabase.get();
+
+    //'' rebuild only what changed after snapshot, no change if throws.
+    std::map<std::string, std::shared_ptr<PlayerScore>> playerScores;
+    std::set<std::string> changedIidxIds;
+    for (auto &[iidxId, playerScore] : mPlayerScores)
+    {
+        auto findSource = ies::Find(reloaded.SourcePlayerScores, iidxId);
+        if (findSource&&findSource.value()->second==playerScore)
+        {
+            playerScores.emplace(iidxId, std::move(reloaded.PlayerScores.at(iidxId)));
+            continue;
+        }
+
+        playerScores.emplace(iidxId, std::make_shared<PlayerScore>(reloaded.Database, *playerScore));
+        changedIidxIds.insert(iidxId);
+    }
+
+    PlayerCsvMap playerCsvs;
+    for (auto &[iidxId, playStyleCsvs] : mPlayerCsvs)
+    {
+        for (auto &[playStyle, csvs] : playStyleCsvs)
+        {
+            auto &sourceCsvs = reloaded.SourcePlayerCsvs[iidxId][playStyle];
+            auto &reloadedCsvs = reloaded.PlayerCsvs[iidxId][playStyle];
+            auto &publishedCsvs = playerCsvs[iidxId][playStyle];
+            for (auto &[dateTime, csv] : csvs)
+            {
+                auto findSource = ies::Find(sourceCsvs, dateTime);
+                if (findSource&&findSource.value()->second==csv)
+                {
+                    publishedCsvs.emplace(dateTime, std::move(reloadedCsvs.at(dateTime)));
+                    continue;
+                }
+
+                publishedCsvs.emplace(dateTime, std::make_shared<const Csv>(*csv, *mMusicDatabase, *reloaded.Database));
+            }
+        }
+    }
+
+    auto isAnalysisStale = false;
+
+    if (reloaded.ActiveVersionIndex!=mAnalyzer.GetActiveVersionIndex())
+    {
+        reloaded.DatabaseAnalyzer = std::make_unique<Analyzer>(reloaded.Database);
+        if (ies::Find(reloaded.Database->GetActiveVersions(), mAnalyzer.GetActiveVersionIndex()))
+        {
+            reloaded.DatabaseAnalyzer->SetActiveVersionIndex(mAnalyzer.GetActiveVersionIndex());
+        }
+        isAnalysisStale = true;
+    }
+
+    auto &analyzer = *reloaded.DatabaseAnalyzer;
+    std::map<std::string, ScoreAnalysis> playerAnalyses;
+    std::map<std::string, ActivityAnalysis> playerVersionActivityAnalyses;
+    for (auto &[iidxId, analysis] : mPlayerAnalyses)
+    {
+        (void)analysis;
+        auto findAnalysis = ies::Find(reloaded.PlayerAnalyses, iidxId);
+        if (!isAnalysisStale&&findAnalysis&&!changedIidxIds.contains(iidxId))
+        {
+            playerAnalyses.emplace(iidxId, std::move(findAnalysis.value()->second));
+            playerVersionActivityAnalyses.emplace(iidxId, std::move(reloaded.PlayerVersionActivityAnalyses.at(iidxId)));
+            continue;
+        }
+
+        auto &playerScore = *playerScores.at(iidxId);
+        playerAnalyses.emplace(iidxId, analyzer.Analyze(playerScore));
+        playerVersionActivityAnalyses.emplace(iidxId, analyzer.AnalyzeVersionActivity(playerScore));
+    }
+
+    std::map<std::string, ActivityAnalysis> playerActivityAnalyses;
+    for (auto &[iidxId, activityAnalysis] : mPlayerActivityAnalyses)
+    {
+        auto &dateTimeRange = activityAnalysis.DateTimeRange;
+        auto findAnalysis = ies::Find(reloaded.PlayerActivityAnalyses, iidxId);
+        if (!isAnalysisStale&&findAnalysis&&!changedIidxIds.contains(iidxId)
+            &&findAnalysis.value()->second.DateTimeRange==dateTimeRange)
+        {
+            playerActivityAnalyses.emplace(iidxId, std::move(findAnalysis.value()->second));
+            continue;
+        }
+
+        playerActivityAnalyses.emplace
+        (
+            iidxId,
+            analyzer.AnalyzeActivity(*playerScores.at(iidxId),
+                                     dateTimeRange.at(ies::RangeSide::Begin),
+                                     dateTimeRange.at(ies::RangeSide::End))
+        );
+    }
+
+    auto previousFilename = mMusicDatabase->GetFilename();
+    {
+        std::lock_guard lock{mMusicDatabaseMutex};
+        mMusicDatabase.swap(reloaded.Database);
+    }
+    mPlayerScores.swap(playerScores);
+    mPlayerCsvs.swap(playerCsvs);
+    mAnalyzer = std::move(analyzer);
+    mPlayerAnalyses.swap(playerAnalyses);
+    mPlayerVersionActivityAnalyses.swap(playerVersionActivityAnalyses);
+    mPlayerActivityAnalyses.swap(playerActivityAnalyses);
+
+    if (previousFilename!=mMusicDatabase->GetFilename())
+    {
+        ReleaseSharedMusicDatabase(previousFilename);
+    }
+
+    return true;
+}
+
 void
 Core::
 AddPlayer(const std::string &iidxId)
@@ -53,7 +701,9 @@ bool
 Core::
 LoadDirectory(std::string_view directory,
               bool verbose,
-              bool checkWithDatabase)
+              bool checkWithDatabase,
+              std::size_t loadThreadCount,
+              bool useCsvCache)
 {
     fmt::print("Core::LoadDirectory(): load from [{}]\n", directory);
     if (!fs::exists(directory)||!fs::is_directory(directory))
@@ -81,111 +731,373 @@ LoadDirectory(std::string_view directory,
         CreatePlayer(iidxId);
     }
 
-    auto &playerScore = mPlayerScores.at(iidxId);
-
+    //'' collect files in directory, then parse them in parallel, and merge in fixed order.
+    std::vector<fs::path> csvPaths;
+    std::vector<fs::path> exportedPaths;
     for (auto &entry : fs::directory_iterator{directory})
     {
-        ies::Time::ScopeTimePrinter<std::chrono::milliseconds> timePrinter{"LoadDirectory: file"};
-
-        if (entry.is_regular_file()&&entry.path().extension()==".csv")
+        if (entry.is_regular_file())
         {
-            if (verbose) { std::cout << "\n"; }
-            auto filename = entry.path().filename().string();
+            CollectPlayerFile(iidxId, entry.path(), verbose, csvPaths, exportedPaths);
+        }
+    }
 
-            auto [isValid, invalidReason] = IsValidCsvFilename(filename);
-            if (!isValid)
-            {
-                if (verbose) { std::cout << "Skip CSV ["+filename+"] with invalid filename: "+invalidReason+".\n"; }
-                continue;
-            }
+    MergePlayerFiles(iidxId, path, csvPaths, exportedPaths, verbose, checkWithDatabase, loadThreadCount, useCsvCache, true);
+
+    auto &playerScore = UnsharePlayerScore(iidxId);
+    {
+        ies::Time::ScopeTimePrinter<std::chrono::milliseconds> timePrinter{"Propagate"};
+        playerScore.Propagate();
+    }
 
-            if (!filename.starts_with(iidxId))
+    if (verbose)
+    {
+        auto &playerCsvs = mPlayerCsvs.at(iidxId);
+        std::cout << "Player IIDX ID ["+playerScore.GetIidxId()+"] CSV files:\n";
+        for (auto playStyle : PlayStyleSmartEnum::ToRange())
+        {
+            std::cout << "["+ToString(playStyle)+"]:\n";
+            for (auto &[dateTime, csvPtr] : playerCsvs.at(playStyle))
             {
-                if (verbose) { std::cout << "Skip CSV ["+filename+"] with unmatch IIDX ID.\n"; }
-                continue;
+                auto &csv = *csvPtr;
+                std::cout   << "DateTime ["+dateTime
+                            << "] Filename ["+csv.GetFilename()
+                            << "] Version ["+csv.GetVersion()
+                            << "] TotalPlayCount [" << csv.GetTotalPlayCount()
+                            << "]\n";
             }
+        }
+    }
 
-            if (verbose) { std::cout << "Load CSV [" << filename << "]\n"; }
-            std::unique_ptr<Csv> csvPtr;
-            try
+    Analyze(iidxId, playerScore);
+
+    return true;
+}
+
+std::size_t
+Core::
+MergePlayerFiles(const std::string &iidxId,
+                 const fs::path &directory,
+                 const std::vector<fs::path> &csvPaths,
+                 const std::vector<fs::path> &exportedPaths,
+                 bool verbose,
+                 bool checkWithDatabase,
+                 std::size_t loadThreadCount,
+                 bool useCsvCache,
+                 bool isFullScan)
+{
+    //'' checkWithDatabase reports while parsing, always parse.
+    std::unique_ptr<CsvCache> csvCache;
+    if (useCsvCache&&!checkWithDatabase)
+    {
+        csvCache = std::make_unique<CsvCache>((directory/CsvCacheFilename).string(), *mMusicDatabase);
+    }
+
+    //'' Index=[0, csvPaths.size()) for CSV, then exported files.
+    std::vector<std::unique_ptr<Csv>> csvPtrs(csvPaths.size());
+    std::vector<std::optional<ImportedScores>> importedScoresList(exportedPaths.size());
+    ParallelFor(csvPaths.size()+exportedPaths.size(), loadThreadCount, [&](std::size_t index)
+    {
+        ies::Time::ScopeTimePrinter<std::chrono::milliseconds> timePrinter{"LoadDirectory: file"};
+
+        if (index>=csvPaths.size())
+        {
+            auto exportedIndex = index-csvPaths.size();
+            importedScoresList[exportedIndex] = ParseExportedFile(iidxId, exportedPaths[exportedIndex].string(), verbose);
+            return;
+        }
+
+        auto &csvPath = csvPaths[index];
+        auto filename = csvPath.filename().string();
+        if (verbose) { std::cout << "Load CSV [" << filename << "]\n"; }
+        try
+        {
+            if (csvCache)
             {
-                csvPtr = std::make_unique<Csv>(entry.path().string(), mMusicDatabase, verbose, checkWithDatabase);
+                csvPtrs[index] = csvCache->Load(csvPath.string(), verbose);
             }
-            catch (const std::exception &e)
+            else
             {
-                std::cout << "Construct CSV ["+filename+"] failed, reason:\n    " << e.what() << "\n";
-                continue;
+                csvPtrs[index] = std::make_unique<Csv>(csvPath.string(), *mMusicDatabase, verbose, checkWithDatabase);
             }
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << "Construct CSV ["+filename+"] failed, reason:\n    " << e.what() << "\n";
+        }
+    });
 
-            if (!csvPtr)
-            {
-                throw std::runtime_error("Cannot construct CSV.");
-            }
+    if (csvCache)
+    {
+        try
+        {
+            csvCache->Save(isFullScan);
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << "Cannot write CSV cache: " << e.what() << "\n";
+        }
+    }
 
-            auto &csv = *csvPtr;
-            if (verbose)
+    //'' Vector of {{DateTime, Filename}, Index}.
+    std::vector<std::pair<std::pair<std::string, std::string>, std::size_t>> mergeOrder;
+    for (auto i : IndexRange{0, csvPaths.size()})
+    {
+        if (csvPtrs[i])
+        {
+            mergeOrder.push_back({{csvPtrs[i]->GetLastDateTime(), csvPaths[i].filename().string()}, i});
+        }
+    }
+    for (auto i : IndexRange{0, exportedPaths.size()})
+    {
+        if (importedScoresList[i])
+        {
+            //'' score2dx_export_DP_2021-09-12[_suffix].json
+            auto filename = exportedPaths[i].filename().string();
+            auto exportDate = filename.substr(std::string_view{"score2dx_export_DP_"}.size(), 10);
+            mergeOrder.push_back({{exportDate, filename}, csvPaths.size()+i});
+        }
+    }
+    std::sort(mergeOrder.begin(), mergeOrder.end());
+
+    for (auto &[orderKey, index] : mergeOrder)
+    {
+        (void)orderKey;
+        if (index>=csvPaths.size())
+        {
+            MergeImportedScores(importedScoresList[index-csvPaths.size()].value());
+            continue;
+        }
+
+        auto &csvPtr = csvPtrs[index];
+        auto &csv = *csvPtr;
+        if (verbose)
+        {
+            std::cout << "\n";
+            csv.PrintSummary();
+        }
+
+        auto dateTime = csv.GetLastDateTime();
+        auto playStyle = csv.GetPlayStyle();
+        auto &allTimeCsvs = mPlayerCsvs.at(iidxId).at(playStyle);
+        allTimeCsvs[dateTime] = std::move(csvPtr);
+
+        AddCsvToPlayerScore(iidxId, playStyle, dateTime);
+    }
+
+    return mergeOrder.size();
+}
+
+bool
+Core::
+WatchDirectory(std::string_view directory,
+               bool verbose)
+{
+    if (!fs::exists(directory)||!fs::is_directory(directory))
+    {
+        if (verbose) { std::cout << "directory is not a valid directory.\n"; }
+        return false;
+    }
+
+    auto path = fs::canonical(directory).lexically_normal();
+    auto iidxId = path.filename().string().substr(0, 9);
+    if (!IsIidxId(iidxId))
+    {
+        if (verbose) { std::cout << "directory is not a valid IIDX ID.\n"; }
+        return false;
+    }
+
+    if (!mDirectoryWatcher)
+    {
+        mDirectoryWatcher = std::make_unique<DirectoryWatcher>();
+    }
+    mDirectoryWatcher->AddDirectory(path.string());
+
+    if (!ies::Find(mPlayerScores, iidxId))
+    {
+        CreatePlayer(iidxId);
+    }
+
+    return true;
+}
+
+void
+Core::
+UnwatchDirectory(std::string_view directory)
+{
+    if (mDirectoryWatcher)
+    {
+        mDirectoryWatcher->RemoveDirectory(std::string{directory});
+    }
+}
+
+std::size_t
+Core::
+IngestWatchedChanges(std::chrono::milliseconds timeout,
+                     bool verbose)
+{
+    if (!mDirectoryWatcher)
+    {
+        return 0;
+    }
+
+    //'' Map of {Directory, ChangedPaths}.
+    std::map<fs::path, std::vector<fs::path>> directoryChanges;
+    for (auto &changedPath : mDirectoryWatcher->PollChanges(timeout))
+    {
+        fs::path filePath{changedPath};
+        directoryChanges[filePath.parent_path()].emplace_back(filePath);
+    }
+
+    std::size_t ingestedFileCount = 0;
+    for (auto &[directory, changedPaths] : directoryChanges)
+    {
+        auto iidxId = directory.filename().string().substr(0, 9);
+        std::vector<fs::path> csvPaths;
+        std::vector<fs::path> exportedPaths;
+        for (auto &changedPath : changedPaths)
+        {
+            //'' file may be removed or renamed again before ingesting.
+            if (fs::is_regular_file(changedPath))
             {
-                csv.PrintSummary();
+                CollectPlayerFile(iidxId, changedPath, verbose, csvPaths, exportedPaths);
             }
+        }
+        if (csvPaths.empty()&&exportedPaths.empty())
+        {
+            continue;
+        }
+
+        fmt::print("Core::IngestWatchedChanges(): ingest {} file(s) from [{}]\n", csvPaths.size()+exportedPaths.size(), directory.string());
+        if (!ies::Find(mPlayerScores, iidxId))
+        {
+            CreatePlayer(iidxId);
+        }
+
+        //'' cache is opt-in, only keep using it if directory was loaded with cache.
+        auto useCsvCache = fs::exists(directory/CsvCacheFilename);
+        auto mergedFileCount = MergePlayerFiles(iidxId, directory, csvPaths, exportedPaths, verbose, false, 1, useCsvCache, false);
+        if (mergedFileCount==0)
+        {
+            continue;
+        }
+
+        auto &playerScore = UnsharePlayerScore(iidxId);
+        playerScore.Propagate();
+        Analyze(iidxId, playerScore);
+        ingestedFileCount += mergedFileCount;
+    }
+
+    return ingestedFileCount;
+}
+
+void
+Core::
+Export(const std::string &iidxId,
+       PlayStyle playStyle,
+       const std::string &outputDirectory,
+       const std::string &dateTimeType,
+       const std::string &suffix)
+const
+{
+    try
+    {
+        if (!fs::exists(outputDirectory)||!fs::is_directory(outputDirectory))
+        {
+            throw std::runtime_error("outputDirectory ["+outputDirectory+"] is not a directory.");
+        }
+
+        auto findPlayerScore = ies::Find(mPlayerScores, iidxId);
+        if (!findPlayerScore)
+        {
+            return;
+        }
 
-            auto dateTime = csv.GetLastDateTime();
-            auto playStyle = csv.GetPlayStyle();
-            auto &allTimeCsvs = mPlayerCsvs.at(iidxId).at(playStyle);
-            allTimeCsvs[dateTime] = std::move(csvPtr);
+        auto &playerScore = *findPlayerScore.value()->second;
+        Export(playerScore, playStyle, outputDirectory, dateTimeType, suffix);
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error("Core::Export(PlayStyle): exception:\n    "+std::string{e.what()});
+    }
+}
 
-            AddCsvToPlayerScore(iidxId, playStyle, dateTime);
+void
+Core::
+ExportPlayers(const std::string &outputDirectory,
+              const std::vector<std::string> &iidxIds,
+              const std::string &dateTimeType,
+              const std::string &suffix,
+              std::size_t threadCount)
+const
+{
+    try
+    {
+        if (!fs::exists(outputDirectory)||!fs::is_directory(outputDirectory))
+        {
+            throw std::runtime_error("outputDirectory ["+outputDirectory+"] is not a directory.");
         }
 
-        if (entry.is_regular_file()&&entry.path().extension()==".json")
+        std::vector<const PlayerScore*> playerScores;
+        if (iidxIds.empty())
         {
-            auto filename = entry.path().filename().string();
-            if (filename.starts_with("score2dx_export_"))
+            for (auto &[iidxId, playerScore] : mPlayerScores)
             {
-                Import(iidxId, entry.path().string(), verbose);
+                (void)iidxId;
+                playerScores.push_back(playerScore.get());
             }
         }
-    }
-
-    {
-        ies::Time::ScopeTimePrinter<std::chrono::milliseconds> timePrinter{"Propagate"};
-        playerScore.Propagate();
-    }
-
-    if (verbose)
-    {
-        auto &playerCsvs = mPlayerCsvs.at(iidxId);
-        std::cout << "Player IIDX ID ["+playerScore.GetIidxId()+"] CSV files:\n";
-        for (auto playStyle : PlayStyleSmartEnum::ToRange())
+        //'' duplicated IIDX ID is exported once, otherwise workers write same files concurrently.
+        std::set<std::string_view> addedIidxIds;
+        for (auto &iidxId : iidxIds)
         {
-            std::cout << "["+ToString(playStyle)+"]:\n";
-            for (auto &[dateTime, csvPtr] : playerCsvs.at(playStyle))
+            if (addedIidxIds.insert(iidxId).second)
             {
-                auto &csv = *csvPtr;
-                std::cout   << "DateTime ["+dateTime
-                            << "] Filename ["+csv.GetFilename()
-                            << "] Version ["+csv.GetVersion()
-                            << "] TotalPlayCount [" << csv.GetTotalPlayCount()
-                            << "]\n";
+                playerScores.push_back(&GetPlayerScore(iidxId));
             }
         }
-    }
 
-    Analyze(iidxId, playerScore);
+        //'' resolve shared data once, workers only read players and write their own files.
+        auto musicOrder = BuildExportMusicOrder(*mMusicDatabase, playerScores);
+        auto date = GetCurrentDate();
+        auto directoryPath = fs::canonical(outputDirectory);
+        std::vector<fs::path> playerDirectoryPaths;
+        for (auto* playerScore : playerScores)
+        {
+            auto &playerDirectoryPath = playerDirectoryPaths.emplace_back(directoryPath / playerScore->GetIidxId());
+            fs::create_directories(playerDirectoryPath);
+        }
 
-    return true;
+        const std::vector<PlayStyle> playStyles{PlayStyle::SinglePlay, PlayStyle::DoublePlay};
+        ParallelFor(playerScores.size(), threadCount, [&](std::size_t index)
+        {
+            WriteExportedJsons(*playerScores[index], musicOrder, playStyles, playerDirectoryPaths[index],
+                               date, dateTimeType, suffix, "");
+        });
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error("Core::ExportPlayers(): exception:\n    "+std::string{e.what()});
+    }
 }
 
 void
 Core::
-Export(const std::string &iidxId,
-       PlayStyle playStyle,
-       const std::string &outputDirectory,
-       const std::string &dateTimeType,
-       const std::string &suffix)
+ExportDelta(const std::string &iidxId,
+            PlayStyle playStyle,
+            const std::string &outputDirectory,
+            const std::string &sinceDateTime,
+            const std::string &dateTimeType,
+            const std::string &suffix)
 const
 {
     try
     {
+        if (!IsDateTimeFormat(sinceDateTime))
+        {
+            throw std::runtime_error("sinceDateTime ["+sinceDateTime+"] is not in format of \"YYYY-MM-DD HH:MM\".");
+        }
+
         if (!fs::exists(outputDirectory)||!fs::is_directory(outputDirectory))
         {
             throw std::runtime_error("outputDirectory ["+outputDirectory+"] is not a directory.");
@@ -197,12 +1109,28 @@ const
             return;
         }
 
-        auto &playerScore = findPlayerScore.value()->second;
-        Export(playerScore, playStyle, outputDirectory, dateTimeType, suffix);
+        auto &playerScore = *findPlayerScore.value()->second;
+        Export(playerScore, playStyle, outputDirectory, dateTimeType, suffix, sinceDateTime);
     }
     catch (const std::exception &e)
     {
-        throw std::runtime_error("Core::Export(PlayStyle): exception:\n    "+std::string{e.what()});
+        throw std::runtime_error("Core::ExportDelta(): exception:\n    "+std::string{e.what()});
+    }
+}
+
+std::string
+Core::
+GetExportedLastDateTime(const std::string &exportedFilename)
+const
+{
+    try
+    {
+        MappedFile file{exportedFilename};
+        return ReadExportedScoreMetadata(file.GetView()).LastDateTime;
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error("Core::GetExportedLastDateTime(): exception:\n    "+std::string{e.what()});
     }
 }
 
@@ -212,121 +1140,179 @@ Export(const PlayerScore &playerScore,
        PlayStyle playStyle,
        const std::string &outputDirectory,
        const std::string &dateTimeType,
-       const std::string &suffix)
+       const std::string &suffix,
+       const std::string &sinceDateTime)
 const
 {
     try
     {
-        auto playStyleAcronym = static_cast<PlayStyleAcronym>(playStyle);
+        auto musicOrder = BuildExportMusicOrder(*mMusicDatabase, {&playerScore});
+        WriteExportedJsons(playerScore, musicOrder, {playStyle}, fs::canonical(outputDirectory),
+                           GetCurrentDate(), dateTimeType, suffix, sinceDateTime);
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error("Core::Export(): exception:\n    "+std::string{e.what()});
+    }
+}
+
+void
+Core::
+Import(const std::string &requiredIidxId,
+       const std::string &exportedFilename,
+       bool verbose)
+{
+    if (auto importedScores = ParseExportedFile(requiredIidxId, exportedFilename, verbose))
+    {
+        MergeImportedScores(*importedScores);
+    }
+}
+
+void
+Core::
+ImportChain(const std::string &requiredIidxId,
+            const std::vector<std::string> &exportedFilenames,
+            bool verbose,
+            std::size_t parseThreadCount)
+{
+    std::vector<std::optional<ImportedScores>> importedScoresList(exportedFilenames.size());
+    ParallelFor(exportedFilenames.size(), parseThreadCount, [&](std::size_t index)
+    {
+        importedScoresList[index] = ParseExportedFile(requiredIidxId, exportedFilenames[index], verbose);
+    });
 
-        auto GetCurrentDate = []() -> std::string
+    //'' Vector of {{PlayStyle, IsDelta, SinceDateTime, Index}, Index}, bases of a play style come first.
+    std::vector<std::pair<std::tuple<PlayStyle, bool, std::string_view, std::size_t>, std::size_t>> chainOrder;
+    for (auto i : IndexRange{0, importedScoresList.size()})
+    {
+        if (auto &importedScores = importedScoresList[i])
         {
-            auto t = std::time(nullptr);
-            auto date = fmt::format("{:%Y-%m-%d}", fmt::localtime(t));
-            return date;
-        };
+            auto &sinceDateTime = importedScores->SinceDateTime;
+            chainOrder.push_back({{importedScores->MetaPlayStyle, !sinceDateTime.empty(), sinceDateTime, i}, i});
+        }
+    }
+    std::sort(chainOrder.begin(), chainOrder.end());
 
-        auto directoryPath = fs::canonical(outputDirectory);
-        auto filename = "score2dx_export_"+ToString(playStyleAcronym)+"_"+GetCurrentDate();
-        if (!suffix.empty())
+    //'' check continuity before merging, so broken chain does not leave player partially updated.
+    std::map<PlayStyle, std::string_view> chainLastDateTimes;
+    for (auto &[orderKey, index] : chainOrder)
+    {
+        (void)orderKey;
+        auto &importedScores = importedScoresList[index].value();
+        auto [it, isFirst] = chainLastDateTimes.emplace(importedScores.MetaPlayStyle, importedScores.LastDateTime);
+        auto &chainLastDateTime = it->second;
+        if (isFirst)
         {
-            filename += "_"+suffix;
+            continue;
         }
-        filename += ".json";
 
-        auto path = (directoryPath / filename).lexically_normal();
+        if (!importedScores.SinceDateTime.empty()&&importedScores.SinceDateTime>chainLastDateTime)
+        {
+            throw std::runtime_error("Core::ImportChain(): delta ["+exportedFilenames[index]
+                                     +"] since ["+importedScores.SinceDateTime
+                                     +"] does not continue from last DateTime ["+std::string{chainLastDateTime}
+                                     +"] of preceding files.");
+        }
+        chainLastDateTime = std::max(chainLastDateTime, std::string_view{importedScores.LastDateTime});
+    }
+
+    for (auto &[orderKey, index] : chainOrder)
+    {
+        (void)orderKey;
+        if (verbose) { std::cout << "Import [" << exportedFilenames[index] << "]\n"; }
+        MergeImportedScores(importedScoresList[index].value());
+    }
+}
 
-        std::ofstream exportFile{path};
-        if (!exportFile)
+void
+Core::
+ExportArchive(const std::string &iidxId,
+              const std::string &outputDirectory,
+              const std::string &suffix)
+const
+{
+    try
+    {
+        if (!fs::exists(outputDirectory)||!fs::is_directory(outputDirectory))
         {
-            throw std::runtime_error("cannot open file ["+path.string()+"].");
+            throw std::runtime_error("outputDirectory ["+outputDirectory+"] is not a directory.");
         }
 
-        Json exportData;
-        auto &metadata = exportData["metadata"];
-        metadata["id"] = playerScore.GetIidxId();
-        metadata["playStyle"] = ToString(playStyle);
-        metadata["dateTimeType"] = dateTimeType;
-        metadata["scoreVersion"] = "";
-        //'' todo: decide score version if all score in a version.
+        auto findPlayerScore = ies::Find(mPlayerScores, iidxId);
+        if (!findPlayerScore)
+        {
+            return;
+        }
 
-        std::string lastDateTime;
+        auto filename = "score2dx_archive_"+GetCurrentDate();
+        if (!suffix.empty())
+        {
+            filename += "_"+suffix;
+        }
+        filename += PlayerScoreArchiveExtension;
 
-        auto &data = exportData["data"];
+        auto path = (fs::canonical(outputDirectory) / filename).lexically_normal();
+        WritePlayerScoreArchive(*findPlayerScore.value()->second, path.string());
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error("Core::ExportArchive(): exception:\n    "+std::string{e.what()});
+    }
+}
 
-        for (auto &[musicId, versionScoreTable] : playerScore.GetVersionScoreTables())
+void
+Core::
+ImportArchive(const std::string &requiredIidxId,
+              const std::string &archiveFilename,
+              bool verbose)
+{
+    ImportedScores importedScores;
+    try
+    {
+        PlayerScoreArchive archive{archiveFilename, *mMusicDatabase};
+        if (archive.GetIidxId()!=requiredIidxId)
         {
-            auto &title = mMusicDatabase.GetTitle(musicId);
-            auto versionIndex = ToIndexes(musicId).first;
-            auto versionName = VersionNames[versionIndex];
-            if (versionIndex==0||versionIndex==1)
+            if (verbose)
             {
-                versionName = Official1stSubVersionName;
+                std::cout << "warning: archive's IIDX ID [" << archive.GetIidxId()
+                          << "] is not required [" << requiredIidxId
+                          << "]. Skipped file [" << archiveFilename << "]\n";
             }
+            return;
+        }
 
-            auto &versionData = data[versionName];
-            auto &titleData = versionData[title];
+        importedScores.IidxId = archive.GetIidxId();
+        importedScores.MusicScores = archive.GetMusicScores();
 
-            for (auto scoreVersionIndex : GetSupportScoreVersionRange())
+        //'' check all musics before merge, merge does not throw halfway and leave player partially updated.
+        for (auto &[scoreVersionIndex, musicScore] : importedScores.MusicScores)
+        {
+            (void)scoreVersionIndex;
+            try
             {
-                for (auto &[dateTime, musicScore] : versionScoreTable.GetMusicScores(scoreVersionIndex, playStyle))
-                {
-                    if (dateTime>lastDateTime)
-                    {
-                        lastDateTime = dateTime;
-                    }
-
-                    auto &record = titleData[dateTime];
-                    record["play"] = musicScore.GetPlayCount();
-                    auto &scoreData = record["score"];
-
-                    for (auto &[difficulty, chartScorePtr] : musicScore.GetChartScores())
-                    {
-                        auto diffAcronym = static_cast<DifficultyAcronym>(difficulty);
-                        auto &chartScore = *chartScorePtr;
-
-                        //! @brief [score, pgreat, great, miss, clear, djLevel], same order as CSV.
-                        std::array<std::string, 6> difficultyData;
-
-                        difficultyData[0] = std::to_string(chartScore.ExScore);
-                        difficultyData[1] = std::to_string(chartScore.PGreatCount);
-                        difficultyData[2] = std::to_string(chartScore.GreatCount);
-                        difficultyData[3] = "---";
-                        if (chartScore.MissCount)
-                        {
-                            difficultyData[3] = std::to_string(chartScore.MissCount.value());
-                        }
-
-                        difficultyData[4] = ToString(chartScore.ClearType);
-                        difficultyData[5] = ToString(chartScore.DjLevel);
-                        if (chartScore.ExScore==0)
-                        {
-                            difficultyData[5] = "---";
-                        }
-
-                        scoreData[ToString(diffAcronym)] = difficultyData;
-                    }
-                }
+                mMusicDatabase->GetMusic(musicScore.GetMusicId());
+            }
+            catch (const std::exception &)
+            {
+                throw std::runtime_error("archive ["+archiveFilename+"] has score of unknown music ["
+                                         +ToMusicIdString(musicScore.GetMusicId())+"].");
             }
         }
-
-        metadata["lastDateTime"] = lastDateTime;
-
-        exportFile << exportData << std::endl;
-
-        //std::cout << "Filename: [" << path << "]\n";
     }
     catch (const std::exception &e)
     {
-        throw std::runtime_error("Core::Export(): exception:\n    "+std::string{e.what()});
+        throw std::runtime_error("Core::ImportArchive(): exception:\n    "+std::string{e.what()});
     }
+
+    MergeImportedScores(importedScores);
 }
 
-void
+std::optional<Core::ImportedScores>
 Core::
-Import(const std::string &requiredIidxId,
-       const std::string &exportedFilename,
-       bool verbose)
+ParseExportedFile(const std::string &requiredIidxId,
+                  const std::string &exportedFilename,
+                  bool verbose)
+const
 {
     try
     {
@@ -351,26 +1337,12 @@ Import(const std::string &requiredIidxId,
         auto filenamePlayStyleAcronym = ToPlayStyleAcronym(filename.substr(signature.size(), 2));
         auto filenamePlayStyle = static_cast<PlayStyle>(filenamePlayStyleAcronym);
 
-        std::ifstream file{path};
-        if (!file)
-        {
-            throw std::runtime_error("cannot open file ["+path.string()+"].");
-        }
-
-        Json exportedData;
+        //'' scores are built with play style of filename while parsing, because metadata is after data.
+        //'' data error is only raised after metadata shows the file is of required player.
+        MappedFile file{path.string()};
+        auto exportedContent = ReadExportedScoreJson(file.GetView(), filenamePlayStyle, *mMusicDatabase, verbose);
 
-        file >> exportedData;
-
-        const auto &constExportedData = exportedData;
-
-        auto &metadata = constExportedData["metadata"];
-        auto metaPlayStyle = ToPlayStyle(metadata["playStyle"]);
-        if (metaPlayStyle!=filenamePlayStyle)
-        {
-            std::cout << "warning: filename playstyle not agreed with metadata in exported json.\n";
-        }
-
-        const std::string iidxId = metadata["id"];
+        auto &iidxId = exportedContent.IidxId;
         if (iidxId!=requiredIidxId)
         {
             if (verbose)
@@ -379,172 +1351,34 @@ Import(const std::string &requiredIidxId,
                           << "] is not required [" << requiredIidxId
                           << "]. Skipped file [" << filename << "]\n";
             }
-            return;
+            return std::nullopt;
         }
 
-        if (!ies::Find(mPlayerScores, iidxId))
+        if (exportedContent.MetaPlayStyle!=filenamePlayStyle)
         {
-            CreatePlayer(iidxId);
+            std::cout << "warning: filename playstyle not agreed with metadata in exported json.\n";
+            exportedContent = ReadExportedScoreJson(file.GetView(), exportedContent.MetaPlayStyle, *mMusicDatabase, verbose);
         }
 
-        auto &playerScore = mPlayerScores.at(iidxId);
-
-        auto &data = constExportedData["data"];
-        if (data.empty())
+        if (!exportedContent.DataError.empty())
         {
-            throw std::runtime_error("data has empty entry.");
+            throw std::runtime_error(exportedContent.DataError);
         }
 
-        /*
-        auto checkDateTime = (metadata["dateTimeType"]=="scriptUpdateDate");
-        (void)checkDateTime;
-        */
-
-        for (auto &[versionName, versionData] : data.items())
+        //'' delta export has null data if nothing is newer.
+        if (exportedContent.IsDataEmpty&&exportedContent.SinceDateTime.empty())
         {
-            for (auto &[title, musicData] : versionData.items())
-            {
-                if (musicData.is_null())
-                {
-                    continue;
-                }
-
-                std::string dbTitle = title;
-                if (auto findMappedTitle = mMusicDatabase.FindDbTitle(title))
-                {
-                    dbTitle = findMappedTitle.value();
-                }
-
-                auto [versionIndex, musicIndex] = mMusicDatabase.FindIndexes(versionName, dbTitle);
-                auto musicId = ToMusicId(versionIndex, musicIndex);
-
-                for (auto& [dateTime, recordData] : musicData.items())
-                {
-                    auto playCount = static_cast<std::size_t>(recordData["play"]);
-
-                    //'' design changed, all existing Json are assumed dumped from IIDX ME.
-                    //'' until new Json format that dump ScoreSource also.
-                    MusicScore musicScore
-                    {
-                        musicId,
-                        metaPlayStyle,
-                        playCount,
-                        dateTime,
-                        ScoreSource::Me
-                    };
-
-                    auto findScoreVersionIndex = FindVersionIndexFromDateTime(dateTime);
-                    if (!findScoreVersionIndex)
-                    {
-                        std::cout << "Data contains date time not supported.\n"
-                                  << recordData << "\n";
-                        continue;
-                    }
-
-                    auto scoreVersionIndex = findScoreVersionIndex.value();
-                    auto* activeVersionPtr = mMusicDatabase.FindActiveVersion(scoreVersionIndex);
-                    if (!activeVersionPtr)
-                    {
-                        throw std::runtime_error("cannot find active versioin");
-                    }
-                    auto& activeVersion = *activeVersionPtr;
-                    auto& availableChartDifficulties = activeVersion.GetAvailableCharts(musicId, metaPlayStyle);
-                    for (auto difficulty : availableChartDifficulties)
-                    {
-                        musicScore.EnableChartScore(difficulty);
-                    }
-
-                    for (auto &[difficultyAcronym, scoreData] : recordData["score"].items())
-                    {
-                        auto difficulty = static_cast<Difficulty>(ToDifficultyAcronym(difficultyAcronym));
-                        auto &chartScore = musicScore.EnableChartScore(difficulty);
-
-                        //! @brief [score, pgreat, great, miss, clear, djLevel], same order as CSV.
-                        std::array<std::string, 6> difficultyData = scoreData;
-
-                        if (!difficultyData[0].empty()) { chartScore.ExScore = std::stoi(difficultyData[0]); }
-                        if (!difficultyData[1].empty()) { chartScore.PGreatCount = std::stoi(difficultyData[1]); }
-                        if (!difficultyData[2].empty()) { chartScore.GreatCount = std::stoi(difficultyData[2]); }
-                        if (difficultyData[3]!="---") { chartScore.MissCount = std::stoi(difficultyData[3]); }
-                        chartScore.ClearType = ToClearType(difficultyData[4]);
-                        if (difficultyData[5]!="---") { chartScore.DjLevel = ToDjLevel(difficultyData[5]); }
-
-                        auto styleDifficulty = ConvertToStyleDifficulty(metaPlayStyle, difficulty);
-
-                        if (chartScore.MissCount && chartScore.MissCount==0 && chartScore.ClearType!=ClearType::FULLCOMBO_CLEAR)
-                        {
-                            if (verbose)
-                            {
-                                std::cout << "[" << ToVersionString(versionIndex)
-                                          << "][" << dbTitle
-                                          << "][" << ToString(styleDifficulty)
-                                          << "][" << dateTime
-                                          << "] has ClearType [" << ToString(chartScore.ClearType)
-                                          << "] and MissCount has value " << chartScore.MissCount.value()
-                                          << "\n";
-                            }
-                            chartScore.MissCount = std::nullopt;
-                        }
-
-                        auto* findChartInfo = mMusicDatabase.FindChartInfo(
-                            musicId,
-                            styleDifficulty,
-                            scoreVersionIndex
-                        );
-
-                        if (!findChartInfo)
-                        {
-                            //'' exported data from script may contain difficulty not existing (yet).
-                            /*
-                            if (chartScore.ClearType==ClearType::NO_PLAY)
-                            {
-                                continue;
-                            }
-                            */
-                            std::cout << ToVersionString(versionIndex) << " Title [" << dbTitle << "]\n"
-                                      << "DateTime: " << dateTime << "\n"
-                                      << "ScoreVersion: " << ToVersionString(scoreVersionIndex) << "\n"
-                                      << "StyleDifficulty: " << ToString(styleDifficulty) << "\n";
-                            throw std::runtime_error("cannot find chart info");
-                        }
-
-                        auto &chartInfo = *findChartInfo;
-                        if (chartInfo.Note<=0)
-                        {
-                            std::cout << ToVersionString(versionIndex) << " Title [" << dbTitle << "]\n"
-                                      << "DateTime: " << dateTime << "\n"
-                                      << "ScoreVersion: " << ToVersionString(scoreVersionIndex) << "\n"
-                                      << "StyleDifficulty: " << ToString(styleDifficulty) << "\n";
-                            throw std::runtime_error("DB chart info note is non-positive.");
-                        }
+            throw std::runtime_error("data has empty entry.");
+        }
 
-                        auto actualDjLevel = FindDjLevel(chartInfo.Note, chartScore.ExScore);
-                        if (actualDjLevel!=chartScore.DjLevel)
-                        {
-                            if (verbose)
-                            {
-                                std::cout << "Warning: unmatched DJ level in import file:"
-                                          << "\n[" << ToVersionString(versionIndex)
-                                          << "][" << dbTitle
-                                          << "][" << ToString(styleDifficulty)
-                                          << "]\nLevel: " << chartInfo.Level
-                                          << ", Note: " << chartInfo.Note
-                                          << ", Score: " << chartScore.ExScore
-                                          << ", Actual DJ Level: " << ToString(actualDjLevel)
-                                          << ", Data DJ Level: " << ToString(chartScore.DjLevel)
-                                          << "\nDateTime: " << dateTime
-                                          << ", ScoreVersion: " << ToVersionString(scoreVersionIndex)
-                                          << "."
-                                          << std::endl;
-                            }
-                            chartScore.DjLevel = actualDjLevel;
-                        }
-                    }
+        ImportedScores importedScores;
+        importedScores.IidxId = iidxId;
+        importedScores.MetaPlayStyle = exportedContent.MetaPlayStyle;
+        importedScores.LastDateTime = std::move(exportedContent.LastDateTime);
+        importedScores.SinceDateTime = std::move(exportedContent.SinceDateTime);
+        importedScores.MusicScores = std::move(exportedContent.MusicScores);
 
-                    playerScore.AddMusicScore(scoreVersionIndex, musicScore);
-                }
-            }
-        }
+        return importedScores;
     }
     catch (const std::exception &e)
     {
@@ -552,6 +1386,22 @@ Import(const std::string &requiredIidxId,
     }
 }
 
+void
+Core::
+MergeImportedScores(const ImportedScores &importedScores)
+{
+    if (!ies::Find(mPlayerScores, importedScores.IidxId))
+    {
+        CreatePlayer(importedScores.IidxId);
+    }
+
+    auto &playerScore = UnsharePlayerScore(importedScores.IidxId);
+    for (auto &[scoreVersionIndex, musicScore] : importedScores.MusicScores)
+    {
+        playerScore.AddMusicScore(scoreVersionIndex, musicScore);
+    }
+}
+
 const PlayerScore &
 Core::
 GetPlayerScore(const std::string &iidxId)
@@ -562,15 +1412,20 @@ const
     {
         throw std::runtime_error("no player score for ["+iidxId+"].");
     }
-    return findPlayerScore.value()->second;
+    return *findPlayerScore.value()->second;
 }
 
-const std::map<std::string, PlayerScore> &
+std::map<std::string, const PlayerScore*>
 Core::
 GetPlayerScores()
 const
 {
-    return mPlayerScores;
+    std::map<std::string, const PlayerScore*> playerScores;
+    for (auto &[iidxId, playerScore] : mPlayerScores)
+    {
+        playerScores[iidxId] = playerScore.get();
+    }
+    return playerScores;
 }
 
 std::map<std::string, const Csv*>
@@ -612,7 +1467,7 @@ Analyze(const std::string &iidxId)
         throw std::runtime_error("no such player ["+iidxId+"].");
     }
 
-    auto &playerScore = findPlayerScore.value()->second;
+    auto &playerScore = *findPlayerScore.value()->second;
 
     Analyze(iidxId, playerScore);
 }
@@ -662,7 +1517,7 @@ AnalyzeActivity(const std::string &iidxId,
         throw std::runtime_error("no such player ["+iidxId+"].");
     }
 
-    auto &playerScore = findPlayerScore.value()->second;
+    auto &playerScore = *findPlayerScore.value()->second;
 
     mPlayerActivityAnalyses.erase(iidxId);
     mPlayerActivityAnalyses.emplace(iidxId, mAnalyzer.AnalyzeActivity(playerScore, beginDateTime, endDateTime));
@@ -822,13 +1677,13 @@ ExportIidxMeData(const std::string &user, std::size_t endVersionIndex)
                     }
 
                     auto dbTitle = title;
-                    auto findMappedTitle = mMusicDatabase.FindDbTitle(dbTitle);
+                    auto findMappedTitle = mMusicDatabase->FindDbTitle(dbTitle);
                     if (findMappedTitle)
                     {
                         dbTitle = findMappedTitle.value();
                     }
 
-                    auto findMusicId = mMusicDatabase.FindMusicId(versionIndex, dbTitle);
+                    auto findMusicId = mMusicDatabase->FindMusicId(versionIndex, dbTitle);
                     if (!findMusicId)
                     {
                         std::cout << "IIDXME [" << iidxmeMid << "][" << dbTitle << "] cannot find in music db.\n";
@@ -1087,11 +1942,11 @@ const
         const std::size_t versionIndex = metadata.at("version");
 
         std::string dbTitle = title;
-        auto findMappedTitle = mMusicDatabase.FindDbTitle(dbTitle);
+        auto findMappedTitle = mMusicDatabase->FindDbTitle(dbTitle);
         if (findMappedTitle)
         {
             /*
-            auto findSection = mMusicDatabase.FindDbTitleMappingSection(dbTitle);
+            auto findSection = mMusicDatabase->FindDbTitleMappingSection(dbTitle);
             if (!findSection) { throw std::runtime_error("cannot find mapping section."); }
             auto &section = findSection.value();
             */
@@ -1104,14 +1959,14 @@ const
             */
         }
 
-        auto findMusicId = mMusicDatabase.FindMusicId(versionIndex, dbTitle);
+        auto findMusicId = mMusicDatabase->FindMusicId(versionIndex, dbTitle);
         if (!findMusicId)
         {
             std::cout << "IIDXME [" << iidxMeMusicId << "][" << dbTitle << "] cannot find in music db.\n";
             continue;
         }
 
-        //auto musicInfo = mMusicDatabase.GetLatestMusicInfo(context.MusicId);
+        //auto musicInfo = mMusicDatabase->GetLatestMusicInfo(context.MusicId);
         /*
         if (findMappedTitle && !musicInfo.GetField(MusicInfoField::DisplayTitle).empty())
         {
@@ -1210,7 +2065,7 @@ const
 
                     //'' check with DB:
                     /*
-                    auto findChartInfo = mMusicDatabase.FindChartInfo(versionIndex, dbTitle, styleDifficulty, scoreVersionIndex);
+                    auto findChartInfo = mMusicDatabase->FindChartInfo(versionIndex, dbTitle, styleDifficulty, scoreVersionIndex);
                     if (!findChartInfo)
                     {
                         std::cout << "IIDXME [" << iidxMeMusicId << "][" << title
@@ -1361,12 +2216,7 @@ void
 Core::
 CreatePlayer(const std::string &iidxId)
 {
-    mPlayerScores.emplace
-    (
-        std::piecewise_construct,
-        std::forward_as_tuple(iidxId),
-        std::forward_as_tuple(mMusicDatabase, iidxId)
-    );
+    mPlayerScores.emplace(iidxId, std::make_shared<PlayerScore>(mMusicDatabase, iidxId));
 
     mPlayerCsvs[iidxId];
     for (auto playStyle : PlayStyleSmartEnum::ToRange())
@@ -1375,6 +2225,18 @@ CreatePlayer(const std::string &iidxId)
     }
 }
 
+PlayerScore &
+Core::
+UnsharePlayerScore(const std::string &iidxId)
+{
+    auto &playerScore = mPlayerScores.at(iidxId);
+    if (mSharedPlayerIidxIds.erase(iidxId))
+    {
+        playerScore = std::make_shared<PlayerScore>(*playerScore);
+    }
+    return *playerScore;
+}
+
 void
 Core::
 AddCsvToPlayerScore(const std::string &iidxId,
@@ -1396,7 +2258,7 @@ AddCsvToPlayerScore(const std::string &iidxId,
     }
 
     auto &csv = *(findCsv.value()->second);
-    auto &playerScore = mPlayerScores.at(iidxId);
+    auto &playerScore = UnsharePlayerScore(iidxId);
     for (auto &[musicId, musicScore] : csv.GetScores())
     {
         (void)musicId;
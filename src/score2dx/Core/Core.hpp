@@ -1,9 +1,19 @@
 #pragma once
 
+#include <chrono>
+#include <filesystem>
+#include <future>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "score2dx/Analysis/Analyzer.hpp"
+#include "score2dx/Core/DirectoryWatcher.hpp"
 #include "score2dx/Core/JsonDefinition.hpp"
 #include "score2dx/Core/MusicDatabase.hpp"
 #include "score2dx/Csv/Csv.hpp"
@@ -18,12 +28,53 @@ const std::size_t MinExportFilenameSize = ExampleExportFilename.size();
 class Core
 {
 public:
+    //! @brief Use process-wide shared MusicDatabase, see GetSharedMusicDatabase.
         Core();
 
+    //! @brief Use given MusicDatabase, can be shared by multiple Core.
+        explicit Core(std::shared_ptr<const MusicDatabase> musicDatabase);
+
+    //! @brief Get current MusicDatabase for owner thread (the thread calling PublishReloadedMusicDatabase).
+    //! @note Not thread safe. Reference is only valid until next PublishReloadedMusicDatabase, hold
+    //! GetMusicDatabasePtr instead to keep using database across publish or from other threads.
         const MusicDatabase &
         GetMusicDatabase()
         const;
 
+    //! @brief Get shared handle of MusicDatabase, e.g. to create another Core.
+    //! Handle keeps its database alive across PublishReloadedMusicDatabase.
+    //! @note Thread safe.
+        std::shared_ptr<const MusicDatabase>
+        GetMusicDatabasePtr()
+        const;
+
+    //! @brief Start reloading MusicDatabase of filename in background, current database keeps serving.
+    //! Same filename as current database is loaded again from file (see ReloadSharedMusicDatabase),
+    //! other filename is got from shared cache.
+    //! Background task also rebuilds PlayerScores and Csvs from shared snapshot of current players (player changed
+    //! while reloading is copied before change, see UnsharePlayerScore), Analyzer and analyses
+    //! of analyzed players with reloaded database, call PublishReloadedMusicDatabase to switch to them.
+    //! @note Does nothing if a previous reload is not published yet.
+        void
+        BeginReloadMusicDatabase(const std::string &filename);
+
+        bool
+        IsReloadingMusicDatabase()
+        const;
+
+    //! @brief Publish background reloaded MusicDatabase, atomically swap database handle, PlayerScores,
+    //! Analyzer and analyses built by background task.
+    //! Scores keep attached to same music by version and title, MusicIds may differ in reloaded database,
+    //! scores of music not found in reloaded database are dropped.
+    //! Only what changed after BeginReloadMusicDatabase is rebuilt here: PlayerScores, Csvs and analyses of players
+    //! created or changed later, analyses of players analyzed later, or all analyses if active version changed.
+    //! Previous database is released from shared cache, it stays shared while other handles exist.
+    //! @param wait: wait if background task is not finished.
+    //! @return If published. False if no reload in progress or not finished yet (when not wait).
+    //! Rethrows background task exception, current database is kept.
+        bool
+        PublishReloadedMusicDatabase(bool wait=false);
+
     //! @brief Create Player's PlayerScore, do nothing if IIDX ID is invalid or player already exist.
         void
         AddPlayer(const std::string &iidxId);
@@ -32,14 +83,45 @@ public:
     //! Directory name need in form of IIDX ID format.
     //! Search and load all CSV begin with that ID. Also load all exported files with same ID inside.
     //! Do nothing if directory is not IIDX ID or failed.
+    //! Files are parsed on loadThreadCount workers (0 = hardware concurrency), then merged into PlayerScore
+    //! in order of {file DateTime, filename}, so result is same for any loadThreadCount.
+    //! File DateTime is last DateTime of CSV, or export date in filename of exported file.
+    //! If useCsvCache (opt-in), parsed CSVs are cached in CsvCacheFilename inside directory, unchanged CSVs are
+    //! restored from cache without parsing, see CsvCache. Cache is not used if checkWithDatabase.
     //! @return If load directory succeeded.
         bool
         LoadDirectory(std::string_view directory,
                       bool verbose=false,
-                      bool checkWithDatabase=false);
+                      bool checkWithDatabase=false,
+                      std::size_t loadThreadCount=1,
+                      bool useCsvCache=false);
+
+    //! @brief Watch player directory, new or modified CSV and exported files inside are ingested by
+    //! IngestWatchedChanges. Directory requirement is same as LoadDirectory, usually already loaded by it.
+    //! Files existing now are not ingested. Creates player if not exist.
+    //! Linux gets changes from inotify, other platforms poll directory, see DirectoryWatcher.
+    //! @return If directory is watched.
+        bool
+        WatchDirectory(std::string_view directory,
+                       bool verbose=false);
+
+    //! @brief Stop watching directory, does nothing if directory is not watched.
+        void
+        UnwatchDirectory(std::string_view directory);
+
+    //! @brief Wait at most timeout for changes of watched directories, then ingest only changed files into
+    //! player's CSVs and PlayerScore same as LoadDirectory (CSV cache of directory is used if it exists), and
+    //! re-analyze players with ingested files.
+    //! @note Scores merged from previous content of a modified file are kept, PlayerScore keeps score history.
+    //! Exported files written into watched directory are also ingested.
+    //! @return Number of ingested files.
+        std::size_t
+        IngestWatchedChanges(std::chrono::milliseconds timeout=std::chrono::milliseconds{0},
+                             bool verbose=false);
 
     //! @brief Export loaded PlayerScore to score2dx Json format data.
     //! Filename: score2dx_export_<PlayStyleAcronym>_<CurrentDate>[_<suffix>].json
+    //! Json is streamed to file while walking PlayerScore without building Json DOM, see JsonStreamWriter.
     //! @example Load csv and export filename will be:
     //!     score2dx_export_DP_2021-09-12.json
     //! @note Will not generate file if have no data of IIDX ID or PlayStyle.
@@ -51,19 +133,82 @@ public:
                const std::string &suffix="")
         const;
 
-    //! @brief Import score2dx Json format data.
+    //! @brief Export loaded PlayerScores of iidxIds (all players if empty) of both play styles, same files as
+    //! Export are written into <outputDirectory>/<IidxId>/ (created if not exist, loadable by LoadDirectory).
+    //! Version names and titles are resolved once for all players, each player's VersionScoreTables are walked
+    //! once for both play styles, and players are exported on threadCount workers (0 = hardware concurrency).
+    //! @note Throws if any of iidxIds has no PlayerScore. Duplicated IIDX ID is exported once.
+        void
+        ExportPlayers(const std::string &outputDirectory,
+                      const std::vector<std::string> &iidxIds={},
+                      const std::string &dateTimeType="official",
+                      const std::string &suffix="",
+                      std::size_t threadCount=0)
+        const;
+
+    //! @brief Export only MusicScores with DateTime after sinceDateTime ("YYYY-MM-DD HH:MM"), same format
+    //! as Export except titles without newer score are omitted.
+    //! metadata/sinceDateTime records sinceDateTime, metadata/lastDateTime is last DateTime of exported scores
+    //! (sinceDateTime if nothing is newer), so it is sinceDateTime of next delta, see GetExportedLastDateTime.
+    //! Filename: score2dx_export_<PlayStyleAcronym>_<CurrentDate>_<suffix>.json
+    //! @note Generates file with null data if nothing is newer, so chain of delta files stays continuous.
+        void
+        ExportDelta(const std::string &iidxId,
+                    PlayStyle playStyle,
+                    const std::string &outputDirectory,
+                    const std::string &sinceDateTime,
+                    const std::string &dateTimeType="official",
+                    const std::string &suffix="delta")
+        const;
+
+    //! @brief Get metadata/lastDateTime of exported file, e.g. sinceDateTime of next ExportDelta.
+    //! @note Only metadata is read, no MusicScore is built.
+        std::string
+        GetExportedLastDateTime(const std::string &exportedFilename)
+        const;
+
+    //! @brief Import score2dx Json format data, either full export or delta export.
     //! @note Does not update player score analysis.
         void
         Import(const std::string &requiredIidxId,
                const std::string &exportedFilename,
                bool verbose=false);
 
+    //! @brief Import chain of base (full export) and delta files, files are parsed on parseThreadCount
+    //! workers (0 = hardware concurrency), then merged per play style in order of base files first and
+    //! deltas by sinceDateTime. Files of other IIDX ID are skipped.
+    //! @note Throws before merging anything if any file is invalid, or a delta's sinceDateTime is after
+    //! lastDateTime of preceding files of same play style (scores in between are missing).
+    //! Does not update player score analysis.
+        void
+        ImportChain(const std::string &requiredIidxId,
+                    const std::vector<std::string> &exportedFilenames,
+                    bool verbose=false,
+                    std::size_t parseThreadCount=0);
+
+    //! @brief Export loaded PlayerScore of both play styles to score2dx binary archive, see PlayerScoreArchive.
+    //! Filename: score2dx_archive_<CurrentDate>[_<suffix>].s2pa
+    //! @note Will not generate file if have no data of IIDX ID.
+        void
+        ExportArchive(const std::string &iidxId,
+                      const std::string &outputDirectory,
+                      const std::string &suffix="")
+        const;
+
+    //! @brief Import score2dx binary archive, scores are merged same as Import.
+    //! Throws without changing player if archive is written with other database or has score of unknown music.
+    //! @note Does not update player score analysis.
+        void
+        ImportArchive(const std::string &requiredIidxId,
+                      const std::string &archiveFilename,
+                      bool verbose=false);
+
         const PlayerScore &
         GetPlayerScore(const std::string &iidxId)
         const;
 
     //! @brief Map of {IidxId, PlayerScore}.
-        const std::map<std::string, PlayerScore> &
+        std::map<std::string, const PlayerScore*>
         GetPlayerScores()
         const;
 
@@ -123,13 +268,46 @@ public:
         const;
 
 private:
-    MusicDatabase mMusicDatabase;
-
-    //! @brief Map of {IidxId, PlayerScore}.
-    std::map<std::string, PlayerScore> mPlayerScores;
+    //! @brief Parsed scores of an exported file, see Import.
+    struct ImportedScores
+    {
+        std::string IidxId;
+        PlayStyle MetaPlayStyle{PlayStyle::SinglePlay};
+        //! @brief metadata/lastDateTime and metadata/sinceDateTime (empty if not delta export).
+        std::string LastDateTime;
+        std::string SinceDateTime;
+        //! @brief Vector of {ScoreVersionIndex, MusicScore} in file order.
+        std::vector<std::pair<std::size_t, MusicScore>> MusicScores;
+    };
 
     //! @brief Map of {IidxId, Map of {PlayStyle, Map of {DateTime, Csv}}}.
-    std::map<std::string, std::map<PlayStyle, std::map<std::string, std::unique_ptr<Csv>>>> mPlayerCsvs;
+    using PlayerCsvMap = std::map<std::string, std::map<PlayStyle, std::map<std::string, std::shared_ptr<const Csv>>>>;
+
+    //! @brief Database and structures depend on it built by background task of BeginReloadMusicDatabase.
+    struct ReloadedMusicDatabase
+    {
+        std::shared_ptr<const MusicDatabase> Database;
+        //! @brief Active version index of snapshot.
+        std::size_t ActiveVersionIndex{0};
+        //! @brief Snapshot of mPlayerScores, player is changed after snapshot if its PlayerScore is other object.
+        std::map<std::string, std::shared_ptr<const PlayerScore>> SourcePlayerScores;
+        std::map<std::string, std::shared_ptr<PlayerScore>> PlayerScores;
+        //! @brief Snapshot of mPlayerCsvs, Csv is added after snapshot if it is not same object.
+        PlayerCsvMap SourcePlayerCsvs;
+        PlayerCsvMap PlayerCsvs;
+        std::unique_ptr<Analyzer> DatabaseAnalyzer;
+        std::map<std::string, ScoreAnalysis> PlayerAnalyses;
+        std::map<std::string, ActivityAnalysis> PlayerVersionActivityAnalyses;
+        std::map<std::string, ActivityAnalysis> PlayerActivityAnalyses;
+    };
+
+    std::shared_ptr<const MusicDatabase> mMusicDatabase;
+
+    //! @brief Map of {IidxId, PlayerScore}, PlayerScore may be shared with reloading task, see UnsharePlayerScore.
+    std::map<std::string, std::shared_ptr<PlayerScore>> mPlayerScores;
+
+    //! @brief Csvs are not changed after added, shared with reloading task as PlayerScore.
+    PlayerCsvMap mPlayerCsvs;
 
     Analyzer mAnalyzer;
     //! @brief Map of {IidxId, ScoreAnalysis}.
@@ -142,9 +320,50 @@ private:
     //! @brief Map of {IidxMeUser, Iidxid}.
     std::map<std::string, std::string> mIidxMeUserIdMap;
 
+    //! @brief Guard mMusicDatabase for readers of other threads (GetMusicDatabasePtr), owner thread is the only writer.
+    mutable std::mutex mMusicDatabaseMutex;
+    //! @brief Background task of BeginReloadMusicDatabase, invalid if not reloading.
+    std::future<ReloadedMusicDatabase> mReloadingMusicDatabase;
+    //! @brief IIDX IDs of players whose PlayerScore is shared with reloading task.
+    std::set<std::string> mSharedPlayerIidxIds;
+
+    //! @brief Watcher of WatchDirectory, created on first watch.
+    std::unique_ptr<DirectoryWatcher> mDirectoryWatcher;
+
         void
         CreatePlayer(const std::string &iidxId);
 
+    //! @brief Get PlayerScore of existing player to change, it is copied first if shared with reloading task.
+        PlayerScore &
+        UnsharePlayerScore(const std::string &iidxId);
+
+    //! @brief Parse exported file without touching player data, safe to call concurrently.
+    //! @return nullopt if exported data's IIDX ID is not requiredIidxId.
+        std::optional<ImportedScores>
+        ParseExportedFile(const std::string &requiredIidxId,
+                          const std::string &exportedFilename,
+                          bool verbose)
+        const;
+
+        void
+        MergeImportedScores(const ImportedScores &importedScores);
+
+    //! @brief Parse CSV and exported files of player on loadThreadCount workers, then merge into player's CSVs
+    //! and PlayerScore in order of {file DateTime, filename}. Does not propagate or analyze, see LoadDirectory.
+    //! isFullScan: csvPaths are all CSVs of directory, cache entries of other CSVs are dropped,
+    //! otherwise (e.g. changed files only) they are kept, see CsvCache::Save.
+    //! @return Number of merged files, failed files are skipped.
+        std::size_t
+        MergePlayerFiles(const std::string &iidxId,
+                         const std::filesystem::path &directory,
+                         const std::vector<std::filesystem::path> &csvPaths,
+                         const std::vector<std::filesystem::path> &exportedPaths,
+                         bool verbose,
+                         bool checkWithDatabase,
+                         std::size_t loadThreadCount,
+                         bool useCsvCache,
+                         bool isFullScan);
+
         void
         AddCsvToPlayerScore(const std::string &iidxId,
                             PlayStyle playStyle,
@@ -154,12 +373,14 @@ private:
         Analyze(const std::string &iidxId,
                 const PlayerScore &playerScore);
 
+    //! @brief Export scores of playStyle with DateTime after sinceDateTime, all scores if sinceDateTime is empty.
         void
         Export(const PlayerScore &playerScore,
                PlayStyle playStyle,
                const std::string &outputDirectory,
                const std::string &dateTimeType="official",
-               const std::string &suffix="")
+               const std::string &suffix="",
+               const std::string &sinceDateTime="")
         const;
 };
 
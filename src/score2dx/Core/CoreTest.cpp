@@ -0,0 +1,379 @@
+#include "score2dx/Core/Core.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ies/Common/IntegralRangeUsing.hpp"
+
+#include "score2dx/Core/TestUtil.hpp"
+#include "score2dx/Csv/CsvCache.hpp"
+#include "score2dx/Iidx/Version.hpp"
+
+namespace fs = std::filesystem;
+
+namespace score2dx
+{
+
+namespace
+{
+
+//! @brief Map of {Title, Sorted texts of player's scores and CSV scores of music}, to compare scores across
+//! databases where MusicId of same music differs.
+std::map<std::string, std::vector<std::string>>
+ToTitleScoreStrings(const Core &core, const std::string &iidxId)
+{
+    auto musicDatabase = core.GetMusicDatabasePtr();
+    std::map<std::string, std::vector<std::string>> scoreStrings;
+    auto addScoreString = [&](std::size_t musicId, const MusicScore &musicScore, const std::string &text)
+    {
+        EXPECT_EQ(musicId, musicScore.GetMusicId());
+        scoreStrings[musicDatabase->GetTitle(musicId)].emplace_back(text+" "+ToTestString(musicScore));
+    };
+
+    for (auto &[musicId, versionScoreTable] : core.GetPlayerScore(iidxId).GetVersionScoreTables())
+    {
+        for (auto playStyle : PlayStyleSmartEnum::ToRange())
+        {
+            for (auto scoreVersionIndex : IndexRange{0, VersionNames.size()})
+            {
+                for (auto &[dateTime, musicScore] : versionScoreTable.GetMusicScores(scoreVersionIndex, playStyle))
+                {
+                    (void)dateTime;
+                    addScoreString(musicId, musicScore, ToString(playStyle)+" "+std::to_string(scoreVersionIndex));
+                }
+            }
+        }
+    }
+    for (auto playStyle : PlayStyleSmartEnum::ToRange())
+    {
+        for (auto &[dateTime, csv] : core.GetCsvs(iidxId, playStyle))
+        {
+            for (auto &[musicId, musicScore] : csv->GetScores())
+            {
+                addScoreString(musicId, musicScore, "CSV "+csv->GetFilename()+" "+dateTime);
+            }
+        }
+    }
+
+    for (auto &[title, strings] : scoreStrings)
+    {
+        (void)title;
+        std::sort(strings.begin(), strings.end());
+    }
+    return scoreStrings;
+}
+
+}
+
+TEST(Core, ExportDeltaChain)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase)
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    const std::string iidxId{"5483-7391"};
+    TestDirectory testDirectory{"score2dx_export_delta_test", {"input", "base", "delta1", "delta2", "expected", "actual"}};
+    auto &directory = testDirectory.GetPath();
+
+    //'' base has scores until first DateTime, later scores are added after base export.
+    Core core{musicDatabase};
+    core.Import(iidxId, WriteExportedJson(*musicDatabase, iidxId, PlayStyle::SinglePlay, {"2021-12-04 15:33"}, directory/"input"/"score2dx_export_SP_2021-12-04.json"));
+    core.Export(iidxId, PlayStyle::SinglePlay, (directory/"base").string());
+    auto basePath = FindSingleFile(directory/"base", ".json");
+    ASSERT_EQ("2021-12-04 15:33", core.GetExportedLastDateTime(basePath.string()));
+
+    core.Import(iidxId, WriteExportedJson(*musicDatabase, iidxId, PlayStyle::SinglePlay, {"2022-05-01 09:05", "2023-03-05 21:15"}, directory/"input"/"score2dx_export_SP_2023-03-05.json"));
+    EXPECT_THROW(core.ExportDelta(iidxId, PlayStyle::SinglePlay, (directory/"delta1").string(), "2021-12-04"), std::runtime_error);
+    core.ExportDelta(iidxId, PlayStyle::SinglePlay, (directory/"delta1").string(), core.GetExportedLastDateTime(basePath.string()));
+    auto delta1Path = FindSingleFile(directory/"delta1", ".json");
+    auto delta1Json = ReadFile(delta1Path);
+    EXPECT_EQ(std::string::npos, delta1Json.find("2021-12-04 15:33\":"));
+    EXPECT_NE(std::string::npos, delta1Json.find("2022-05-01 09:05"));
+    EXPECT_NE(std::string::npos, delta1Json.find("\"sinceDateTime\":\"2021-12-04 15:33\""));
+    ASSERT_EQ("2023-03-05 21:15", core.GetExportedLastDateTime(delta1Path.string()));
+
+    //'' nothing is newer, delta has null data and keeps lastDateTime.
+    core.ExportDelta(iidxId, PlayStyle::SinglePlay, (directory/"delta2").string(), core.GetExportedLastDateTime(delta1Path.string()));
+    auto delta2Path = FindSingleFile(directory/"delta2", ".json");
+    EXPECT_NE(std::string::npos, ReadFile(delta2Path).find("{\"data\":null,"));
+    ASSERT_EQ("2023-03-05 21:15", core.GetExportedLastDateTime(delta2Path.string()));
+
+    //'' chain is ordered by base first then sinceDateTime, not by argument order.
+    Core chainCore{musicDatabase};
+    chainCore.ImportChain(iidxId, {delta2Path.string(), delta1Path.string(), basePath.string()}, false, 2);
+    core.Export(iidxId, PlayStyle::SinglePlay, (directory/"expected").string());
+    chainCore.Export(iidxId, PlayStyle::SinglePlay, (directory/"actual").string());
+    EXPECT_EQ(ReadFile(FindSingleFile(directory/"expected", ".json")), ReadFile(FindSingleFile(directory/"actual", ".json")));
+
+    //'' delta2 starts after base's lastDateTime, scores of delta1 are missing.
+    Core brokenChainCore{musicDatabase};
+    EXPECT_THROW(brokenChainCore.ImportChain(iidxId, {basePath.string(), delta2Path.string()}), std::runtime_error);
+    EXPECT_TRUE(brokenChainCore.GetPlayerScores().empty());
+}
+
+TEST(Core, LoadDirectoryThreadCount)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase)
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    const std::string iidxId{"5483-7391"};
+    TestDirectory testDirectory{"score2dx_load_directory_test", {iidxId, "expected", "actual"}};
+    auto &directory = testDirectory.GetPath();
+    auto playerDirectory = directory/iidxId;
+
+    //'' CSVs of both play styles at different versions, with exported scores in between.
+    WriteCsv(*musicDatabase, PlayStyle::SinglePlay, 29, "2021-12-04", playerDirectory/(iidxId+"_sp_score_2021-12-04.csv"));
+    WriteCsv(*musicDatabase, PlayStyle::SinglePlay, 29, "2022-05-01", playerDirectory/(iidxId+"_sp_score_2022-05-01.csv"), 1);
+    WriteCsv(*musicDatabase, PlayStyle::SinglePlay, 30, "2023-03-05", playerDirectory/(iidxId+"_sp_score_2023-03-05.csv"), 2);
+    WriteCsv(*musicDatabase, PlayStyle::DoublePlay, 29, "2022-01-02", playerDirectory/(iidxId+"_dp_score_2022-01-02.csv"), 3);
+    WriteCsv(*musicDatabase, PlayStyle::DoublePlay, 30, "2023-01-02", playerDirectory/(iidxId+"_dp_score_2023-01-02.csv"), 4);
+    WriteExportedJson(*musicDatabase, iidxId, PlayStyle::SinglePlay, {"2022-03-01 12:00"}, playerDirectory/"score2dx_export_SP_2022-03-01.json");
+
+    //'' result is same as serial loading for any thread count.
+    Core serialCore{musicDatabase};
+    ASSERT_TRUE(serialCore.LoadDirectory(playerDirectory.string(), false, false, 1, false));
+    Core parallelCore{musicDatabase};
+    ASSERT_TRUE(parallelCore.LoadDirectory(playerDirectory.string(), false, false, 4, false));
+    for (auto playStyle : PlayStyleSmartEnum::ToRange())
+    {
+        serialCore.Export(iidxId, playStyle, (directory/"expected").string());
+        parallelCore.Export(iidxId, playStyle, (directory/"actual").string());
+    }
+
+    std::size_t fileCount = 0;
+    for (auto &entry : fs::directory_iterator{directory/"expected"})
+    {
+        EXPECT_EQ(ReadFile(entry.path()), ReadFile(directory/"actual"/entry.path().filename()));
+        ++fileCount;
+    }
+    EXPECT_EQ(2u, fileCount);
+}
+
+TEST(Core, IngestKeepsCsvCache)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase)
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    const std::string iidxId{"5483-7391"};
+    TestDirectory testDirectory{"score2dx_ingest_csv_cache_test", {iidxId}};
+    auto playerDirectory = testDirectory.GetPath()/iidxId;
+    auto spCsvPath = WriteCsv(*musicDatabase, PlayStyle::SinglePlay, 30, "2023-03-05", playerDirectory/(iidxId+"_sp_score.csv"));
+    auto dpCsvPath = WriteCsv(*musicDatabase, PlayStyle::DoublePlay, 30, "2023-03-05", playerDirectory/(iidxId+"_dp_score.csv"));
+
+    Core core{musicDatabase};
+    ASSERT_TRUE(core.LoadDirectory(playerDirectory.string(), false, false, 1, true));
+    ASSERT_TRUE(core.WatchDirectory(playerDirectory.string()));
+
+    //'' only changed SP CSV is ingested, cache still has entry of DP CSV.
+    WriteCsv(*musicDatabase, PlayStyle::SinglePlay, 30, "2023-03-06", spCsvPath, 1);
+    ASSERT_EQ(1u, core.IngestWatchedChanges(std::chrono::milliseconds{2000}));
+
+    CsvCache csvCache{(playerDirectory/CsvCacheFilename).string(), *musicDatabase};
+    for (auto &csvPath : {spCsvPath, dpCsvPath})
+    {
+        testing::internal::CaptureStdout();
+        csvCache.Load(csvPath, true);
+        EXPECT_NE(std::string::npos, testing::internal::GetCapturedStdout().find("from cache.")) << csvPath;
+    }
+}
+
+TEST(Core, ExportPlayers)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase)
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    const std::vector<std::string> iidxIds{"5483-7391", "1000-2000", "3000-4000"};
+    TestDirectory testDirectory{"score2dx_export_players_test", {"input", "expected", "actual"}};
+    auto &directory = testDirectory.GetPath();
+
+    Core core{musicDatabase};
+    for (auto i : IndexRange{0, iidxIds.size()})
+    {
+        std::vector<std::string> dateTimes{"2021-12-04 15:33"};
+        if (i>0) { dateTimes.emplace_back("2023-03-05 21:15"); }
+        auto inputPath = directory/"input"/("score2dx_export_SP_2023-03-05_"+std::to_string(i)+".json");
+        core.Import(iidxIds[i], WriteExportedJson(*musicDatabase, iidxIds[i], PlayStyle::SinglePlay, dateTimes, inputPath));
+    }
+
+    //'' only selected players (duplicated one is exported once), output is same as Export of each player and play style.
+    core.ExportPlayers((directory/"actual").string(), {iidxIds[0], iidxIds[2], iidxIds[0], iidxIds[0]}, "official", "", 4);
+    EXPECT_FALSE(fs::exists(directory/"actual"/iidxIds[1]));
+    for (auto &iidxId : {iidxIds[0], iidxIds[2]})
+    {
+        fs::create_directories(directory/"expected"/iidxId);
+        for (auto playStyle : PlayStyleSmartEnum::ToRange())
+        {
+            core.Export(iidxId, playStyle, (directory/"expected"/iidxId).string());
+        }
+        for (auto &entry : fs::directory_iterator{directory/"expected"/iidxId})
+        {
+            EXPECT_EQ(ReadFile(entry.path()), ReadFile(directory/"actual"/iidxId/entry.path().filename()));
+        }
+    }
+
+    EXPECT_THROW(core.ExportPlayers((directory/"actual").string(), {"0000-0000"}), std::runtime_error);
+}
+
+TEST(Core, ReloadMusicDatabase)
+{
+    if (!fs::exists(DefaultMusicDatabaseFilename))
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    const std::string iidxId{"5483-7391"};
+    TestDirectory testDirectory{"score2dx_reload_music_database_test", {"table", "input", "expected", "actual"}};
+    auto &directory = testDirectory.GetPath();
+    auto databaseFilename = (directory/"table"/fs::path{DefaultMusicDatabaseFilename}.filename()).string();
+    fs::copy_file(DefaultMusicDatabaseFilename, databaseFilename);
+
+    auto musicDatabase = GetSharedMusicDatabase(databaseFilename);
+    Core core{musicDatabase};
+    Core otherCore{GetSharedMusicDatabase(databaseFilename)};
+    ASSERT_EQ(musicDatabase, otherCore.GetMusicDatabasePtr());
+
+    auto firstFilename = WriteExportedJson(*musicDatabase, iidxId, PlayStyle::SinglePlay, {"2021-12-04 15:33"}, directory/"input"/"score2dx_export_SP_2021-12-04.json");
+    auto secondFilename = WriteExportedJson(*musicDatabase, iidxId, PlayStyle::SinglePlay, {"2022-05-01 09:05"}, directory/"input"/"score2dx_export_SP_2022-05-01.json");
+    core.Import(iidxId, firstFilename);
+    core.Analyze(iidxId);
+    core.AnalyzeActivity(iidxId, "2021-12-01 00:00", "2022-06-01 00:00");
+
+    //'' same filename is loaded again instead of cached database, analyses are rebuilt in background.
+    core.BeginReloadMusicDatabase(databaseFilename);
+    ASSERT_TRUE(core.IsReloadingMusicDatabase());
+    ASSERT_TRUE(core.PublishReloadedMusicDatabase(true));
+    EXPECT_FALSE(core.IsReloadingMusicDatabase());
+    auto reloadedDatabase = core.GetMusicDatabasePtr();
+    EXPECT_NE(musicDatabase, reloadedDatabase);
+    EXPECT_EQ(reloadedDatabase, GetSharedMusicDatabase(databaseFilename));
+    EXPECT_EQ(musicDatabase, otherCore.GetMusicDatabasePtr());
+    EXPECT_EQ(reloadedDatabase.get(), &core.GetMusicDatabase());
+    ASSERT_NE(nullptr, core.FindAnalysis(iidxId));
+    ASSERT_NE(nullptr, core.FindVersionActivityAnalysis(iidxId));
+    auto* activityAnalysis = core.FindActivityAnalysis(iidxId);
+    ASSERT_NE(nullptr, activityAnalysis);
+    EXPECT_EQ("2021-12-01 00:00", activityAnalysis->DateTimeRange.at(ies::RangeSide::Begin));
+
+    //'' scores imported while reloading are not lost, shared snapshot is copied before change.
+    auto* sharedPlayerScore = &core.GetPlayerScore(iidxId);
+    core.BeginReloadMusicDatabase(databaseFilename);
+    core.Import(iidxId, secondFilename);
+    EXPECT_NE(sharedPlayerScore, &core.GetPlayerScore(iidxId));
+    ASSERT_TRUE(core.PublishReloadedMusicDatabase(true));
+    ASSERT_NE(nullptr, core.FindAnalysis(iidxId));
+
+    Core expectedCore{reloadedDatabase};
+    expectedCore.Import(iidxId, firstFilename);
+    expectedCore.Import(iidxId, secondFilename);
+    expectedCore.Export(iidxId, PlayStyle::SinglePlay, (directory/"expected").string());
+    core.Export(iidxId, PlayStyle::SinglePlay, (directory/"actual").string());
+    EXPECT_EQ(ReadFile(FindSingleFile(directory/"expected", ".json")), ReadFile(FindSingleFile(directory/"actual", ".json")));
+
+    //'' released database is still shared while another Core holds it.
+    auto previousDatabase = core.GetMusicDatabasePtr();
+    core.BeginReloadMusicDatabase(DefaultMusicDatabaseFilename);
+    ASSERT_TRUE(core.PublishReloadedMusicDatabase(true));
+    EXPECT_NE(previousDatabase, core.GetMusicDatabasePtr());
+    EXPECT_EQ(previousDatabase, GetSharedMusicDatabase(databaseFilename));
+
+    //'' failed reload keeps current database.
+    auto currentDatabase = core.GetMusicDatabasePtr();
+    core.BeginReloadMusicDatabase((directory/"table"/"missing.json").string());
+    EXPECT_THROW(core.PublishReloadedMusicDatabase(true), std::runtime_error);
+    EXPECT_EQ(currentDatabase, core.GetMusicDatabasePtr());
+    ASSERT_NE(nullptr, core.FindAnalysis(iidxId));
+
+    ReleaseSharedMusicDatabase(databaseFilename);
+}
+
+TEST(Core, ReloadReorderedMusicDatabase)
+{
+    if (!fs::exists(DefaultMusicDatabaseFilename))
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    const std::string iidxId{"5483-7391"};
+    TestDirectory testDirectory{"score2dx_reload_reordered_music_database_test", {"table", iidxId, iidxId+"_later"}};
+    auto &directory = testDirectory.GetPath();
+    auto databaseFilename = (directory/"table"/fs::path{DefaultMusicDatabaseFilename}.filename()).string();
+    fs::copy_file(DefaultMusicDatabaseFilename, databaseFilename);
+
+    //'' reordered database: musics of TestMusicVersionIndex are in reversed order,
+    //'' first music is removed and second music is renamed with title mapping.
+    auto database = Json::parse(ReadFile(databaseFilename));
+    auto versionString = ToVersionString(TestMusicVersionIndex);
+    auto titles = database["version"][versionString].get<std::vector<std::string>>();
+    ASSERT_LE(4u, titles.size());
+    auto removedTitle = titles[0];
+    auto renamedTitle = titles[1];
+    auto keptTitle = titles[2];
+    auto newTitle = renamedTitle+" (score2dx renamed)";
+    auto &versionMusics = database["musicTable"][versionString];
+    versionMusics[newTitle] = versionMusics[renamedTitle];
+    versionMusics.erase(renamedTitle);
+    versionMusics.erase(removedTitle);
+    database["titleMapping"]["wiki"][renamedTitle] = newTitle;
+    titles.erase(titles.begin());
+    titles.front() = newTitle;
+    std::reverse(titles.begin(), titles.end());
+    database["version"][versionString] = titles;
+    auto reorderedFilename = (directory/"table"/"score2dx_reordered_database.json").string();
+    std::ofstream{reorderedFilename} << database.dump();
+
+    auto musicDatabase = GetSharedMusicDatabase(databaseFilename);
+    auto playerDirectory = directory/iidxId;
+    WriteCsv(*musicDatabase, PlayStyle::SinglePlay, 30, "2023-03-05", playerDirectory/(iidxId+"_sp_score_2023-03-05.csv"));
+    WriteExportedJson(*musicDatabase, iidxId, PlayStyle::DoublePlay, {"2022-03-01 12:00"}, playerDirectory/"score2dx_export_DP_2022-03-01.json");
+    Core core{musicDatabase};
+    ASSERT_TRUE(core.LoadDirectory(playerDirectory.string()));
+
+    //'' CSV added while reloading is remapped on publish.
+    testing::internal::CaptureStdout();
+    core.BeginReloadMusicDatabase(reorderedFilename);
+    auto laterDirectory = directory/(iidxId+"_later");
+    WriteCsv(*musicDatabase, PlayStyle::DoublePlay, 30, "2023-04-01", laterDirectory/(iidxId+"_dp_score_2023-04-01.csv"), 1);
+    ASSERT_TRUE(core.LoadDirectory(laterDirectory.string()));
+    auto expectedScoreStrings = ToTitleScoreStrings(core, iidxId);
+    ASSERT_TRUE(core.PublishReloadedMusicDatabase(true));
+    auto output = testing::internal::GetCapturedStdout();
+
+    auto reloadedDatabase = core.GetMusicDatabasePtr();
+    ASSERT_EQ(reloadedDatabase, GetSharedMusicDatabase(reorderedFilename));
+    EXPECT_NE(musicDatabase->FindMusicId(TestMusicVersionIndex, keptTitle), reloadedDatabase->FindMusicId(TestMusicVersionIndex, keptTitle));
+
+    //'' scores stay attached to same music, scores of removed music are dropped and reported.
+    ASSERT_TRUE(expectedScoreStrings.contains(keptTitle));
+    ASSERT_TRUE(expectedScoreStrings.contains(removedTitle));
+    ASSERT_TRUE(expectedScoreStrings.contains(renamedTitle));
+    expectedScoreStrings.erase(removedTitle);
+    auto renamedScoreStrings = expectedScoreStrings.extract(renamedTitle);
+    renamedScoreStrings.key() = newTitle;
+    expectedScoreStrings.insert(std::move(renamedScoreStrings));
+    EXPECT_EQ(expectedScoreStrings, ToTitleScoreStrings(core, iidxId));
+    EXPECT_NE(std::string::npos, output.find("["+removedTitle+"] are dropped")) << output;
+    EXPECT_NE(std::string::npos, output.find("["+removedTitle+"] is dropped")) << output;
+
+    ReleaseSharedMusicDatabase(reorderedFilename);
+}
+
+}
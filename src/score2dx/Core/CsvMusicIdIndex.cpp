@@ -0,0 +1,87 @@
+#include "score2dx/Core/CsvMusicIdIndex.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#include "score2dx/Core/BinaryStream.hxx"
+
+namespace score2dx
+{
+
+CsvMusicIdIndex::
+CsvMusicIdIndex(std::vector<CsvMusicIdEntry> entries)
+{
+    if (entries.size()>=UINT32_MAX/2)
+    {
+        throw std::runtime_error("CsvMusicIdIndex: too many entries.");
+    }
+
+    mEntries.reserve(entries.size());
+    mSlots.assign(std::bit_ceil(std::max<std::size_t>(entries.size()*2, 1)), 0);
+    auto mask = mSlots.size()-1;
+
+    for (auto &entry : entries)
+    {
+        auto slotIndex = ToSlotIndex(entry.CsvVersionIndex, entry.CsvTitle);
+        auto isDuplicated = false;
+        while (mSlots[slotIndex]!=0)
+        {
+            auto &indexedEntry = mEntries[mSlots[slotIndex]-1];
+            if (indexedEntry.CsvVersionIndex==entry.CsvVersionIndex&&indexedEntry.CsvTitle==entry.CsvTitle)
+            {
+                indexedEntry.MusicId = entry.MusicId;
+                isDuplicated = true;
+                break;
+            }
+            slotIndex = (slotIndex+1)&mask;
+        }
+
+        if (isDuplicated) { continue; }
+
+        mEntries.emplace_back(std::move(entry));
+        mSlots[slotIndex] = static_cast<std::uint32_t>(mEntries.size());
+    }
+}
+
+std::optional<std::size_t>
+CsvMusicIdIndex::
+Find(std::size_t csvVersionIndex, std::string_view csvTitle)
+const
+{
+    if (mEntries.empty()) { return std::nullopt; }
+
+    auto mask = mSlots.size()-1;
+    auto slotIndex = ToSlotIndex(csvVersionIndex, csvTitle);
+    while (mSlots[slotIndex]!=0)
+    {
+        auto &entry = mEntries[mSlots[slotIndex]-1];
+        if (entry.CsvVersionIndex==csvVersionIndex&&entry.CsvTitle==csvTitle)
+        {
+            return entry.MusicId;
+        }
+        slotIndex = (slotIndex+1)&mask;
+    }
+
+    return std::nullopt;
+}
+
+std::size_t
+CsvMusicIdIndex::
+GetEntryCount()
+const
+{
+    return mEntries.size();
+}
+
+std::size_t
+CsvMusicIdIndex::
+ToSlotIndex(std::size_t csvVersionIndex, std::string_view csvTitle)
+const
+{
+    //'' same title exists in several versions (revival), mix version into hash to spread them.
+    auto hash = ToFnv1aHash(csvTitle)^(csvVersionIndex*0x9E3779B97F4A7C15ULL);
+    return static_cast<std::size_t>(hash)&(mSlots.size()-1);
+}
+
+}
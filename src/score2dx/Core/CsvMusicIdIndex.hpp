@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace score2dx
+{
+
+struct CsvMusicIdEntry
+{
+    //! @brief Index of CSV version column, 1 denotes combined version "1st&substream".
+    std::size_t CsvVersionIndex{0};
+    //! @brief Title as in CSV title column, may differ from DbTitle by csv title mapping.
+    std::string CsvTitle;
+    std::size_t MusicId{0};
+};
+
+//! @brief Immutable open addressing (linear probing) hash index of {{CsvVersionIndex, CsvTitle}, MusicId}.
+//! Resolve CSV row version and title columns to MusicId by single probe,
+//! lookup by string_view, does not allocate.
+class CsvMusicIdIndex
+{
+public:
+        CsvMusicIdIndex() = default;
+
+    //! @brief Build index from entries. If a key appears more than once, the later entry is kept.
+        explicit CsvMusicIdIndex(std::vector<CsvMusicIdEntry> entries);
+
+    //! @return nullopt if key is not in index, e.g. new music not in database yet.
+        std::optional<std::size_t>
+        Find(std::size_t csvVersionIndex, std::string_view csvTitle)
+        const;
+
+        std::size_t
+        GetEntryCount()
+        const;
+
+private:
+    std::vector<CsvMusicIdEntry> mEntries;
+
+    //! @brief Vector of {Index=SlotIndex, EntryIndex+1}, 0 denotes empty slot.
+    //! @note Size is power of two and at least twice of entry count.
+    std::vector<std::uint32_t> mSlots;
+
+        std::size_t
+        ToSlotIndex(std::size_t csvVersionIndex, std::string_view csvTitle)
+        const;
+};
+
+}
@@ -0,0 +1,31 @@
+#include "score2dx/Core/CsvMusicIdIndex.hpp"
+
+#include <gtest/gtest.h>
+
+namespace score2dx
+{
+
+TEST(CsvMusicIdIndex, Find)
+{
+    CsvMusicIdIndex index
+    {
+        {
+            {1, "5.1.1.", 0},
+            {1, "GAMBOL", 1},
+            {1, "GAMBOL", 1003},
+            {29, "GAMBOL", 29012},
+            {29, "quell～the seventh slave～", 29013}
+        }
+    };
+
+    EXPECT_EQ(4u, index.GetEntryCount());
+    EXPECT_EQ(0u, index.Find(1, "5.1.1.").value());
+    EXPECT_EQ(1003u, index.Find(1, "GAMBOL").value());
+    EXPECT_EQ(29012u, index.Find(29, "GAMBOL").value());
+    EXPECT_EQ(29013u, index.Find(29, "quell～the seventh slave～").value());
+    EXPECT_FALSE(index.Find(30, "GAMBOL"));
+    EXPECT_FALSE(index.Find(29, "5.1.1."));
+    ASSERT_FALSE(CsvMusicIdIndex{}.Find(1, "GAMBOL"));
+}
+
+}
@@ -0,0 +1,287 @@
+#include "score2dx/Core/DirectoryWatcher.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+std::string
+ToCanonicalDirectory(const std::string &directory)
+{
+    if (!fs::exists(directory)||!fs::is_directory(directory))
+    {
+        throw std::runtime_error("["+directory+"] is not a directory.");
+    }
+
+    return fs::canonical(directory).lexically_normal().string();
+}
+
+void
+SortUnique(std::vector<std::string> &paths)
+{
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+}
+
+}
+
+namespace score2dx
+{
+
+#ifdef __linux__
+
+DirectoryWatcher::
+DirectoryWatcher()
+:   mInotifyFd(inotify_init1(IN_NONBLOCK|IN_CLOEXEC))
+{
+    if (mInotifyFd<0)
+    {
+        throw std::runtime_error("DirectoryWatcher: cannot create inotify instance.");
+    }
+}
+
+DirectoryWatcher::
+~DirectoryWatcher()
+{
+    close(mInotifyFd);
+}
+
+void
+DirectoryWatcher::
+AddDirectory(const std::string &directory)
+{
+    auto canonicalDirectory = ToCanonicalDirectory(directory);
+    for (auto &[watchDescriptor, watchedDirectory] : mWatchedDirectories)
+    {
+        (void)watchDescriptor;
+        if (watchedDirectory==canonicalDirectory) { return; }
+    }
+
+    auto watchDescriptor = inotify_add_watch(mInotifyFd, canonicalDirectory.c_str(), IN_CLOSE_WRITE|IN_MOVED_TO);
+    if (watchDescriptor<0)
+    {
+        throw std::runtime_error("DirectoryWatcher: cannot watch ["+canonicalDirectory+"].");
+    }
+
+    mWatchedDirectories[watchDescriptor] = canonicalDirectory;
+}
+
+void
+DirectoryWatcher::
+RemoveDirectory(const std::string &directory)
+{
+    auto canonicalDirectory = fs::weakly_canonical(directory).lexically_normal().string();
+    for (auto it = mWatchedDirectories.begin(); it!=mWatchedDirectories.end(); ++it)
+    {
+        if (it->second==canonicalDirectory)
+        {
+            inotify_rm_watch(mInotifyFd, it->first);
+            mWatchedDirectories.erase(it);
+            return;
+        }
+    }
+}
+
+std::vector<std::string>
+DirectoryWatcher::
+GetDirectories()
+const
+{
+    std::vector<std::string> directories;
+    for (auto &[watchDescriptor, directory] : mWatchedDirectories)
+    {
+        (void)watchDescriptor;
+        directories.emplace_back(directory);
+    }
+    std::sort(directories.begin(), directories.end());
+    return directories;
+}
+
+std::vector<std::string>
+DirectoryWatcher::
+PollChanges(std::chrono::milliseconds timeout)
+{
+    std::vector<std::string> changedPaths;
+    if (!ReadEvents(changedPaths)&&timeout.count()>0)
+    {
+        pollfd pollFd{mInotifyFd, POLLIN, 0};
+        if (poll(&pollFd, 1, static_cast<int>(timeout.count()))>0)
+        {
+            ReadEvents(changedPaths);
+        }
+    }
+
+    SortUnique(changedPaths);
+    return changedPaths;
+}
+
+bool
+DirectoryWatcher::
+ReadEvents(std::vector<std::string> &changedPaths)
+{
+    //'' buffer aligned for inotify_event, can hold many events with short filenames.
+    alignas(inotify_event) char buffer[16*1024];
+    auto hasEvent = false;
+    while (true)
+    {
+        auto readSize = read(mInotifyFd, buffer, sizeof(buffer));
+        if (readSize<=0)
+        {
+            if (readSize<0&&errno!=EAGAIN&&errno!=EINTR)
+            {
+                throw std::runtime_error("DirectoryWatcher: cannot read inotify events.");
+            }
+            return hasEvent;
+        }
+
+        hasEvent = true;
+        for (auto offset = 0l; offset<readSize;)
+        {
+            auto* event = reinterpret_cast<const inotify_event*>(buffer+offset);
+            offset += static_cast<long>(sizeof(inotify_event)+event->len);
+
+            //'' events are dropped, report every file of watched directories.
+            if (event->mask&IN_Q_OVERFLOW)
+            {
+                for (auto &[watchDescriptor, directory] : mWatchedDirectories)
+                {
+                    (void)watchDescriptor;
+                    for (auto &entry : fs::directory_iterator{directory})
+                    {
+                        if (entry.is_regular_file()) { changedPaths.emplace_back(entry.path().string()); }
+                    }
+                }
+                continue;
+            }
+
+            //'' directory is removed or unmounted.
+            if (event->mask&IN_IGNORED)
+            {
+                mWatchedDirectories.erase(event->wd);
+                continue;
+            }
+
+            auto findDirectory = mWatchedDirectories.find(event->wd);
+            if (findDirectory==mWatchedDirectories.end()||event->len==0||(event->mask&IN_ISDIR))
+            {
+                continue;
+            }
+
+            changedPaths.emplace_back((fs::path{findDirectory->second}/event->name).string());
+        }
+    }
+}
+
+#else
+
+DirectoryWatcher::
+DirectoryWatcher()
+{
+}
+
+DirectoryWatcher::
+~DirectoryWatcher()
+{
+}
+
+void
+DirectoryWatcher::
+AddDirectory(const std::string &directory)
+{
+    auto canonicalDirectory = ToCanonicalDirectory(directory);
+    if (mWatchedDirectories.count(canonicalDirectory)) { return; }
+
+    mWatchedDirectories[canonicalDirectory] = ScanDirectory(canonicalDirectory);
+}
+
+void
+DirectoryWatcher::
+RemoveDirectory(const std::string &directory)
+{
+    mWatchedDirectories.erase(fs::weakly_canonical(directory).lexically_normal().string());
+}
+
+std::vector<std::string>
+DirectoryWatcher::
+GetDirectories()
+const
+{
+    std::vector<std::string> directories;
+    for (auto &[directory, fileStates] : mWatchedDirectories)
+    {
+        (void)fileStates;
+        directories.emplace_back(directory);
+    }
+    return directories;
+}
+
+std::vector<std::string>
+DirectoryWatcher::
+PollChanges(std::chrono::milliseconds timeout)
+{
+    constexpr std::chrono::milliseconds PollInterval{200};
+
+    std::vector<std::string> changedPaths;
+    auto deadline = std::chrono::steady_clock::now()+timeout;
+    while (true)
+    {
+        for (auto &[directory, fileStates] : mWatchedDirectories)
+        {
+            auto currentStates = ScanDirectory(directory);
+            for (auto &[filename, state] : currentStates)
+            {
+                auto findState = fileStates.find(filename);
+                if (findState==fileStates.end()||findState->second!=state)
+                {
+                    changedPaths.emplace_back((fs::path{directory}/filename).string());
+                }
+            }
+            fileStates = std::move(currentStates);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (!changedPaths.empty()||now>=deadline)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(PollInterval, deadline-now));
+    }
+
+    SortUnique(changedPaths);
+    return changedPaths;
+}
+
+DirectoryWatcher::FileStates
+DirectoryWatcher::
+ScanDirectory(const std::string &directory)
+{
+    FileStates fileStates;
+    std::error_code errorCode;
+    for (auto &entry : fs::directory_iterator{directory, errorCode})
+    {
+        if (!entry.is_regular_file(errorCode)) { continue; }
+
+        auto fileSize = entry.file_size(errorCode);
+        if (errorCode) { continue; }
+        auto lastWriteTime = entry.last_write_time(errorCode);
+        if (errorCode) { continue; }
+
+        fileStates[entry.path().filename().string()] = {fileSize, lastWriteTime};
+    }
+    return fileStates;
+}
+
+#endif
+
+}
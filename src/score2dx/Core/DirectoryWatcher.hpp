@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace score2dx
+{
+
+//! @brief Watch directories for regular files which are created or modified.
+//! Linux uses inotify, file is reported after it's closed from writing or moved into directory, so partially
+//! written file is not reported.
+//! Other platforms poll size and last write time of files, file may be reported while it's being written,
+//! and reported again after writing finished.
+//! @note Not recursive, files in sub-directories are not watched.
+class DirectoryWatcher
+{
+public:
+    //! @brief Throws if watcher cannot be created.
+        DirectoryWatcher();
+        ~DirectoryWatcher();
+
+        DirectoryWatcher(const DirectoryWatcher &) = delete;
+        DirectoryWatcher & operator=(const DirectoryWatcher &) = delete;
+
+    //! @brief Start watching directory, files existing now are not reported.
+    //! Does nothing if directory is already watched. Throws if directory cannot be watched.
+        void
+        AddDirectory(const std::string &directory);
+
+    //! @brief Stop watching directory, does nothing if directory is not watched.
+        void
+        RemoveDirectory(const std::string &directory);
+
+    //! @brief Get canonical paths of watched directories.
+        std::vector<std::string>
+        GetDirectories()
+        const;
+
+    //! @brief Wait at most timeout for changes.
+    //! @return Sorted unique canonical paths of created or modified files since last call, empty if timeout.
+        std::vector<std::string>
+        PollChanges(std::chrono::milliseconds timeout);
+
+private:
+#ifdef __linux__
+    int mInotifyFd{-1};
+    //! @brief Map of {WatchDescriptor, Directory}.
+    std::map<int, std::string> mWatchedDirectories;
+
+    //! @brief Read pending events into changedPaths without blocking.
+    //! @return If any event was read.
+        bool
+        ReadEvents(std::vector<std::string> &changedPaths);
+#else
+    //! @brief Map of {Filename, {FileSize, LastWriteTime}}.
+    using FileStates = std::map<std::string, std::pair<std::uintmax_t, std::filesystem::file_time_type>>;
+
+    //! @brief Map of {Directory, FileStates}.
+    std::map<std::string, FileStates> mWatchedDirectories;
+
+        static FileStates
+        ScanDirectory(const std::string &directory);
+#endif
+};
+
+}
@@ -0,0 +1,41 @@
+#include "score2dx/Core/DirectoryWatcher.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+namespace score2dx
+{
+
+TEST(DirectoryWatcher, PollChanges)
+{
+    auto directory = fs::temp_directory_path()/"score2dx_DirectoryWatcherTest";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    std::ofstream{directory/"existing.csv"} << "existing";
+
+    DirectoryWatcher watcher;
+    watcher.AddDirectory(directory.string());
+    ASSERT_EQ(1u, watcher.GetDirectories().size());
+    EXPECT_TRUE(watcher.PollChanges(std::chrono::milliseconds{0}).empty());
+
+    auto canonicalDirectory = fs::path{watcher.GetDirectories().front()};
+    std::ofstream{directory/"new.csv"} << "new";
+    auto changedPaths = watcher.PollChanges(std::chrono::milliseconds{2000});
+    ASSERT_EQ(1u, changedPaths.size());
+    EXPECT_EQ((canonicalDirectory/"new.csv").string(), changedPaths.front());
+
+    watcher.RemoveDirectory(directory.string());
+    EXPECT_TRUE(watcher.GetDirectories().empty());
+    std::ofstream{directory/"after_remove.csv"} << "after remove";
+    EXPECT_TRUE(watcher.PollChanges(std::chrono::milliseconds{0}).empty());
+
+    EXPECT_THROW(watcher.AddDirectory((directory/"not_exist").string()), std::runtime_error);
+    fs::remove_all(directory);
+}
+
+}
@@ -0,0 +1,421 @@
+#include "score2dx/Core/ExportedScoreReader.hpp"
+
+#include <array>
+#include <charconv>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+
+#include "score2dx/Core/JsonDefinition.hpp"
+#include "score2dx/Iidx/Version.hpp"
+#include "score2dx/Score/ScoreLevel.hpp"
+
+namespace
+{
+
+//! @brief Parse whole text as int, throws if text is not an integer.
+int
+ParseInt(const std::string &text)
+{
+    int value = 0;
+    auto [end, errorCode] = std::from_chars(text.data(), text.data()+text.size(), value);
+    if (errorCode!=std::errc{}||end!=text.data()+text.size())
+    {
+        throw std::runtime_error("invalid integer ["+text+"].");
+    }
+    return value;
+}
+
+//! @brief SAX handler build MusicScores by key path of each value.
+//! Frames of data: [0] data/metadata, [1] Version, [2] Title, [3] DateTime, [4] play/score,
+//! [5] DifficultyAcronym, [6] score array.
+class ExportedScoreSaxHandler
+{
+public:
+    using number_integer_t = score2dx::Json::number_integer_t;
+    using number_unsigned_t = score2dx::Json::number_unsigned_t;
+    using number_float_t = score2dx::Json::number_float_t;
+    using string_t = score2dx::Json::string_t;
+    using binary_t = score2dx::Json::binary_t;
+
+        ExportedScoreSaxHandler(score2dx::ExportedScoreContent &content,
+                                score2dx::PlayStyle playStyle,
+                                const score2dx::MusicDatabase* musicDatabase,
+                                bool verbose)
+        :   mContent(content),
+            mPlayStyle(playStyle),
+            mMusicDatabase(musicDatabase),
+            mVerbose(verbose)
+        {
+        }
+
+        bool null() { return true; }
+        bool boolean(bool) { return true; }
+        bool binary(binary_t &) { return true; }
+
+        bool
+        number_integer(number_integer_t value)
+        {
+            SetPlayCount(static_cast<std::size_t>(value));
+            return true;
+        }
+
+        bool
+        number_unsigned(number_unsigned_t value)
+        {
+            SetPlayCount(static_cast<std::size_t>(value));
+            return true;
+        }
+
+        bool
+        number_float(number_float_t value, const string_t &)
+        {
+            SetPlayCount(static_cast<std::size_t>(value));
+            return true;
+        }
+
+        bool
+        string(string_t &value)
+        {
+            if (mDepth==2&&mFrames[0].Key=="metadata")
+            {
+                if (mFrames[1].Key=="id") { mContent.IidxId = std::move(value); mHasIidxId = true; }
+                if (mFrames[1].Key=="playStyle") { mContent.MetaPlayStyle = score2dx::ToPlayStyle(value); mHasPlayStyle = true; }
+                if (mFrames[1].Key=="lastDateTime") { mContent.LastDateTime = std::move(value); }
+                if (mFrames[1].Key=="sinceDateTime") { mContent.SinceDateTime = std::move(value); }
+            }
+            else if (mMusicScore&&mDepth==7&&mFrames[4].Key=="score")
+            {
+                if (mFieldCount<mFields.size())
+                {
+                    mFields[mFieldCount].swap(value);
+                }
+                ++mFieldCount;
+            }
+            return true;
+        }
+
+        bool
+        start_object(std::size_t)
+        {
+            if (IsData()&&mDepth==3&&mMusicDatabase)
+            {
+                HandleData([this] { ResolveMusicId(); });
+            }
+            if (mMusicId&&mDepth==4)
+            {
+                HandleData([this] { BeginMusicScore(); });
+            }
+            PushFrame();
+            return true;
+        }
+
+        bool
+        key(string_t &key)
+        {
+            auto &frame = mFrames[mDepth-1];
+            frame.Key.swap(key);
+            if (IsData()&&mDepth==2)
+            {
+                mContent.IsDataEmpty = false;
+            }
+            return true;
+        }
+
+        bool
+        end_object()
+        {
+            --mDepth;
+            if (mMusicScore&&mDepth==4)
+            {
+                if (mScoreVersionIndex)
+                {
+                    mContent.MusicScores.emplace_back(mScoreVersionIndex.value(), std::move(mMusicScore.value()));
+                }
+                mMusicScore.reset();
+            }
+            if (mDepth==3)
+            {
+                mMusicId.reset();
+            }
+            return true;
+        }
+
+        bool
+        start_array(std::size_t)
+        {
+            PushFrame();
+            mFieldCount = 0;
+            return true;
+        }
+
+        bool
+        end_array()
+        {
+            --mDepth;
+            if (mMusicScore&&mDepth==6&&mFrames[4].Key=="score")
+            {
+                HandleData([this] { SetChartScore(); });
+            }
+            return true;
+        }
+
+        bool
+        parse_error(std::size_t position, const std::string &, const score2dx::Json::exception &e)
+        {
+            throw std::runtime_error("ReadExportedScoreJson(): parse error at byte "+std::to_string(position)+": "+e.what());
+        }
+
+        void
+        CheckMetadata()
+        const
+        {
+            if (!mHasIidxId||!mHasPlayStyle)
+            {
+                throw std::runtime_error("metadata lacks id or playStyle.");
+            }
+        }
+
+private:
+    struct Frame
+    {
+        //! @brief Current key if frame is object.
+        std::string Key;
+    };
+
+    score2dx::ExportedScoreContent &mContent;
+    score2dx::PlayStyle mPlayStyle;
+    //! @brief Null if only metadata is read, data is skipped.
+    const score2dx::MusicDatabase* mMusicDatabase;
+    bool mVerbose{false};
+    bool mHasIidxId{false};
+    bool mHasPlayStyle{false};
+
+    //! @brief Vector of {Index=Depth, Frame}, frames beyond mDepth are kept to reuse key capacity.
+    std::vector<Frame> mFrames;
+    std::size_t mDepth{0};
+
+    //'' current title, record and score array.
+    std::optional<std::size_t> mMusicId;
+    std::optional<score2dx::MusicScore> mMusicScore;
+    //! @brief Score version of current record, nullopt if DateTime is not supported and record is skipped.
+    std::optional<std::size_t> mScoreVersionIndex;
+    //! @brief [score, pgreat, great, miss, clear, djLevel], same order as CSV.
+    std::array<std::string, 6> mFields;
+    std::size_t mFieldCount{0};
+
+        bool
+        IsData()
+        const
+        {
+            return mDepth>=1&&mFrames[0].Key=="data";
+        }
+
+    //! @brief Run data handling until first error, error is recorded and rest of data is skipped,
+    //! metadata after data is still read.
+        template <typename Function>
+        void
+        HandleData(Function function)
+        {
+            if (!mContent.DataError.empty()) { return; }
+            try
+            {
+                function();
+            }
+            catch (const std::exception &e)
+            {
+                mContent.DataError = e.what();
+                mMusicId.reset();
+                mMusicScore.reset();
+            }
+        }
+
+        void
+        PushFrame()
+        {
+            if (mDepth==mFrames.size())
+            {
+                mFrames.emplace_back();
+            }
+            mFrames[mDepth].Key.clear();
+            ++mDepth;
+        }
+
+        const std::string &
+        GetDbTitle()
+        const
+        {
+            auto &title = mFrames[2].Key;
+            if (auto* titleMapping = mMusicDatabase->FindTitleMapping(title))
+            {
+                return titleMapping->DbTitle;
+            }
+            return title;
+        }
+
+        void
+        ResolveMusicId()
+        {
+            auto [versionIndex, musicIndex] = mMusicDatabase->FindIndexes(mFrames[1].Key, GetDbTitle());
+            mMusicId = score2dx::ToMusicId(versionIndex, musicIndex);
+        }
+
+        void
+        BeginMusicScore()
+        {
+            auto &dateTime = mFrames[3].Key;
+
+            //'' design changed, all existing Json are assumed dumped from IIDX ME.
+            //'' until new Json format that dump ScoreSource also.
+            auto &musicScore = mMusicScore.emplace(mMusicId.value(), mPlayStyle, 0, dateTime, score2dx::ScoreSource::Me);
+
+            mScoreVersionIndex = score2dx::FindVersionIndexFromDateTime(dateTime);
+            if (!mScoreVersionIndex)
+            {
+                std::cout << "Data contains date time not supported.\n"
+                          << "[" << mFrames[1].Key << "][" << mFrames[2].Key << "][" << dateTime << "]\n";
+                return;
+            }
+
+            auto* activeVersionPtr = mMusicDatabase->FindActiveVersion(mScoreVersionIndex.value());
+            if (!activeVersionPtr)
+            {
+                throw std::runtime_error("cannot find active versioin");
+            }
+            for (auto difficulty : activeVersionPtr->GetAvailableCharts(mMusicId.value(), mPlayStyle))
+            {
+                musicScore.EnableChartScore(difficulty);
+            }
+        }
+
+        void
+        SetPlayCount(std::size_t playCount)
+        {
+            if (mMusicScore&&mDepth==5&&mFrames[4].Key=="play")
+            {
+                mMusicScore->SetPlayCount(playCount);
+            }
+        }
+
+        void
+        SetChartScore()
+        {
+            if (!mScoreVersionIndex) { return; }
+
+            auto &musicId = mMusicId.value();
+            auto scoreVersionIndex = mScoreVersionIndex.value();
+            auto &dateTime = mFrames[3].Key;
+            auto &dbTitle = GetDbTitle();
+            auto versionIndex = score2dx::ToIndexes(musicId).first;
+            if (mFieldCount<mFields.size())
+            {
+                throw std::runtime_error("["+dbTitle+"]["+dateTime+"]["+mFrames[5].Key+"] score has less than 6 fields.");
+            }
+
+            auto difficulty = static_cast<score2dx::Difficulty>(score2dx::ToDifficultyAcronym(mFrames[5].Key));
+            auto &chartScore = mMusicScore->EnableChartScore(difficulty);
+
+            if (!mFields[0].empty()) { chartScore.ExScore = ParseInt(mFields[0]); }
+            if (!mFields[1].empty()) { chartScore.PGreatCount = ParseInt(mFields[1]); }
+            if (!mFields[2].empty()) { chartScore.GreatCount = ParseInt(mFields[2]); }
+            if (mFields[3]!="---") { chartScore.MissCount = ParseInt(mFields[3]); }
+            chartScore.ClearType = score2dx::ToClearType(mFields[4]);
+            if (mFields[5]!="---") { chartScore.DjLevel = score2dx::ToDjLevel(mFields[5]); }
+
+            auto styleDifficulty = score2dx::ConvertToStyleDifficulty(mPlayStyle, difficulty);
+
+            if (chartScore.MissCount && chartScore.MissCount==0 && chartScore.ClearType!=score2dx::ClearType::FULLCOMBO_CLEAR)
+            {
+                if (mVerbose)
+                {
+                    std::cout << "[" << score2dx::ToVersionString(versionIndex)
+                              << "][" << dbTitle
+                              << "][" << ToString(styleDifficulty)
+                              << "][" << dateTime
+                              << "] has ClearType [" << ToString(chartScore.ClearType)
+                              << "] and MissCount has value " << chartScore.MissCount.value()
+                              << "\n";
+                }
+                chartScore.MissCount = std::nullopt;
+            }
+
+            auto findChartInfo = mMusicDatabase->FindChartInfo(musicId, styleDifficulty, scoreVersionIndex);
+            if (!findChartInfo)
+            {
+                //'' exported data from script may contain difficulty not existing (yet).
+                std::cout << score2dx::ToVersionString(versionIndex) << " Title [" << dbTitle << "]\n"
+                          << "DateTime: " << dateTime << "\n"
+                          << "ScoreVersion: " << score2dx::ToVersionString(scoreVersionIndex) << "\n"
+                          << "StyleDifficulty: " << ToString(styleDifficulty) << "\n";
+                throw std::runtime_error("cannot find chart info");
+            }
+
+            auto &chartInfo = *findChartInfo;
+            if (chartInfo.Note<=0)
+            {
+                std::cout << score2dx::ToVersionString(versionIndex) << " Title [" << dbTitle << "]\n"
+                          << "DateTime: " << dateTime << "\n"
+                          << "ScoreVersion: " << score2dx::ToVersionString(scoreVersionIndex) << "\n"
+                          << "StyleDifficulty: " << ToString(styleDifficulty) << "\n";
+                throw std::runtime_error("DB chart info note is non-positive.");
+            }
+
+            auto actualDjLevel = score2dx::FindDjLevel(chartInfo.Note, chartScore.ExScore);
+            if (actualDjLevel!=chartScore.DjLevel)
+            {
+                if (mVerbose)
+                {
+                    std::cout << "Warning: unmatched DJ level in import file:"
+                              << "\n[" << score2dx::ToVersionString(versionIndex)
+                              << "][" << dbTitle
+                              << "][" << ToString(styleDifficulty)
+                              << "]\nLevel: " << chartInfo.Level
+                              << ", Note: " << chartInfo.Note
+                              << ", Score: " << chartScore.ExScore
+                              << ", Actual DJ Level: " << ToString(actualDjLevel)
+                              << ", Data DJ Level: " << ToString(chartScore.DjLevel)
+                              << "\nDateTime: " << dateTime
+                              << ", ScoreVersion: " << score2dx::ToVersionString(scoreVersionIndex)
+                              << "."
+                              << std::endl;
+                }
+                chartScore.DjLevel = actualDjLevel;
+            }
+        }
+};
+
+}
+
+namespace score2dx
+{
+
+ExportedScoreContent
+ReadExportedScoreJson(std::string_view jsonText,
+                      PlayStyle playStyle,
+                      const MusicDatabase &musicDatabase,
+                      bool verbose)
+{
+    ExportedScoreContent content;
+    ExportedScoreSaxHandler handler{content, playStyle, &musicDatabase, verbose};
+    if (!Json::sax_parse(jsonText.begin(), jsonText.end(), &handler))
+    {
+        throw std::runtime_error("ReadExportedScoreJson(): parse failed.");
+    }
+    handler.CheckMetadata();
+    return content;
+}
+
+ExportedScoreContent
+ReadExportedScoreMetadata(std::string_view jsonText)
+{
+    ExportedScoreContent content;
+    ExportedScoreSaxHandler handler{content, PlayStyle::SinglePlay, nullptr, false};
+    if (!Json::sax_parse(jsonText.begin(), jsonText.end(), &handler))
+    {
+        throw std::runtime_error("ReadExportedScoreMetadata(): parse failed.");
+    }
+    handler.CheckMetadata();
+    return content;
+}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "score2dx/Core/MusicDatabase.hpp"
+#include "score2dx/Iidx/Definition.hpp"
+#include "score2dx/Score/MusicScore.hpp"
+
+namespace score2dx
+{
+
+//! @brief Typed content of score2dx exported Json, see Core::Export.
+struct ExportedScoreContent
+{
+    //! @brief metadata/id.
+    std::string IidxId;
+    //! @brief metadata/playStyle.
+    PlayStyle MetaPlayStyle{PlayStyle::SinglePlay};
+    //! @brief metadata/lastDateTime, last DateTime of exported scores.
+    std::string LastDateTime;
+    //! @brief metadata/sinceDateTime, only scores after it are exported, empty if not delta export.
+    std::string SinceDateTime;
+    //! @brief If data has no version entry.
+    bool IsDataEmpty{true};
+    //! @brief Vector of {ScoreVersionIndex, MusicScore} in file order.
+    std::vector<std::pair<std::size_t, MusicScore>> MusicScores;
+    //! @brief First error of data (e.g. unknown title or invalid score), empty if data is valid.
+    //! Data after the error is skipped, MusicScores is incomplete if not empty.
+    std::string DataError;
+};
+
+//! @brief Read score2dx exported Json by SAX parsing, build MusicScores of playStyle while parsing without
+//! Json DOM. Numbers in score arrays are parsed with from_chars.
+//! Key path of exported Json:
+//!     metadata/{id|playStyle|dateTimeType|lastDateTime|scoreVersion|sinceDateTime}
+//!     data/{Version}/{Title}/{DateTime}/play
+//!     data/{Version}/{Title}/{DateTime}/score/{DifficultyAcronym}/[score, pgreat, great, miss, clear, djLevel]
+//! @note Export writes metadata after data, so playStyle is given by caller (e.g. from filename), read again
+//! with MetaPlayStyle if they disagree.
+//! Throws if jsonText is not valid Json or metadata lacks id or playStyle. Invalid data is recorded in DataError
+//! instead, so caller can check metadata (e.g. id) before rejecting the file.
+ExportedScoreContent
+ReadExportedScoreJson(std::string_view jsonText,
+                      PlayStyle playStyle,
+                      const MusicDatabase &musicDatabase,
+                      bool verbose);
+
+//! @brief Read only metadata of score2dx exported Json, data is parsed but no MusicScore is built.
+//! Throws if jsonText is not valid Json or metadata lacks id or playStyle.
+ExportedScoreContent
+ReadExportedScoreMetadata(std::string_view jsonText);
+
+}
@@ -0,0 +1,153 @@
+#include "score2dx/Core/ExportedScoreReader.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "score2dx/Core/Core.hpp"
+#include "score2dx/Core/TestUtil.hpp"
+#include "score2dx/Iidx/Version.hpp"
+
+namespace score2dx
+{
+
+namespace
+{
+
+const std::string TestIidxId{"5483-7391"};
+const std::vector<std::string> TestDateTimes{"2021-12-04 15:33", "2022-05-01 09:05", "2023-03-05 21:15"};
+
+//! @brief Sorted text of {ScoreVersionIndex, MusicId, MusicScore}, file order is not compared.
+std::vector<std::string>
+ToSortedScoreStrings(const ExportedScoreContent &content)
+{
+    std::vector<std::string> scoreStrings;
+    for (auto &[scoreVersionIndex, musicScore] : content.MusicScores)
+    {
+        scoreStrings.emplace_back(std::to_string(scoreVersionIndex)+" "+ToMusicIdString(musicScore.GetMusicId())+" "+ToTestString(musicScore));
+    }
+    std::sort(scoreStrings.begin(), scoreStrings.end());
+    return scoreStrings;
+}
+
+//! @brief First score array of first record of first title in data.
+Json &
+GetFirstScoreArray(Json &exportedJson)
+{
+    auto &titles = exportedJson["data"].begin().value();
+    auto &records = titles.begin().value();
+    return records.begin().value()["score"].begin().value();
+}
+
+}
+
+TEST(ExportedScoreReader, RoundTrip)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase)
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    auto exportedJson = MakeExportedJson(*musicDatabase, TestIidxId, PlayStyle::DoublePlay, TestDateTimes, 8);
+    auto content = ReadExportedScoreJson(exportedJson.dump(), PlayStyle::DoublePlay, *musicDatabase, false);
+    EXPECT_EQ(TestIidxId, content.IidxId);
+    EXPECT_EQ(PlayStyle::DoublePlay, content.MetaPlayStyle);
+    EXPECT_FALSE(content.IsDataEmpty);
+    EXPECT_TRUE(content.DataError.empty());
+    ASSERT_EQ(8*TestDateTimes.size(), content.MusicScores.size());
+
+    auto &[scoreVersionIndex, firstScore] = content.MusicScores.front();
+    EXPECT_EQ(FindVersionIndexFromDateTime(firstScore.GetDateTime()), scoreVersionIndex);
+    EXPECT_FALSE(firstScore.GetChartScores().empty());
+    for (auto &[difficulty, chartScore] : firstScore.GetChartScores())
+    {
+        auto expectedScore = exportedJson["data"][VersionNames[TestMusicVersionIndex]]
+                                         [musicDatabase->GetTitle(firstScore.GetMusicId())]
+                                         [firstScore.GetDateTime()]["score"][ToString(static_cast<DifficultyAcronym>(difficulty))];
+        EXPECT_EQ(expectedScore[0].get<std::string>(), std::to_string(chartScore->ExScore));
+        EXPECT_EQ(expectedScore[1].get<std::string>(), std::to_string(chartScore->PGreatCount));
+        EXPECT_EQ(expectedScore[2].get<std::string>(), std::to_string(chartScore->GreatCount));
+    }
+
+    //'' scores of exported file read back same as imported.
+    TestDirectory testDirectory{"score2dx_exported_score_reader_test", {"input", "output"}};
+    auto &directory = testDirectory.GetPath();
+    Core core{musicDatabase};
+    core.Import(TestIidxId, WriteExportedJson(*musicDatabase, TestIidxId, PlayStyle::DoublePlay, TestDateTimes, directory/"input"/"score2dx_export_DP_2023-03-05.json", 8));
+    core.Export(TestIidxId, PlayStyle::DoublePlay, (directory/"output").string());
+    auto exportedText = ReadFile(FindSingleFile(directory/"output", ".json"));
+
+    auto roundTripContent = ReadExportedScoreJson(exportedText, PlayStyle::DoublePlay, *musicDatabase, false);
+    EXPECT_TRUE(roundTripContent.DataError.empty());
+    EXPECT_EQ(ToSortedScoreStrings(content), ToSortedScoreStrings(roundTripContent));
+
+    auto metadata = ReadExportedScoreMetadata(exportedText);
+    EXPECT_EQ(TestIidxId, metadata.IidxId);
+    EXPECT_EQ(PlayStyle::DoublePlay, metadata.MetaPlayStyle);
+    EXPECT_EQ(roundTripContent.LastDateTime, metadata.LastDateTime);
+    EXPECT_TRUE(metadata.MusicScores.empty());
+}
+
+TEST(ExportedScoreReader, MalformedInput)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase)
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    auto exportedJson = MakeExportedJson(*musicDatabase, TestIidxId, PlayStyle::SinglePlay, TestDateTimes);
+    auto read = [&](const Json &json)
+    {
+        return ReadExportedScoreJson(json.dump(), PlayStyle::SinglePlay, *musicDatabase, false);
+    };
+
+    //'' invalid Json or metadata throws.
+    auto text = exportedJson.dump();
+    EXPECT_THROW(ReadExportedScoreJson(text.substr(0, text.size()/2), PlayStyle::SinglePlay, *musicDatabase, false), std::runtime_error);
+    EXPECT_THROW(ReadExportedScoreMetadata(text.substr(0, text.size()/2)), std::runtime_error);
+    {
+        auto noIdJson = exportedJson;
+        noIdJson["metadata"].erase("id");
+        EXPECT_THROW(read(noIdJson), std::runtime_error);
+        EXPECT_THROW(ReadExportedScoreMetadata(noIdJson.dump()), std::runtime_error);
+    }
+
+    //'' invalid data is recorded, metadata is still read so caller can check id first.
+    auto expectDataError = [&](const Json &json, const std::string &error)
+    {
+        auto content = read(json);
+        EXPECT_EQ(TestIidxId, content.IidxId);
+        EXPECT_NE(std::string::npos, content.DataError.find(error)) << content.DataError;
+        return content;
+    };
+    auto invalidMissJson = exportedJson;
+    GetFirstScoreArray(invalidMissJson)[3] = "abc";
+    EXPECT_TRUE(expectDataError(invalidMissJson, "invalid integer [abc]").MusicScores.empty());
+    {
+        auto shortScoreJson = exportedJson;
+        GetFirstScoreArray(shortScoreJson).erase(5);
+        expectDataError(shortScoreJson, "less than 6 fields");
+    }
+    {
+        auto unknownTitleJson = exportedJson;
+        auto &titles = unknownTitleJson["data"][VersionNames[TestMusicVersionIndex]];
+        titles["score2dx unknown title"] = titles.begin().value();
+        expectDataError(unknownTitleJson, "cannot find");
+    }
+
+    //'' file of other player is skipped before its data error, file of required player throws.
+    TestDirectory testDirectory{"score2dx_exported_score_reader_malformed_test"};
+    auto invalidMissPath = (testDirectory.GetPath()/"score2dx_export_SP_2023-03-05.json").string();
+    std::ofstream{invalidMissPath} << invalidMissJson.dump();
+    Core core{musicDatabase};
+    EXPECT_NO_THROW(core.Import("1000-2000", invalidMissPath));
+    EXPECT_THROW(core.Import(TestIidxId, invalidMissPath), std::runtime_error);
+}
+
+}
@@ -0,0 +1,176 @@
+#include "score2dx/Core/JsonStreamWriter.hpp"
+
+#include <charconv>
+#include <stdexcept>
+
+namespace
+{
+
+//! @brief Buffered bytes to write to stream at a time.
+constexpr std::size_t JsonStreamBlockSize = 64*1024;
+
+}
+
+namespace score2dx
+{
+
+JsonStreamWriter::
+JsonStreamWriter(std::ostream &stream)
+:   mStream(stream)
+{
+    mBuffer.reserve(JsonStreamBlockSize+1024);
+}
+
+void
+JsonStreamWriter::
+BeginObject()
+{
+    BeginValue();
+    mBuffer += '{';
+    mIsEmptyStack.push_back(true);
+}
+
+void
+JsonStreamWriter::
+EndObject()
+{
+    mBuffer += '}';
+    mIsEmptyStack.pop_back();
+    FlushIfFull();
+}
+
+void
+JsonStreamWriter::
+BeginArray()
+{
+    BeginValue();
+    mBuffer += '[';
+    mIsEmptyStack.push_back(true);
+}
+
+void
+JsonStreamWriter::
+EndArray()
+{
+    mBuffer += ']';
+    mIsEmptyStack.pop_back();
+    FlushIfFull();
+}
+
+void
+JsonStreamWriter::
+Key(std::string_view key)
+{
+    BeginValue();
+    WriteEscaped(key);
+    mBuffer += ':';
+    mIsAfterKey = true;
+}
+
+void
+JsonStreamWriter::
+String(std::string_view value)
+{
+    BeginValue();
+    WriteEscaped(value);
+    FlushIfFull();
+}
+
+void
+JsonStreamWriter::
+Unsigned(std::uint64_t value)
+{
+    BeginValue();
+    char digits[24];
+    auto result = std::to_chars(digits, digits+sizeof(digits), value);
+    mBuffer.append(digits, result.ptr);
+}
+
+void
+JsonStreamWriter::
+Null()
+{
+    BeginValue();
+    mBuffer += "null";
+}
+
+void
+JsonStreamWriter::
+Flush()
+{
+    mStream.write(mBuffer.data(), static_cast<std::streamsize>(mBuffer.size()));
+    mBuffer.clear();
+    if (!mStream)
+    {
+        throw std::runtime_error("JsonStreamWriter: cannot write to stream.");
+    }
+}
+
+void
+JsonStreamWriter::
+BeginValue()
+{
+    if (mIsAfterKey)
+    {
+        mIsAfterKey = false;
+        return;
+    }
+
+    if (!mIsEmptyStack.empty())
+    {
+        if (!mIsEmptyStack.back())
+        {
+            mBuffer += ',';
+        }
+        mIsEmptyStack.back() = false;
+    }
+}
+
+void
+JsonStreamWriter::
+WriteEscaped(std::string_view text)
+{
+    static constexpr char HexDigits[] = "0123456789abcdef";
+
+    mBuffer += '"';
+    for (auto c : text)
+    {
+        switch (c)
+        {
+            case '"': mBuffer += "\\\""; break;
+            case '\\': mBuffer += "\\\\"; break;
+            case '\b': mBuffer += "\\b"; break;
+            case '\f': mBuffer += "\\f"; break;
+            case '\n': mBuffer += "\\n"; break;
+            case '\r': mBuffer += "\\r"; break;
+            case '\t': mBuffer += "\\t"; break;
+            default:
+            {
+                auto byte = static_cast<unsigned char>(c);
+                if (byte<0x20)
+                {
+                    mBuffer += "\\u00";
+                    mBuffer += HexDigits[byte>>4];
+                    mBuffer += HexDigits[byte&0xF];
+                }
+                else
+                {
+                    mBuffer += c;
+                }
+            }
+        }
+    }
+    mBuffer += '"';
+}
+
+void
+JsonStreamWriter::
+FlushIfFull()
+{
+    if (mBuffer.size()>=JsonStreamBlockSize)
+    {
+        Flush();
+    }
+}
+
+}
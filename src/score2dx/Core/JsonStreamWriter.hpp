@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace score2dx
+{
+
+//! @brief Write compact Json to stream without building Json DOM.
+//! Output is same as dump of equivalent Json: no whitespace, only '"', '\' and control characters are
+//! escaped, UTF-8 is written as is. Values are written in call order, caller writes object keys in sorted
+//! order to match Json.
+//! Output is buffered and written to stream in blocks.
+//! @note Call Flush after writing, destructor does not flush.
+class JsonStreamWriter
+{
+public:
+        explicit JsonStreamWriter(std::ostream &stream);
+
+        void
+        BeginObject();
+
+        void
+        EndObject();
+
+        void
+        BeginArray();
+
+        void
+        EndArray();
+
+    //! @brief Write key of object member, next call writes its value.
+        void
+        Key(std::string_view key);
+
+        void
+        String(std::string_view value);
+
+        void
+        Unsigned(std::uint64_t value);
+
+        void
+        Null();
+
+    //! @brief Write buffered output to stream, throws if stream fails.
+        void
+        Flush();
+
+private:
+    std::ostream &mStream;
+    std::string mBuffer;
+    //! @brief Stack of open object or array, true if no member is written yet.
+    std::vector<bool> mIsEmptyStack;
+    //! @brief Key is written and value is not.
+    bool mIsAfterKey{false};
+
+    //! @brief Write comma if value is not first member of open object or array.
+        void
+        BeginValue();
+
+        void
+        WriteEscaped(std::string_view text);
+
+        void
+        FlushIfFull();
+};
+
+}
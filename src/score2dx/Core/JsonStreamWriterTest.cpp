@@ -0,0 +1,70 @@
+#include "score2dx/Core/JsonStreamWriter.hpp"
+
+#include <array>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "score2dx/Core/JsonDefinition.hpp"
+
+namespace score2dx
+{
+
+TEST(JsonStreamWriter, SameAsJsonDump)
+{
+    const std::string escapedText{"quote\" back\\slash\b\f\n\r\t\x01\x1f\x7f UTF-8 \xE3\x81\x82"};
+
+    Json json;
+    json["data"]["1st&substream"]["title"]["2021-12-04 15:33"]["play"] = 18446744073709551615ull;
+    json["data"]["1st&substream"]["title"]["2021-12-04 15:33"]["score"]["A"] = std::array<std::string, 2>{"1881", "---"};
+    json["data"]["1st&substream"]["empty"] = nullptr;
+    json["data"][escapedText] = std::vector<std::string>{};
+    json["metadata"]["id"] = escapedText;
+    json["metadata"]["count"] = 0;
+
+    std::ostringstream stream;
+    JsonStreamWriter writer{stream};
+    writer.BeginObject();
+    writer.Key("data");
+    writer.BeginObject();
+    writer.Key("1st&substream");
+    writer.BeginObject();
+    writer.Key("empty");
+    writer.Null();
+    writer.Key("title");
+    writer.BeginObject();
+    writer.Key("2021-12-04 15:33");
+    writer.BeginObject();
+    writer.Key("play");
+    writer.Unsigned(18446744073709551615ull);
+    writer.Key("score");
+    writer.BeginObject();
+    writer.Key("A");
+    writer.BeginArray();
+    writer.String("1881");
+    writer.String("---");
+    writer.EndArray();
+    writer.EndObject();
+    writer.EndObject();
+    writer.EndObject();
+    writer.EndObject();
+    writer.Key(escapedText);
+    writer.BeginArray();
+    writer.EndArray();
+    writer.EndObject();
+    writer.Key("metadata");
+    writer.BeginObject();
+    writer.Key("count");
+    writer.Unsigned(0);
+    writer.Key("id");
+    writer.String(escapedText);
+    writer.EndObject();
+    writer.EndObject();
+    writer.Flush();
+
+    ASSERT_EQ(json.dump(), stream.str());
+}
+
+}
@@ -0,0 +1,144 @@
+#include "score2dx/Core/MappedFile.hpp"
+
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace score2dx
+{
+
+MappedFile::
+MappedFile(const std::string &filename)
+:   mFilename(filename)
+{
+    if (!fs::exists(filename)||!fs::is_regular_file(filename))
+    {
+        throw std::runtime_error("cannot map file ["+filename+"]: not a regular file.");
+    }
+
+    auto fileSize = static_cast<std::size_t>(fs::file_size(filename));
+    if (fileSize==0)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    auto* fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle==INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("cannot open file ["+filename+"].");
+    }
+
+    auto* mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(fileHandle);
+    if (!mappingHandle)
+    {
+        throw std::runtime_error("cannot create file mapping of ["+filename+"].");
+    }
+
+    auto* data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mappingHandle);
+    if (!data)
+    {
+        throw std::runtime_error("cannot map view of file ["+filename+"].");
+    }
+#else
+    auto fd = open(filename.c_str(), O_RDONLY);
+    if (fd<0)
+    {
+        throw std::runtime_error("cannot open file ["+filename+"].");
+    }
+
+    auto* data = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data==MAP_FAILED)
+    {
+        throw std::runtime_error("cannot mmap file ["+filename+"].");
+    }
+#endif
+
+    mData = static_cast<const char*>(data);
+    mSize = fileSize;
+}
+
+MappedFile::
+~MappedFile()
+{
+    Unmap();
+}
+
+MappedFile::
+MappedFile(MappedFile &&other) noexcept
+:   mFilename(std::move(other.mFilename)),
+    mData(std::exchange(other.mData, nullptr)),
+    mSize(std::exchange(other.mSize, 0))
+{
+}
+
+MappedFile &
+MappedFile::
+operator=(MappedFile &&other) noexcept
+{
+    if (this!=&other)
+    {
+        Unmap();
+        mFilename = std::move(other.mFilename);
+        mData = std::exchange(other.mData, nullptr);
+        mSize = std::exchange(other.mSize, 0);
+    }
+    return *this;
+}
+
+const std::string &
+MappedFile::
+GetFilename()
+const
+{
+    return mFilename;
+}
+
+std::string_view
+MappedFile::
+GetView()
+const
+{
+    return {mData, mSize};
+}
+
+std::size_t
+MappedFile::
+GetSize()
+const
+{
+    return mSize;
+}
+
+void
+MappedFile::
+Unmap()
+{
+    if (!mData) { return; }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mData);
+#else
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    munmap(const_cast<char*>(mData), mSize);
+#endif
+
+    mData = nullptr;
+    mSize = 0;
+}
+
+}
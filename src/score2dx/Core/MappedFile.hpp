@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace score2dx
+{
+
+//! @brief Read-only memory mapped file, content is valid during lifetime of MappedFile.
+//! @note Empty file is mapped as empty view.
+class MappedFile
+{
+public:
+    //! @brief Map whole file, throws if file cannot be opened or mapped.
+        explicit MappedFile(const std::string &filename);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile & operator=(MappedFile &&other) noexcept;
+
+        const std::string &
+        GetFilename()
+        const;
+
+        std::string_view
+        GetView()
+        const;
+
+        std::size_t
+        GetSize()
+        const;
+
+private:
+    std::string mFilename;
+    const char* mData{nullptr};
+    std::size_t mSize{0};
+
+        void
+        Unmap();
+};
+
+}
@@ -2,7 +2,11 @@
 
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <mutex>
+
+#include "fmt/format.h"
 
 #include "ies/Common/AdjacentArrayRange.hxx"
 #include "ies/Common/IntegralRangeUsing.hpp"
@@ -11,6 +15,11 @@
 #include "ies/Time/ScopeTimePrinter.hxx"
 #include "ies/Time/TimeUtilFormat.hxx"
 
+#include "score2dx/Core/BinaryStream.hxx"
+#include "score2dx/Core/MappedFile.hpp"
+#include "score2dx/Core/MusicDatabaseJsonReader.hpp"
+#include "score2dx/Core/ParallelFor.hxx"
+#include "score2dx/Core/ProcessMemory.hpp"
 #include "score2dx/Iidx/Version.hpp"
 
 namespace fs = std::filesystem;
@@ -18,6 +27,54 @@ namespace fs = std::filesystem;
 namespace
 {
 
+const std::string SnapshotExtension{".s2db"};
+const std::string SnapshotMagic{"S2DB"};
+//'' increase when snapshot layout or built table semantic changed.
+constexpr std::uint32_t SnapshotFormatVersion = 3;
+
+//! @return nullptr if version has no music in table.
+const score2dx::DbVersionMusicTable*
+FindVersionMusicTable(const std::map<std::string, score2dx::DbVersionMusicTable> &table,
+                      const std::string &version)
+{
+    auto findVersion = ies::Find(table, version);
+    if (!findVersion) { return nullptr; }
+    return &(findVersion.value()->second);
+}
+
+//! @brief Entry of SharedMusicDatabaseCache.
+struct SharedMusicDatabaseEntry
+{
+    //! @brief Future of first load, invalid after loaded.
+    std::shared_future<std::shared_ptr<const score2dx::MusicDatabase>> Loading;
+    //! @brief Handle owned by cache, reset by ReleaseSharedMusicDatabase.
+    std::shared_ptr<const score2dx::MusicDatabase> Pinned;
+    //! @brief Loaded database, still shared after released while any other handle exists.
+    std::weak_ptr<const score2dx::MusicDatabase> Database;
+};
+
+//! @brief Process-wide cache of GetSharedMusicDatabase.
+struct SharedMusicDatabaseCache
+{
+    std::mutex Mutex;
+    //! @brief Map of {Filename, SharedMusicDatabaseEntry}.
+    std::map<std::string, SharedMusicDatabaseEntry> Databases;
+};
+
+SharedMusicDatabaseCache &
+GetSharedMusicDatabaseCache()
+{
+    static SharedMusicDatabaseCache cache;
+    return cache;
+}
+
+std::string
+ToMemoryString(std::size_t memoryBytes)
+{
+    if (memoryBytes==0) { return "N/A"; }
+    return fmt::format("{:.1f} MiB", static_cast<double>(memoryBytes)/(1024.0*1024.0));
+}
+
 /*
 bool
 IsActive(std::size_t activeVersionIndex, const std::string &availableVersions)
@@ -34,127 +91,64 @@ namespace score2dx
 
 MusicDatabase::
 MusicDatabase()
+:   MusicDatabase(GetUsingMusicDatabaseFilename())
+{
+}
+
+MusicDatabase::
+MusicDatabase(const std::string &filename)
+:   MusicDatabase(filename, MusicDatabaseOptions{})
+{
+}
+
+MusicDatabase::
+MusicDatabase(const std::string &filename,
+              const MusicDatabaseOptions &options)
+:   mDatabaseFilename(filename)
 {
     try
     {
         ies::Time::ScopeTimePrinter<std::chrono::milliseconds> timePrinter{"Load music database"};
         auto begin = ies::Time::Now();
 
-        {
-            const std::string usingDbFilename{"table/usingDB.txt"};
-            std::ifstream usingDbFile{usingDbFilename};
-            if (usingDbFile)
-            {
-                std::string userDb;
-                usingDbFile >> userDb;
-                auto userDbPath = "table/"+userDb;
-                if (!fs::exists(userDbPath)||!fs::is_regular_file(userDbPath))
-                {
-                    std::cout << "Not exist user music DB [" << userDbPath << "], use default instead.\n";
-                }
-                else
-                {
-                    mDatabaseFilename = userDbPath;
-                }
-            }
-        }
-
         std::cout << "Loading music table from " << mDatabaseFilename << "\n";
-        std::ifstream databaseFile{mDatabaseFilename};
-        if (!databaseFile)
+        if (!fs::exists(mDatabaseFilename)||!fs::is_regular_file(mDatabaseFilename))
         {
             throw std::runtime_error("cannot find music table: "+mDatabaseFilename);
         }
-        databaseFile >> mDatabase;
-        ies::Time::Print<std::chrono::milliseconds>(ies::Time::CountNs(begin), "Read Json");
 
-        auto versionCount = VersionNames.size();
-        mAllTimeMusics.resize(versionCount);
-        mTitleMusicIndexByVersion.resize(versionCount);
+        MappedFile databaseFile{mDatabaseFilename};
+        auto sourceHash = ToFnv1aHash(databaseFile.GetView());
+        mSourceHash = sourceHash;
+        auto snapshotFilename = fs::path{mDatabaseFilename}.replace_extension(SnapshotExtension).string();
 
-        auto &dbAllTimeMusics = mDatabase.at("version");
-        for (auto versionIndex : IndexRange{0, versionCount})
+        if (options.UseSnapshot&&LoadSnapshot(snapshotFilename, sourceHash, options.LazyMaterialize))
         {
-            auto version = ToVersionString(versionIndex);
-            auto &dbVersionMusics = dbAllTimeMusics.at(version);
-
-            auto &verMusicTable = mAllTimeMusics[versionIndex];
-            verMusicTable.reserve(dbVersionMusics.size());
-
-            auto &musicIndexMap = mTitleMusicIndexByVersion[versionIndex];
-
-            std::size_t musicIndex = 0;
-            for (auto &item : dbVersionMusics.items())
-            {
-                auto& title = item.value();
-                auto musicId = ToMusicId(versionIndex, musicIndex);
-                verMusicTable.emplace_back(musicId, title);
-                auto& music = verMusicTable.back();
-
-                auto* findDbMusic = FindDbMusic(versionIndex, title);
-                if (!findDbMusic)
-                {
-                    std::cout << "version ["+ToVersionString(versionIndex)+"] title ["+std::string{title}+"].\n";
-                    throw std::runtime_error("cannot find music in main table and cs table.");
-                }
-
-                auto& dbMusic = *findDbMusic;
-
-                music.SetMusicInfoField(MusicInfoField::Genre, dbMusic["info"]["genre"]["latest"]);
-                music.SetMusicInfoField(MusicInfoField::Artist, dbMusic["info"]["artist"]["latest"]);
-                if (ies::Find(dbMusic["info"], "displayTitle"))
-                {
-                    music.SetMusicInfoField(MusicInfoField::DisplayTitle, dbMusic["info"]["displayTitle"]);
-                }
-
-                for (auto &[styleDiffStr, diffInfo] : dbMusic.at("difficulty").items())
-                {
-                    auto styleDifficulty = ToStyleDifficulty(styleDiffStr);
-
-                    std::map<std::string, ChartInfo> chartInfoByChartVersions;
-                    for (auto &[chartVersions, dbChartInfo] : diffInfo.items())
-                    {
-                        const int level = dbChartInfo["level"];
-                        const int note = dbChartInfo["note"];
-                        chartInfoByChartVersions.emplace(chartVersions, ChartInfo{level, note});
-                    }
-
-                    music.AddAvailability(styleDifficulty, chartInfoByChartVersions);
-                }
-
-                if (versionIndex==0||versionIndex==1)
-                {
-                    m1stSubVersionIndexMap[title] = versionIndex;
-                }
-                musicIndexMap[title] = musicIndex;
-                ++musicIndex;
-            }
+            ies::Time::Print<std::chrono::milliseconds>(ies::Time::CountNs(begin), "Load snapshot");
+            return;
         }
 
-        const std::string countString = mDatabase.at("#meta").at("count");
-        auto count = std::stoull(countString);
-        auto latestVersionIndex = count/1000;
-        auto latestVersionCount = count%1000;
-
-        if (latestVersionIndex>=versionCount)
+        //'' read Json by SAX into typed content, Json DOM is never built.
+        auto memoryBeforeLoad = GetProcessMemoryUsage();
         {
-            std::cout << "DB ID [" << countString
-                      << "] cannot find latest version " << ToVersionString(latestVersionIndex)
-                      << " musics.\n";
-        }
+            auto content = ReadMusicDatabaseJson(databaseFile.GetView());
+            ies::Time::Print<std::chrono::milliseconds>(ies::Time::CountNs(begin), "Read Json");
 
-        auto &latestMusics = mAllTimeMusics[latestVersionIndex];
-        if (latestVersionCount!=latestMusics.size())
-        {
-            std::cout << "DB ID [" << countString
-                      << "] latest version " << ToVersionString(latestVersionIndex)
-                      << " musics count " << latestMusics.size()
-                      << " is not same as ID.\n";
+            BuildFromJsonContent(content, options.BuildThreadCount);
         }
+        std::cout << "Music database process memory: before load [" << ToMemoryString(memoryBeforeLoad)
+                  << "], after load [" << ToMemoryString(GetProcessMemoryUsage()) << "].\n";
 
+        if (options.UseSnapshot)
         {
-            ies::Time::ScopeTimePrinter<std::chrono::milliseconds> timePrinter{"GenerateActiveVersions"};
-            GenerateActiveVersions(GetFirstSupportDateTimeVersionIndex());
+            try
+            {
+                WriteSnapshot(snapshotFilename, sourceHash);
+            }
+            catch (const std::exception &e)
+            {
+                std::cout << "Cannot write music database snapshot [" << snapshotFilename << "]: " << e.what() << "\n";
+            }
         }
     }
     catch (const std::exception &e)
@@ -171,11 +165,23 @@ const
     return mDatabaseFilename;
 }
 
+std::uint64_t
+MusicDatabase::
+GetSourceHash()
+const
+{
+    return mSourceHash;
+}
+
 const std::vector<std::vector<Music>> &
 MusicDatabase::
 GetAllTimeMusics()
 const
 {
+    for (auto versionIndex : IndexRange{0, mAllTimeMusics.size()})
+    {
+        MaterializeVersion(versionIndex);
+    }
     return mAllTimeMusics;
 }
 
@@ -190,6 +196,8 @@ const
         throw std::runtime_error("versionIndex out of range in musicId.");
     }
 
+    MaterializeVersion(versionIndex);
+
     auto musicIndex = musicId%1000;
     auto &versionMusics = mAllTimeMusics[versionIndex];
     if (musicIndex>=versionMusics.size())
@@ -210,7 +218,7 @@ const
 
 std::optional<std::size_t>
 MusicDatabase::
-FindMusicId(std::size_t versionIndex, const std::string &dbTitle)
+FindMusicId(std::size_t versionIndex, std::string_view dbTitle)
 const
 {
     if (versionIndex>=mTitleMusicIndexByVersion.size())
@@ -226,18 +234,44 @@ const
     return std::nullopt;
 }
 
+std::optional<std::size_t>
+MusicDatabase::
+FindMusicId(const MusicDatabase &sourceDatabase, std::size_t sourceMusicId)
+const
+{
+    if (&sourceDatabase==this)
+    {
+        return sourceMusicId;
+    }
+
+    auto versionIndex = ToIndexes(sourceMusicId).first;
+    if (versionIndex>=mTitleMusicIndexByVersion.size())
+    {
+        return std::nullopt;
+    }
+
+    auto &title = sourceDatabase.GetTitle(sourceMusicId);
+    if (auto findMusicId = FindMusicId(versionIndex, title))
+    {
+        return findMusicId;
+    }
+
+    if (auto* mapping = FindTitleMapping(title))
+    {
+        return FindMusicId(versionIndex, mapping->DbTitle);
+    }
+
+    return std::nullopt;
+}
+
 std::optional<std::string>
 MusicDatabase::
-FindDbTitle(const std::string &title)
+FindDbTitle(std::string_view title)
 const
 {
-    for (auto &section : {"csv", "display", "wiki"})
+    if (auto* mapping = FindTitleMapping(title))
     {
-        auto it = mDatabase["titleMapping"][section].find(title);
-        if (it!=mDatabase["titleMapping"][section].cend())
-        {
-            return {it.value()};
-        }
+        return mapping->DbTitle;
     }
 
     return std::nullopt;
@@ -245,14 +279,14 @@ const
 
 std::optional<std::string>
 MusicDatabase::
-FindCsvDbTitle(const std::string &title)
+FindCsvDbTitle(std::string_view title)
 const
 {
-    auto &csvMapping = mDatabase["titleMapping"]["csv"];
-    auto it = csvMapping.find(title);
-    if (it!=csvMapping.cend())
+    //'' csv has highest priority, title mapped in csv always find csv mapping.
+    auto* mapping = FindTitleMapping(title);
+    if (mapping&&mapping->Section==TitleMappingSection::csv)
     {
-        return {it.value()};
+        return mapping->DbTitle;
     }
 
     return std::nullopt;
@@ -260,24 +294,36 @@ const
 
 std::optional<std::string>
 MusicDatabase::
-FindDbTitleMappingSection(const std::string &title)
+FindDbTitleMappingSection(std::string_view title)
 const
 {
-    for (auto &section : {"csv", "display", "wiki"})
+    if (auto* mapping = FindTitleMapping(title))
     {
-        auto it = mDatabase["titleMapping"][section].find(title);
-        if (it!=mDatabase["titleMapping"][section].cend())
-        {
-            return section;
-        }
+        return ToString(mapping->Section);
     }
 
     return std::nullopt;
 }
 
+const TitleMapping*
+MusicDatabase::
+FindTitleMapping(std::string_view title)
+const
+{
+    return mTitleMappingIndex.Find(title);
+}
+
+std::optional<std::size_t>
+MusicDatabase::
+FindCsvMusicId(std::size_t csvVersionIndex, std::string_view csvTitle)
+const
+{
+    return mCsvMusicIdIndex.Find(csvVersionIndex, csvTitle);
+}
+
 std::optional<std::size_t>
 MusicDatabase::
-Find1stSubVersionIndex(const std::string &dbTitle)
+Find1stSubVersionIndex(std::string_view dbTitle)
 const
 {
     auto find1stSubMusicVersionIndex = ies::Find(m1stSubVersionIndexMap, dbTitle);
@@ -329,38 +375,13 @@ IsCsMusic(std::size_t musicId)
 const
 {
     auto versionIndex = musicId/1000;
-    auto &title = GetTitle(musicId);
-
-    auto version = ToVersionString(versionIndex);
-    auto findVersion = ies::Find(mDatabase["csMusicTable"], version);
-    if (!findVersion)
+    auto musicIndex = musicId%1000;
+    if (versionIndex>=mCsMusicFlags.size()||musicIndex>=mCsMusicFlags[versionIndex].size())
     {
         return false;
     }
 
-    auto findMusic = ies::Find(findVersion.value().value(), title);
-    return findMusic.has_value();
-}
-
-const Json*
-MusicDatabase::
-FindDbMusic(std::size_t versionIndex, const std::string &title)
-const
-{
-    auto version = ToVersionString(versionIndex);
-    auto findMusic = ies::Find(mDatabase["musicTable"][version], title);
-    if (findMusic)
-    {
-        return &(findMusic.value().value());
-    }
-
-    auto findCsMusic = ies::Find(mDatabase["csMusicTable"][version], title);
-    if (findCsMusic)
-    {
-        return &(findCsMusic.value().value());
-    }
-
-    return nullptr;
+    return mCsMusicFlags[versionIndex][musicIndex];
 }
 
 const std::map<std::size_t, ActiveVersion> &
@@ -382,7 +403,7 @@ const
     return &(findActiveVersion.value()->second);
 }
 
-const ChartInfo*
+std::optional<ChartInfo>
 MusicDatabase::
 FindChartInfo(std::size_t musicId,
               StyleDifficulty styleDifficulty,
@@ -390,15 +411,15 @@ FindChartInfo(std::size_t musicId,
 const
 {
     auto &music = GetMusic(musicId);
-    auto &availability = music.GetChartAvailability(styleDifficulty, availableVersionIndex);
+    auto availability = music.GetChartAvailability(styleDifficulty, availableVersionIndex);
 
     switch (availability.ChartAvailableStatus)
     {
         case ChartStatus::BeginAvailable:
         case ChartStatus::Available:
-            return &availability.ChartInfoProp;
+            return availability.ChartInfoProp;
         default:
-            return nullptr;
+            return std::nullopt;
     }
 }
 
@@ -410,42 +431,41 @@ FindContainingAvailableVersionRange(std::size_t musicId,
 const
 {
     auto &music = GetMusic(musicId);
-    auto &availability = music.GetChartAvailability(styleDifficulty, containingVersionIndex);
+    return music.GetChartAvailabilityTable().FindContainingAvailableVersionRange(music.GetChartRow(styleDifficulty),
+                                                                                containingVersionIndex);
+}
 
-    if (availability.ChartAvailableStatus==ChartStatus::NotAvailable
-        ||availability.ChartAvailableStatus==ChartStatus::Removed)
+const ChartAvailabilityTable &
+MusicDatabase::
+GetChartAvailabilityTable()
+const
+{
+    for (auto versionIndex : IndexRange{0, mAllTimeMusics.size()})
     {
-        return std::nullopt;
+        MaterializeVersion(versionIndex);
     }
+    return *mChartAvailabilityTable;
+}
 
-    auto beginContainingVerIndex = containingVersionIndex;
-    auto endContainingVerIndex = containingVersionIndex+1;
-
-    if (availability.ChartAvailableStatus==ChartStatus::Available)
+std::size_t
+MusicDatabase::
+GetChartRow(std::size_t musicId, StyleDifficulty styleDifficulty)
+const
+{
+    auto versionIndex = musicId/1000;
+    if (versionIndex+1>=mVersionChartRowBegins.size())
     {
-        for (auto i : ReverseIndexRange{0, containingVersionIndex})
-        {
-            if (music.GetChartAvailability(styleDifficulty, i).ChartAvailableStatus==ChartStatus::BeginAvailable)
-            {
-                beginContainingVerIndex = i;
-                break;
-            }
-        }
+        throw std::runtime_error("versionIndex out of range in musicId.");
     }
 
-    if (containingVersionIndex!=GetLatestVersionIndex())
+    auto chartRowBegin = mVersionChartRowBegins[versionIndex];
+    auto chartRow = chartRowBegin+(musicId%1000)*StyleDifficultySmartEnum::Size();
+    if (chartRow>=mVersionChartRowBegins[versionIndex+1])
     {
-        for (auto i : IndexRange{containingVersionIndex+1, VersionNames.size()})
-        {
-            if (music.GetChartAvailability(styleDifficulty, i).ChartAvailableStatus==ChartStatus::Removed)
-            {
-                endContainingVerIndex = i;
-                break;
-            }
-        }
+        throw std::runtime_error("musicIndex out of range in musicId.");
     }
 
-    return IndexRange{beginContainingVerIndex, endContainingVerIndex};
+    return chartRow+static_cast<std::size_t>(styleDifficulty);
 }
 
 /*
@@ -471,7 +491,18 @@ const
 
     IntRange levelRange{1, MaxLevel+1};
 
-    auto &musicTable = mDatabase["musicTable"];
+    //'' Json DOM is released after construction, reload it for check.
+    Json database;
+    {
+        std::ifstream databaseFile{mDatabaseFilename};
+        if (!databaseFile)
+        {
+            throw std::runtime_error("cannot find music table: "+mDatabaseFilename);
+        }
+        databaseFile >> database;
+    }
+
+    auto &musicTable = database["musicTable"];
     for (auto &[version, versionMusics] : musicTable.items())
     {
         for (auto &[title, titleData] : versionMusics.items())
@@ -690,34 +721,703 @@ const
 
 void
 MusicDatabase::
-GenerateActiveVersions(std::size_t beginVersionIndex)
+GenerateActiveVersions(std::size_t beginVersionIndex,
+                       std::size_t buildThreadCount)
 {
     mActiveVersions.clear();
+    std::vector<ActiveVersion*> activeVersions;
     for (auto versionIndex : IndexRange{beginVersionIndex, VersionNames.size()})
     {
-        mActiveVersions.emplace(versionIndex, versionIndex);
+        activeVersions.emplace_back(&mActiveVersions.emplace(versionIndex, versionIndex).first->second);
     }
 
-    for (auto versionIndex : IndexRange{0, mAllTimeMusics.size()})
+    //'' each active version only reads table and writes itself.
+    //'' chart rows are ordered by music id, scan status column of active version sequentially.
+    auto &table = *mChartAvailabilityTable;
+    ParallelFor(activeVersions.size(), buildThreadCount, [&](std::size_t i)
     {
-        const auto &versionMusics = mAllTimeMusics[versionIndex];
-        for (auto musicIndex : IndexRange{0, versionMusics.size()})
+        auto &activeVersion = *activeVersions[i];
+        auto activeVersionIndex = activeVersion.GetVersionIndex();
+        auto statuses = table.GetStatusColumn(activeVersionIndex);
+        for (auto versionIndex : IndexRange{0, mAllTimeMusics.size()})
         {
-            auto &music = versionMusics[musicIndex];
-
-            for (auto &[activeVersionIndex, activeVersion] : mActiveVersions)
+            auto chartRow = mVersionChartRowBegins[versionIndex];
+            for (auto musicIndex : IndexRange{0, mAllTimeMusics[versionIndex].size()})
             {
                 for (auto styleDifficulty : StyleDifficultySmartEnum::ToRange())
                 {
-                    auto &availability = music.GetChartAvailability(styleDifficulty, activeVersionIndex);
-                    if (availability.ChartAvailableStatus==ChartStatus::BeginAvailable
-                        ||availability.ChartAvailableStatus==ChartStatus::Available)
+                    auto status = static_cast<ChartStatus>(statuses[chartRow]);
+                    if (status==ChartStatus::BeginAvailable||status==ChartStatus::Available)
                     {
-                        activeVersion.AddDifficulty(music.GetMusicId(), styleDifficulty, availability.ChartInfoProp);
+                        activeVersion.AddDifficulty(ToMusicId(versionIndex, musicIndex),
+                                                    styleDifficulty,
+                                                    table.GetChartInfo(chartRow, activeVersionIndex));
                     }
+                    ++chartRow;
                 }
             }
         }
+    });
+}
+
+void
+MusicDatabase::
+BuildFromJsonContent(MusicDatabaseJsonContent &content,
+                     std::size_t buildThreadCount)
+{
+    auto versionCount = VersionNames.size();
+    mAllTimeMusics.resize(versionCount);
+    mTitleMusicIndexByVersion.resize(versionCount);
+    mCsMusicFlags.resize(versionCount);
+
+    std::vector<std::size_t> versionMusicCounts(versionCount, 0);
+    for (auto versionIndex : IndexRange{0, versionCount})
+    {
+        if (auto findVersionTitles = ies::Find(content.VersionTitles, ToVersionString(versionIndex)))
+        {
+            versionMusicCounts[versionIndex] = findVersionTitles.value()->second.size();
+        }
+    }
+    AllocateChartAvailabilityTable(versionMusicCounts);
+
+    {
+        ies::Time::ScopeTimePrinter<std::chrono::milliseconds> timePrinter{"BuildVersionMusics"};
+        ParallelFor(versionCount, buildThreadCount, [&](std::size_t versionIndex)
+        {
+            BuildVersionMusics(versionIndex, content);
+        });
+    }
+
+    //'' 1st and substream share combined version name, substream title overrides same 1st title.
+    for (auto versionIndex : IndexRange{0, 2})
+    {
+        for (auto &music : mAllTimeMusics[versionIndex])
+        {
+            m1stSubVersionIndexMap[music.GetMusicInfo().GetField(MusicInfoField::Title)] = versionIndex;
+        }
+    }
+
+    mTitleMappingIndex = TitleMappingIndex{std::move(content.TitleMappings)};
+    BuildCsvMusicIdIndex();
+
+    const auto &countString = content.MetaCount;
+    if (countString.empty())
+    {
+        throw std::runtime_error("cannot find #meta count in DB.");
+    }
+    auto count = std::stoull(countString);
+    auto latestVersionIndex = count/1000;
+    auto latestVersionCount = count%1000;
+
+    if (latestVersionIndex>=versionCount)
+    {
+        std::cout << "DB ID [" << countString
+                  << "] cannot find latest version " << ToVersionString(latestVersionIndex)
+                  << " musics.\n";
+    }
+
+    auto &latestMusics = mAllTimeMusics[latestVersionIndex];
+    if (latestVersionCount!=latestMusics.size())
+    {
+        std::cout << "DB ID [" << countString
+                  << "] latest version " << ToVersionString(latestVersionIndex)
+                  << " musics count " << latestMusics.size()
+                  << " is not same as ID.\n";
+    }
+
+    {
+        ies::Time::ScopeTimePrinter<std::chrono::milliseconds> timePrinter{"GenerateActiveVersions"};
+        GenerateActiveVersions(GetFirstSupportDateTimeVersionIndex(), buildThreadCount);
+    }
+}
+
+void
+MusicDatabase::
+AllocateChartAvailabilityTable(const std::vector<std::size_t> &versionMusicCounts)
+{
+    mVersionChartRowBegins.assign(1, 0);
+    for (auto musicCount : versionMusicCounts)
+    {
+        mVersionChartRowBegins.emplace_back(mVersionChartRowBegins.back()+musicCount*StyleDifficultySmartEnum::Size());
+    }
+
+    mChartAvailabilityTable = std::make_unique<ChartAvailabilityTable>(mVersionChartRowBegins.back(), VersionNames.size());
+}
+
+void
+MusicDatabase::
+BuildVersionMusics(std::size_t versionIndex,
+                   const MusicDatabaseJsonContent &content)
+{
+    auto version = ToVersionString(versionIndex);
+    auto findVersionTitles = ies::Find(content.VersionTitles, version);
+    if (!findVersionTitles)
+    {
+        throw std::runtime_error("cannot find version ["+version+"] in DB version.");
+    }
+    auto &versionTitles = findVersionTitles.value()->second;
+
+    auto &verMusicTable = mAllTimeMusics[versionIndex];
+    verMusicTable.reserve(versionTitles.size());
+
+    auto &musicIndexMap = mTitleMusicIndexByVersion[versionIndex];
+    auto &csMusicFlags = mCsMusicFlags[versionIndex];
+    csMusicFlags.assign(versionTitles.size(), false);
+
+    auto* versionMusicTable = FindVersionMusicTable(content.MusicTable, version);
+    auto* versionCsMusicTable = FindVersionMusicTable(content.CsMusicTable, version);
+
+    for (auto musicIndex : IndexRange{0, versionTitles.size()})
+    {
+        auto &title = versionTitles[musicIndex];
+        auto musicId = ToMusicId(versionIndex, musicIndex);
+        //'' music's chart rows begin at row of first style difficulty.
+        verMusicTable.emplace_back(musicId, title, *mChartAvailabilityTable, GetChartRow(musicId, StyleDifficulty::SPB));
+        auto& music = verMusicTable.back();
+
+        //'' same title in musicTable has priority over csMusicTable.
+        const DbMusicContent* dbMusic = nullptr;
+        for (auto* table : {versionMusicTable, versionCsMusicTable})
+        {
+            if (!table) { continue; }
+            if (auto findDbMusic = ies::Find(*table, title))
+            {
+                dbMusic = &(findDbMusic.value()->second);
+                break;
+            }
+        }
+
+        if (!dbMusic)
+        {
+            throw std::runtime_error("cannot find version ["+version+"] title ["+title+"] in main table and cs table.");
+        }
+
+        music.SetMusicInfoField(MusicInfoField::Genre, dbMusic->Genre);
+        music.SetMusicInfoField(MusicInfoField::Artist, dbMusic->Artist);
+        if (!dbMusic->DisplayTitle.empty())
+        {
+            music.SetMusicInfoField(MusicInfoField::DisplayTitle, dbMusic->DisplayTitle);
+        }
+
+        for (auto styleDifficulty : StyleDifficultySmartEnum::ToRange())
+        {
+            auto &chartInfoByChartVersions = dbMusic->ChartInfoByChartVersions[static_cast<std::size_t>(styleDifficulty)];
+            if (!chartInfoByChartVersions.empty())
+            {
+                music.AddAvailability(styleDifficulty, chartInfoByChartVersions);
+            }
+        }
+
+        if (versionCsMusicTable&&versionCsMusicTable->contains(title))
+        {
+            csMusicFlags[musicIndex] = true;
+        }
+
+        musicIndexMap[title] = musicIndex;
+    }
+}
+
+bool
+MusicDatabase::
+LoadSnapshot(const std::string &snapshotFilename,
+             std::uint64_t sourceHash,
+             bool lazyMaterialize)
+{
+    if (!fs::exists(snapshotFilename)||!fs::is_regular_file(snapshotFilename))
+    {
+        return false;
+    }
+
+    try
+    {
+        auto snapshotFile = std::make_unique<MappedFile>(snapshotFilename);
+        BinaryReader reader{snapshotFile->GetView()};
+
+        if (reader.ReadString()!=SnapshotMagic
+            ||reader.Read<std::uint32_t>()!=SnapshotFormatVersion
+            ||reader.Read<std::uint64_t>()!=sourceHash)
+        {
+            return false;
+        }
+
+        auto versionCount = VersionNames.size();
+        if (reader.Read<std::uint32_t>()!=versionCount
+            ||reader.Read<std::uint32_t>()!=StyleDifficultySmartEnum::Size())
+        {
+            return false;
+        }
+
+        std::vector<TitleMapping> titleMappings(reader.Read<std::uint32_t>());
+        for (auto &titleMapping : titleMappings)
+        {
+            titleMapping.Title = reader.ReadString();
+            titleMapping.DbTitle = reader.ReadString();
+            titleMapping.Section = static_cast<TitleMappingSection>(reader.Read<std::uint8_t>());
+        }
+        mTitleMappingIndex = TitleMappingIndex{std::move(titleMappings)};
+
+        std::vector<std::uint64_t> csMusicIds(reader.Read<std::uint32_t>());
+        for (auto &musicId : csMusicIds)
+        {
+            musicId = reader.Read<std::uint64_t>();
+        }
+
+        mAllTimeMusics.resize(versionCount);
+        mTitleMusicIndexByVersion.resize(versionCount);
+        mCsMusicFlags.resize(versionCount);
+        mVersionSnapshotBlocks.resize(versionCount);
+        std::vector<std::size_t> versionMusicCounts(versionCount);
+        for (auto versionIndex : IndexRange{0, versionCount})
+        {
+            auto versionBlock = reader.ReadString();
+            IndexVersionTitles(versionIndex, versionBlock);
+            mVersionSnapshotBlocks[versionIndex] = versionBlock;
+            versionMusicCounts[versionIndex] = mCsMusicFlags[versionIndex].size();
+        }
+        AllocateChartAvailabilityTable(versionMusicCounts);
+        BuildCsvMusicIdIndex();
+
+        for (auto musicId : csMusicIds)
+        {
+            auto versionIndex = musicId/1000;
+            auto musicIndex = musicId%1000;
+            if (versionIndex>=versionCount||musicIndex>=mCsMusicFlags[versionIndex].size())
+            {
+                throw std::runtime_error("CS musicId out of range.");
+            }
+            mCsMusicFlags[versionIndex][musicIndex] = true;
+        }
+
+        //'' active version charts record chart info, no need to restore musics.
+        auto activeVersionCount = reader.Read<std::uint32_t>();
+        for (std::uint32_t i = 0; i<activeVersionCount; ++i)
+        {
+            auto activeVersionIndex = reader.Read<std::uint32_t>();
+            auto &activeVersion = mActiveVersions.emplace(activeVersionIndex, activeVersionIndex).first->second;
+            auto chartCount = reader.Read<std::uint32_t>();
+            for (std::uint32_t chartIndex = 0; chartIndex<chartCount; ++chartIndex)
+            {
+                auto musicId = reader.Read<std::uint64_t>();
+                auto styleDifficulty = static_cast<StyleDifficulty>(reader.Read<std::uint8_t>());
+                auto level = reader.Read<std::int32_t>();
+                auto note = reader.Read<std::int32_t>();
+
+                auto versionIndex = musicId/1000;
+                if (versionIndex>=versionCount||musicId%1000>=mCsMusicFlags[versionIndex].size())
+                {
+                    throw std::runtime_error("active version musicId out of range.");
+                }
+                activeVersion.AddDifficulty(musicId, styleDifficulty, ChartInfo{level, note});
+            }
+        }
+
+        if (reader.GetRemainSize()!=0)
+        {
+            throw std::runtime_error("trailing bytes.");
+        }
+
+        if (lazyMaterialize)
+        {
+            mVersionMaterializedFlags = std::vector<std::once_flag>(versionCount);
+            mLazySnapshotFile = std::move(snapshotFile);
+        }
+        else
+        {
+            for (auto versionIndex : IndexRange{0, versionCount})
+            {
+                RestoreVersionMusics(versionIndex, mVersionSnapshotBlocks[versionIndex]);
+            }
+            mVersionSnapshotBlocks.clear();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Discard invalid music database snapshot [" << snapshotFilename << "]: " << e.what() << "\n";
+        mTitleMappingIndex = {};
+        mCsvMusicIdIndex = {};
+        mCsMusicFlags.clear();
+        mAllTimeMusics.clear();
+        m1stSubVersionIndexMap.clear();
+        mTitleMusicIndexByVersion.clear();
+        mActiveVersions.clear();
+        mVersionSnapshotBlocks.clear();
+        mChartAvailabilityTable.reset();
+        mVersionChartRowBegins.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void
+MusicDatabase::
+IndexVersionTitles(std::size_t versionIndex,
+                   std::string_view versionBlock)
+{
+    BinaryReader reader{versionBlock};
+    auto musicCount = reader.Read<std::uint32_t>();
+    auto &musicIndexMap = mTitleMusicIndexByVersion[versionIndex];
+    musicIndexMap.reserve(musicCount);
+    mCsMusicFlags[versionIndex].assign(musicCount, false);
+
+    for (auto musicIndex : IndexRange{0, musicCount})
+    {
+        std::string title{reader.ReadString()};
+        if (versionIndex==0||versionIndex==1)
+        {
+            m1stSubVersionIndexMap[title] = versionIndex;
+        }
+        musicIndexMap.emplace(std::move(title), musicIndex);
+    }
+}
+
+void
+MusicDatabase::
+BuildCsvMusicIdIndex()
+{
+    std::vector<CsvMusicIdEntry> entries;
+    auto addEntries = [&](std::size_t versionIndex, const std::string &csvTitle, std::string_view dbTitle)
+    {
+        if (auto findMusicIndex = ies::Find(mTitleMusicIndexByVersion[versionIndex], dbTitle))
+        {
+            //'' 1st and substream share CSV version '1st&substream', substream is added later and overrides same 1st title.
+            auto csvVersionIndex = versionIndex<2 ? 1 : versionIndex;
+            entries.push_back({csvVersionIndex, csvTitle, ToMusicId(versionIndex, findMusicIndex.value()->second)});
+        }
+    };
+
+    //'' CSV title mapped in csv section is always looked up by its DbTitle, never by itself.
+    for (auto versionIndex : IndexRange{0, mTitleMusicIndexByVersion.size()})
+    {
+        for (auto &[dbTitle, musicIndex] : mTitleMusicIndexByVersion[versionIndex])
+        {
+            (void)musicIndex;
+            auto* mapping = FindTitleMapping(dbTitle);
+            if (!mapping||mapping->Section!=TitleMappingSection::csv)
+            {
+                addEntries(versionIndex, dbTitle, dbTitle);
+            }
+        }
+    }
+
+    for (auto &mapping : mTitleMappingIndex.GetMappings())
+    {
+        if (mapping.Section!=TitleMappingSection::csv) { continue; }
+        for (auto versionIndex : IndexRange{0, mTitleMusicIndexByVersion.size()})
+        {
+            addEntries(versionIndex, mapping.Title, mapping.DbTitle);
+        }
+    }
+
+    mCsvMusicIdIndex = CsvMusicIdIndex{std::move(entries)};
+}
+
+void
+MusicDatabase::
+RestoreVersionMusics(std::size_t versionIndex,
+                     std::string_view versionBlock)
+const
+{
+    auto versionCount = VersionNames.size();
+    BinaryReader reader{versionBlock};
+    auto musicCount = reader.Read<std::uint32_t>();
+
+    std::vector<std::string_view> titles(musicCount);
+    for (auto &title : titles)
+    {
+        title = reader.ReadString();
+    }
+
+    auto &verMusicTable = mAllTimeMusics[versionIndex];
+    verMusicTable.reserve(musicCount);
+    std::vector<ChartAvailability> availabilities(versionCount);
+    for (auto musicIndex : IndexRange{0, musicCount})
+    {
+        auto musicId = ToMusicId(versionIndex, musicIndex);
+        auto& music = verMusicTable.emplace_back(musicId,
+                                                 std::string{titles[musicIndex]},
+                                                 *mChartAvailabilityTable,
+                                                 GetChartRow(musicId, StyleDifficulty::SPB));
+        for (auto field : {MusicInfoField::Genre, MusicInfoField::Artist, MusicInfoField::DisplayTitle})
+        {
+            music.SetMusicInfoField(field, std::string{reader.ReadString()});
+        }
+
+        for (auto styleDifficulty : StyleDifficultySmartEnum::ToRange())
+        {
+            std::vector<int> chartNotes(reader.Read<std::uint32_t>());
+            for (auto &note : chartNotes)
+            {
+                note = reader.Read<std::int32_t>();
+            }
+
+            for (auto &availability : availabilities)
+            {
+                availability.ChartAvailableStatus = static_cast<ChartStatus>(reader.Read<std::uint8_t>());
+                availability.ChartInfoProp.Level = reader.Read<std::int32_t>();
+                availability.ChartInfoProp.Note = reader.Read<std::int32_t>();
+                availability.ChartIndex = reader.Read<std::uint32_t>();
+            }
+
+            music.RestoreAvailability(styleDifficulty, availabilities, std::move(chartNotes));
+        }
+    }
+
+    if (reader.GetRemainSize()!=0)
+    {
+        throw std::runtime_error("version "+ToVersionString(versionIndex)+" snapshot block has trailing bytes.");
+    }
+}
+
+void
+MusicDatabase::
+MaterializeVersion(std::size_t versionIndex)
+const
+{
+    if (!mLazySnapshotFile) { return; }
+
+    std::call_once(mVersionMaterializedFlags[versionIndex], [&]()
+    {
+        try
+        {
+            RestoreVersionMusics(versionIndex, mVersionSnapshotBlocks[versionIndex]);
+        }
+        catch (...)
+        {
+            //'' flag stays unset on exception, clear partial musics for next attempt.
+            mAllTimeMusics[versionIndex].clear();
+            throw;
+        }
+    });
+}
+
+void
+MusicDatabase::
+WriteSnapshot(const std::string &snapshotFilename,
+              std::uint64_t sourceHash)
+const
+{
+    BinaryWriter writer;
+    writer.WriteString(SnapshotMagic);
+    writer.Write(SnapshotFormatVersion);
+    writer.Write(sourceHash);
+    writer.Write(static_cast<std::uint32_t>(VersionNames.size()));
+    writer.Write(static_cast<std::uint32_t>(StyleDifficultySmartEnum::Size()));
+
+    auto &titleMappings = mTitleMappingIndex.GetMappings();
+    writer.Write(static_cast<std::uint32_t>(titleMappings.size()));
+    for (auto &titleMapping : titleMappings)
+    {
+        writer.WriteString(titleMapping.Title);
+        writer.WriteString(titleMapping.DbTitle);
+        writer.Write(static_cast<std::uint8_t>(titleMapping.Section));
+    }
+
+    std::vector<std::uint64_t> csMusicIds;
+    for (auto versionIndex : IndexRange{0, mCsMusicFlags.size()})
+    {
+        auto &csMusicFlags = mCsMusicFlags[versionIndex];
+        for (auto musicIndex : IndexRange{0, csMusicFlags.size()})
+        {
+            if (csMusicFlags[musicIndex])
+            {
+                csMusicIds.emplace_back(ToMusicId(versionIndex, musicIndex));
+            }
+        }
+    }
+    writer.Write(static_cast<std::uint32_t>(csMusicIds.size()));
+    for (auto musicId : csMusicIds)
+    {
+        writer.Write(musicId);
+    }
+
+    //'' each version is a length-prefixed block of {titles, musics}, lazy loading skips it after indexing titles.
+    for (auto &verMusicTable : mAllTimeMusics)
+    {
+        BinaryWriter versionWriter;
+        versionWriter.Write(static_cast<std::uint32_t>(verMusicTable.size()));
+        for (auto &music : verMusicTable)
+        {
+            versionWriter.WriteString(music.GetMusicInfo().GetField(MusicInfoField::Title));
+        }
+
+        for (auto &music : verMusicTable)
+        {
+            auto &musicInfo = music.GetMusicInfo();
+            for (auto field : {MusicInfoField::Genre, MusicInfoField::Artist, MusicInfoField::DisplayTitle})
+            {
+                versionWriter.WriteString(musicInfo.GetField(field));
+            }
+
+            for (auto styleDifficulty : StyleDifficultySmartEnum::ToRange())
+            {
+                auto &chartNotes = music.GetChartNotes(styleDifficulty);
+                versionWriter.Write(static_cast<std::uint32_t>(chartNotes.size()));
+                for (auto note : chartNotes)
+                {
+                    versionWriter.Write(static_cast<std::int32_t>(note));
+                }
+
+                for (auto versionIndex : IndexRange{0, VersionNames.size()})
+                {
+                    auto availability = music.GetChartAvailability(styleDifficulty, versionIndex);
+                    versionWriter.Write(static_cast<std::uint8_t>(availability.ChartAvailableStatus));
+                    versionWriter.Write(static_cast<std::int32_t>(availability.ChartInfoProp.Level));
+                    versionWriter.Write(static_cast<std::int32_t>(availability.ChartInfoProp.Note));
+                    versionWriter.Write(static_cast<std::uint32_t>(availability.ChartIndex));
+                }
+            }
+        }
+
+        writer.WriteString(versionWriter.GetBuffer());
+    }
+
+    writer.Write(static_cast<std::uint32_t>(mActiveVersions.size()));
+    for (auto &[activeVersionIndex, activeVersion] : mActiveVersions)
+    {
+        auto &chartIds = activeVersion.GetChartIdList();
+        writer.Write(static_cast<std::uint32_t>(activeVersionIndex));
+        writer.Write(static_cast<std::uint32_t>(chartIds.size()));
+        for (auto chartId : chartIds)
+        {
+            auto [musicId, playStyle, difficulty] = ToMusicStyleDiffculty(chartId);
+            auto styleDifficulty = ConvertToStyleDifficulty(playStyle, difficulty);
+            auto chartInfo = mChartAvailabilityTable->GetChartInfo(GetChartRow(musicId, styleDifficulty), activeVersionIndex);
+            writer.Write(static_cast<std::uint64_t>(musicId));
+            writer.Write(static_cast<std::uint8_t>(styleDifficulty));
+            writer.Write(static_cast<std::int32_t>(chartInfo.Level));
+            writer.Write(static_cast<std::int32_t>(chartInfo.Note));
+        }
+    }
+
+    //'' write to temporary file and rename, avoid other process mapping partially written snapshot.
+    auto temporaryFilename = snapshotFilename+".tmp";
+    {
+        std::ofstream snapshotFile{temporaryFilename, std::ios::binary|std::ios::trunc};
+        if (!snapshotFile)
+        {
+            throw std::runtime_error("cannot create file ["+temporaryFilename+"].");
+        }
+        auto &buffer = writer.GetBuffer();
+        snapshotFile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!snapshotFile)
+        {
+            throw std::runtime_error("cannot write file ["+temporaryFilename+"].");
+        }
+    }
+    fs::rename(temporaryFilename, snapshotFilename);
+}
+
+std::string
+GetUsingMusicDatabaseFilename()
+{
+    const std::string usingDbFilename{"table/usingDB.txt"};
+    std::ifstream usingDbFile{usingDbFilename};
+    if (usingDbFile)
+    {
+        std::string userDb;
+        usingDbFile >> userDb;
+        auto userDbPath = "table/"+userDb;
+        if (!fs::exists(userDbPath)||!fs::is_regular_file(userDbPath))
+        {
+            std::cout << "Not exist user music DB [" << userDbPath << "], use default instead.\n";
+        }
+        else
+        {
+            return userDbPath;
+        }
+    }
+
+    return DefaultMusicDatabaseFilename;
+}
+
+std::shared_ptr<const MusicDatabase>
+GetSharedMusicDatabase(const std::string &filename)
+{
+    auto &cache = GetSharedMusicDatabaseCache();
+
+    std::promise<std::shared_ptr<const MusicDatabase>> loadPromise;
+    std::shared_future<std::shared_ptr<const MusicDatabase>> sharedDatabase;
+    {
+        std::lock_guard lock{cache.Mutex};
+        auto &entry = cache.Databases[filename];
+        if (entry.Loading.valid())
+        {
+            sharedDatabase = entry.Loading;
+        }
+        else if (auto database = entry.Database.lock())
+        {
+            entry.Pinned = database;
+            return database;
+        }
+        else
+        {
+            entry.Loading = loadPromise.get_future().share();
+        }
+    }
+
+    //'' load outside lock, other filenames are not blocked.
+    if (sharedDatabase.valid())
+    {
+        return sharedDatabase.get();
+    }
+
+    try
+    {
+        auto database = std::make_shared<const MusicDatabase>(filename);
+        {
+            std::lock_guard lock{cache.Mutex};
+            auto &entry = cache.Databases[filename];
+            entry.Loading = {};
+            entry.Pinned = database;
+            entry.Database = database;
+        }
+        loadPromise.set_value(database);
+        return database;
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard lock{cache.Mutex};
+            cache.Databases.erase(filename);
+        }
+        loadPromise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+std::shared_ptr<const MusicDatabase>
+GetSharedMusicDatabase()
+{
+    return GetSharedMusicDatabase(GetUsingMusicDatabaseFilename());
+}
+
+std::shared_ptr<const MusicDatabase>
+ReloadSharedMusicDatabase(const std::string &filename)
+{
+    auto database = std::make_shared<const MusicDatabase>(filename);
+
+    auto &cache = GetSharedMusicDatabaseCache();
+    std::lock_guard lock{cache.Mutex};
+    auto &entry = cache.Databases[filename];
+    entry.Pinned = database;
+    entry.Database = database;
+    return database;
+}
+
+void
+ReleaseSharedMusicDatabase(const std::string &filename)
+{
+    auto &cache = GetSharedMusicDatabaseCache();
+    std::lock_guard lock{cache.Mutex};
+    auto findEntry = ies::Find(cache.Databases, filename);
+    if (!findEntry) { return; }
+
+    auto &entry = findEntry.value()->second;
+    entry.Pinned.reset();
+    if (!entry.Loading.valid()&&entry.Database.expired())
+    {
+        cache.Databases.erase(findEntry.value());
     }
 }
 
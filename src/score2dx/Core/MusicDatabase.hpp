@@ -1,30 +1,77 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include "ies/Common/IntegralRange.hxx"
 
 #include "score2dx/Core/ActiveVersion.hpp"
+#include "score2dx/Core/CsvMusicIdIndex.hpp"
 #include "score2dx/Core/JsonDefinition.hpp"
+#include "score2dx/Core/MappedFile.hpp"
+#include "score2dx/Core/MusicDatabaseJsonReader.hpp"
+#include "score2dx/Core/StringViewHash.hxx"
+#include "score2dx/Core/TitleMappingIndex.hpp"
 #include "score2dx/Iidx/Music.hpp"
 
 namespace score2dx
 {
 
+const std::string DefaultMusicDatabaseFilename = "table/MusicDatabase31_2023-11-04.json";
+
+struct MusicDatabaseOptions
+{
+    //! @brief Worker count to build version musics and active versions from Json, 0 = hardware concurrency.
+    //! Built tables are same for any worker count.
+    std::size_t BuildThreadCount{0};
+
+    //! @brief Load from and write to compiled snapshot, disable to always build from Json (e.g. benchmark).
+    bool UseSnapshot{true};
+
+    //! @brief When loading from snapshot, only index titles at construction,
+    //! restore version's Music objects at first access of that version, snapshot is kept mapped until destruction.
+    //! Active versions, title and CS lookups do not touch Music objects.
+    //! @note Building from Json always materializes all versions because snapshot is written from them.
+    bool LazyMaterialize{false};
+};
+
+//! @brief MusicDatabase loads music table from DB Json file.
+//! Built tables are saved to compiled snapshot file next to the Json file (same stem, .s2db extension).
+//! Later loading memory maps snapshot directly if its recorded hash matches Json file content,
+//! otherwise Json is parsed and snapshot is rebuilt.
+//! Json is read by SAX into typed content without building Json DOM, all lookups only use built tables.
+//! @note MusicDatabase is immutable after construction, const access is safe for concurrent readers.
+//! Prefer GetSharedMusicDatabase to share one loaded database among Core, Analyzer and PlayerScore.
 class MusicDatabase
 {
 public:
+    //! @brief Load database of GetUsingMusicDatabaseFilename().
         MusicDatabase();
 
+        explicit MusicDatabase(const std::string &filename);
+
+        MusicDatabase(const std::string &filename,
+                      const MusicDatabaseOptions &options);
+
     //! @brief Get filename created this MusicDatabase.
         const std::string &
         GetFilename()
         const;
 
+    //! @brief Hash of database Json file content, identifies data derived from this database (e.g. CSV cache).
+        std::uint64_t
+        GetSourceHash()
+        const;
+
     //! @brief Vector of {Index=VersionIndex, Vector of {Index=MusicIndex, Music}}.
+    //! @note Materializes all versions in lazy mode.
         const std::vector<std::vector<Music>> &
         GetAllTimeMusics()
         const;
@@ -38,7 +85,15 @@ public:
         const;
 
         std::optional<std::size_t>
-        FindMusicId(std::size_t versionIndex, const std::string &dbTitle)
+        FindMusicId(std::size_t versionIndex, std::string_view dbTitle)
+        const;
+
+    //! @brief Find MusicId in this database of music sourceMusicId in sourceDatabase (e.g. database before reload),
+    //! by its version and title, title mappings are applied. MusicId itself is not stable across databases,
+    //! it depends on music order of version.
+    //! @return nullopt if music is not found, e.g. removed from this database.
+        std::optional<std::size_t>
+        FindMusicId(const MusicDatabase &sourceDatabase, std::size_t sourceMusicId)
         const;
 
     //! @brief Find if title is database title:
@@ -62,22 +117,37 @@ public:
     //!     * Db use half width here.
     //!     * Music changed title (official fix) between versions.
         std::optional<std::string>
-        FindDbTitle(const std::string &title)
+        FindDbTitle(std::string_view title)
         const;
 
     //! @brief Same as FindDbTitle but only for CSV title.
         std::optional<std::string>
-        FindCsvDbTitle(const std::string &title)
+        FindCsvDbTitle(std::string_view title)
         const;
 
         std::optional<std::string>
-        FindDbTitleMappingSection(const std::string &title)
+        FindDbTitleMappingSection(std::string_view title)
+        const;
+
+    //! @brief Find title's mapping (DbTitle and section), same priority as FindDbTitle.
+    //! Prefer this in per row lookup, does not allocate.
+    //! @return nullptr if title is database title.
+        const TitleMapping*
+        FindTitleMapping(std::string_view title)
+        const;
+
+    //! @brief Resolve CSV row version and title columns to MusicId in single lookup,
+    //! csv title mapping and '1st&substream' version are already applied.
+    //! @param csvVersionIndex: CsvMusic::CsvVersionIndex, 1 denotes '1st&substream'.
+    //! @return nullopt if not found, e.g. new music not in database yet.
+        std::optional<std::size_t>
+        FindCsvMusicId(std::size_t csvVersionIndex, std::string_view csvTitle)
         const;
 
     //! @brief Find VersionIndex of dbTitle belong to official combined version '1st&substream'.
     //! @return 0 (1st style) or 1 (substream) or nullopt (not found).
         std::optional<std::size_t>
-        Find1stSubVersionIndex(const std::string &dbTitle)
+        Find1stSubVersionIndex(std::string_view dbTitle)
         const;
 
     //! @brief Find Pair of {VersionIndex, MusicIndex} by versionName, and dbTitle.
@@ -99,11 +169,11 @@ public:
         const;
 
     //! @brief Find music's styleDifficulty ChartInfo if available at availableVersionIndex.
-    //! @return ChartInfo if find, otherwise nullptr if:
+    //! @return ChartInfo if find, otherwise nullopt if:
     //!     1. title is not available at that version.
     //!     2. title has no such style difficulty.
     //!     3. that style difficulty is not available at that version.
-        const ChartInfo*
+        std::optional<ChartInfo>
         FindChartInfo(std::size_t musicId,
                       StyleDifficulty styleDifficulty,
                       std::size_t availableVersionIndex)
@@ -118,6 +188,19 @@ public:
                                             std::size_t containingVersionIndex)
         const;
 
+    //! @brief Dense availability table of all charts in database, Music objects are views of their rows.
+    //! Use for scanning all charts at a version, e.g. GetStatusColumn.
+    //! @note Materializes all versions in lazy mode.
+        const ChartAvailabilityTable &
+        GetChartAvailabilityTable()
+        const;
+
+    //! @brief Get row of music's styleDifficulty in GetChartAvailabilityTable().
+    //! Rows are ordered by {VersionIndex, MusicIndex, StyleDifficulty}.
+        std::size_t
+        GetChartRow(std::size_t musicId, StyleDifficulty styleDifficulty)
+        const;
+
 /*
         ies::IntegralRangeList<std::size_t>
         GetAvailableVersions(std::size_t musicId)
@@ -125,37 +208,138 @@ public:
 */
 
     //! @brief [Debug] Check database validity and print inconsistency.
+    //! @note Reload Json file as DOM since construction does not keep Json.
         void
         CheckValidity()
         const;
 
 private:
-    std::string mDatabaseFilename{"table/MusicDatabase31_2023-11-04.json"};
-    Json mDatabase;
+    std::string mDatabaseFilename;
+    std::uint64_t mSourceHash{0};
+
+    //! @brief Index of {Title, TitleMapping}, see FindDbTitle for sections.
+    TitleMappingIndex mTitleMappingIndex;
+
+    //! @brief Index of {{CsvVersionIndex, CsvTitle}, MusicId}, built from title indexes and csv title mappings.
+    CsvMusicIdIndex mCsvMusicIdIndex;
+
+    //! @brief Vector of {Index=VersionIndex, Vector of {Index=MusicIndex, IsCsMusic}}.
+    //! Music is CS music if listed in csMusicTable.
+    std::vector<std::vector<bool>> mCsMusicFlags;
+
+    //! @brief Availability of all charts, owned by pointer so views in Music stay valid.
+    std::unique_ptr<ChartAvailabilityTable> mChartAvailabilityTable;
+
+    //! @brief Vector of {Index=VersionIndex, First chart row of version}, last element is chart count.
+    std::vector<std::size_t> mVersionChartRowBegins;
 
     //! @brief Vector of {Index=VersionIndex, Vector of {Index=MusicIndex, Music}}.
-    std::vector<std::vector<Music>> mAllTimeMusics;
+    //! @note In lazy mode, version's musics are empty until MaterializeVersion.
+    mutable std::vector<std::vector<Music>> mAllTimeMusics;
+
+    //! @brief Snapshot kept mapped in lazy mode, nullptr if all versions are materialized.
+    std::unique_ptr<MappedFile> mLazySnapshotFile;
+
+    //! @brief Vector of {Index=VersionIndex, Snapshot block of version musics}, views into mLazySnapshotFile.
+    std::vector<std::string_view> mVersionSnapshotBlocks;
+
+    //! @brief Vector of {Index=VersionIndex, Flag of version musics restored from snapshot block}.
+    mutable std::vector<std::once_flag> mVersionMaterializedFlags;
 
     //! @brief Cache all 00 and 01 musics to lookup version index.
     //! Map of {DbTitle Version="00" or "01", versionIndex}.
-    std::map<std::string, std::size_t> m1stSubVersionIndexMap;
+    std::map<std::string, std::size_t, std::less<>> m1stSubVersionIndexMap;
 
     //! @brief Vector of {Index=VersionIndex, Map of {DbTitle, MusicIndex}}.
     //! @note Since index is unchanged after loading, cache all music index.
-    std::vector<std::unordered_map<std::string, std::size_t>> mTitleMusicIndexByVersion;
+    std::vector<std::unordered_map<std::string, std::size_t, StringViewHash, StringViewEqual>> mTitleMusicIndexByVersion;
 
     //! @brief Map of {VersionIndex, ActiveVersion}.
     std::map<std::size_t, ActiveVersion> mActiveVersions;
 
+    //! @brief Allocate availability table rows of all musics, Vector of {Index=VersionIndex, MusicCount}.
+        void
+        AllocateChartAvailabilityTable(const std::vector<std::size_t> &versionMusicCounts);
+
+    //! @brief Build musics, CS music flags and title mappings from Json DB content.
+    //! Versions are built in parallel by buildThreadCount workers.
+    //! @note Title mappings are moved from content.
+        void
+        BuildFromJsonContent(MusicDatabaseJsonContent &content,
+                             std::size_t buildThreadCount);
+
+    //! @brief Build musics, CS music flags and title music index of versionIndex.
+    //! @note Only writes tables of versionIndex, safe to build different versions concurrently.
+        void
+        BuildVersionMusics(std::size_t versionIndex,
+                           const MusicDatabaseJsonContent &content);
+
     //! @brief Generate all active versions between version range [begin, latest].
+    //! Each active version is generated by one of buildThreadCount workers.
+        void
+        GenerateActiveVersions(std::size_t beginVersionIndex,
+                               std::size_t buildThreadCount);
+
+    //! @brief Load built tables from snapshot, only index version titles if lazyMaterialize.
+    //! @return False if snapshot not exist, has different format, or created from different source hash.
+        bool
+        LoadSnapshot(const std::string &snapshotFilename,
+                     std::uint64_t sourceHash,
+                     bool lazyMaterialize);
+
+    //! @brief Fill title music index, CS music flag size and 1st&substream index of version snapshot block.
+        void
+        IndexVersionTitles(std::size_t versionIndex,
+                           std::string_view versionBlock);
+
+    //! @brief Build mCsvMusicIdIndex, after title music indexes and title mappings are built.
         void
-        GenerateActiveVersions(std::size_t beginVersionIndex);
+        BuildCsvMusicIdIndex();
 
-        const Json*
-        FindDbMusic(std::size_t versionIndex, const std::string &title)
+    //! @brief Restore Music objects of version snapshot block.
+    //! @note Writes only mAllTimeMusics[versionIndex], lazy mode calls it once per version under its flag.
+        void
+        RestoreVersionMusics(std::size_t versionIndex,
+                             std::string_view versionBlock)
+        const;
+
+    //! @brief Restore versionIndex's musics at first call if in lazy mode, thread safe.
+        void
+        MaterializeVersion(std::size_t versionIndex)
+        const;
+
+        void
+        WriteSnapshot(const std::string &snapshotFilename,
+                      std::uint64_t sourceHash)
         const;
 };
 
+//! @brief Get DB filename specified in 'table/usingDB.txt' if it exists, otherwise DefaultMusicDatabaseFilename.
+std::string
+GetUsingMusicDatabaseFilename();
+
+//! @brief Get process-wide shared MusicDatabase of filename, load it at first request.
+//! Concurrent requests of same filename wait for the single load.
+//! @note Loaded databases are kept until process exit or ReleaseSharedMusicDatabase, later requests cost nothing.
+//! Load failure is not cached, next request retries.
+std::shared_ptr<const MusicDatabase>
+GetSharedMusicDatabase(const std::string &filename);
+
+//! @brief Get shared MusicDatabase of GetUsingMusicDatabaseFilename().
+std::shared_ptr<const MusicDatabase>
+GetSharedMusicDatabase();
+
+//! @brief Load filename again bypassing cache (e.g. file is updated), later GetSharedMusicDatabase(filename)
+//! returns reloaded database. Existing handles keep previous database.
+std::shared_ptr<const MusicDatabase>
+ReloadSharedMusicDatabase(const std::string &filename);
+
+//! @brief Drop cache's own handle of filename's database, e.g. after switched to newer database.
+//! Database stays shared while any other handle exists, GetSharedMusicDatabase(filename) loads again
+//! only after all handles are released.
+void
+ReleaseSharedMusicDatabase(const std::string &filename);
+
 void
 UpgradeMusicDatabase(const std::string &currentFilename,
                      const std::string &newFilename);
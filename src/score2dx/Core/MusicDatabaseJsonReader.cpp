@@ -0,0 +1,229 @@
+#include "score2dx/Core/MusicDatabaseJsonReader.hpp"
+
+#include <optional>
+#include <stdexcept>
+
+#include "score2dx/Core/JsonDefinition.hpp"
+
+namespace
+{
+
+//! @brief SAX handler fill MusicDatabaseJsonContent by key path of each value.
+//! Key path of DB Json:
+//!     #meta/count
+//!     version/{Version}/[{DbTitle}...]
+//!     {musicTable|csMusicTable}/{Version}/{DbTitle}/info/{genre|artist}/latest
+//!     {musicTable|csMusicTable}/{Version}/{DbTitle}/info/displayTitle
+//!     {musicTable|csMusicTable}/{Version}/{DbTitle}/difficulty/{StyleDifficulty}/{ChartVersions}/{level|note}
+//!     titleMapping/{Section}/{Title}
+class MusicDatabaseSaxHandler
+{
+public:
+    using number_integer_t = score2dx::Json::number_integer_t;
+    using number_unsigned_t = score2dx::Json::number_unsigned_t;
+    using number_float_t = score2dx::Json::number_float_t;
+    using string_t = score2dx::Json::string_t;
+    using binary_t = score2dx::Json::binary_t;
+
+        explicit MusicDatabaseSaxHandler(score2dx::MusicDatabaseJsonContent &content)
+        :   mContent(content)
+        {
+        }
+
+        bool null() { return true; }
+        bool boolean(bool) { return true; }
+        bool binary(binary_t &) { return true; }
+
+        bool
+        number_integer(number_integer_t value)
+        {
+            SetChartInfoValue(static_cast<int>(value));
+            return true;
+        }
+
+        bool
+        number_unsigned(number_unsigned_t value)
+        {
+            SetChartInfoValue(static_cast<int>(value));
+            return true;
+        }
+
+        bool
+        number_float(number_float_t value, const string_t &)
+        {
+            SetChartInfoValue(static_cast<int>(value));
+            return true;
+        }
+
+        bool
+        string(string_t &value)
+        {
+            if (mDepth==2&&mFrames[0].Key=="#meta"&&mFrames[1].Key=="count")
+            {
+                mContent.MetaCount = std::move(value);
+            }
+            else if (mDepth==3&&mFrames[0].Key=="version"&&mFrames[2].IsArray)
+            {
+                mContent.VersionTitles[mFrames[1].Key].emplace_back(std::move(value));
+            }
+            else if (mDepth==3&&mFrames[0].Key=="titleMapping")
+            {
+                mContent.TitleMappings.push_back({
+                    mFrames[2].Key,
+                    std::move(value),
+                    score2dx::ToTitleMappingSection(mFrames[1].Key)
+                });
+            }
+            else if (mCurrentMusic&&mDepth==5&&mFrames[3].Key=="info"&&mFrames[4].Key=="displayTitle")
+            {
+                mCurrentMusic->DisplayTitle = std::move(value);
+            }
+            else if (mCurrentMusic&&mDepth==6&&mFrames[3].Key=="info"&&mFrames[5].Key=="latest")
+            {
+                if (mFrames[4].Key=="genre") { mCurrentMusic->Genre = std::move(value); }
+                if (mFrames[4].Key=="artist") { mCurrentMusic->Artist = std::move(value); }
+            }
+            return true;
+        }
+
+        bool
+        start_object(std::size_t)
+        {
+            if (mCurrentTable&&mDepth==3)
+            {
+                mCurrentMusic = &(*mCurrentTable)[mFrames[1].Key][mFrames[2].Key];
+            }
+            if (mCurrentMusic&&mDepth==6&&mFrames[3].Key=="difficulty")
+            {
+                mLevel.reset();
+                mNote.reset();
+            }
+            PushFrame(false);
+            return true;
+        }
+
+        bool
+        key(string_t &key)
+        {
+            auto &frame = mFrames[mDepth-1];
+            frame.Key = key;
+            if (mDepth==1)
+            {
+                mCurrentTable = nullptr;
+                if (key=="musicTable") { mCurrentTable = &mContent.MusicTable; }
+                if (key=="csMusicTable") { mCurrentTable = &mContent.CsMusicTable; }
+            }
+            return true;
+        }
+
+        bool
+        end_object()
+        {
+            --mDepth;
+            if (mCurrentMusic&&mDepth==6&&mFrames[3].Key=="difficulty")
+            {
+                AddChartInfo();
+            }
+            if (mDepth==3)
+            {
+                mCurrentMusic = nullptr;
+            }
+            return true;
+        }
+
+        bool
+        start_array(std::size_t)
+        {
+            PushFrame(true);
+            return true;
+        }
+
+        bool
+        end_array()
+        {
+            --mDepth;
+            return true;
+        }
+
+        bool
+        parse_error(std::size_t position, const std::string &, const score2dx::Json::exception &e)
+        {
+            throw std::runtime_error("ReadMusicDatabaseJson(): parse error at byte "+std::to_string(position)+": "+e.what());
+        }
+
+private:
+    struct Frame
+    {
+        bool IsArray{false};
+        //! @brief Current key if frame is object.
+        std::string Key;
+    };
+
+    score2dx::MusicDatabaseJsonContent &mContent;
+
+    //! @brief Vector of {Index=Depth, Frame}, frames beyond mDepth are kept to reuse key capacity.
+    std::vector<Frame> mFrames;
+    std::size_t mDepth{0};
+
+    std::map<std::string, score2dx::DbVersionMusicTable>* mCurrentTable{nullptr};
+    score2dx::DbMusicContent* mCurrentMusic{nullptr};
+    std::optional<int> mLevel;
+    std::optional<int> mNote;
+
+        void
+        PushFrame(bool isArray)
+        {
+            if (mDepth==mFrames.size())
+            {
+                mFrames.emplace_back();
+            }
+            auto &frame = mFrames[mDepth];
+            frame.IsArray = isArray;
+            frame.Key.clear();
+            ++mDepth;
+        }
+
+        void
+        SetChartInfoValue(int value)
+        {
+            if (!mCurrentMusic||mDepth!=7||mFrames[3].Key!="difficulty") { return; }
+
+            if (mFrames[6].Key=="level") { mLevel = value; }
+            if (mFrames[6].Key=="note") { mNote = value; }
+        }
+
+        void
+        AddChartInfo()
+        {
+            auto &styleDifficultyString = mFrames[4].Key;
+            auto &chartVersions = mFrames[5].Key;
+            if (!mLevel||!mNote)
+            {
+                throw std::runtime_error("ReadMusicDatabaseJson(): ["+mFrames[1].Key+"]["+mFrames[2].Key+"]["
+                                         +styleDifficultyString+"]["+chartVersions+"] lack level or note.");
+            }
+
+            auto styleDifficulty = score2dx::ToStyleDifficulty(styleDifficultyString);
+            auto &chartInfoByChartVersions = mCurrentMusic->ChartInfoByChartVersions[static_cast<std::size_t>(styleDifficulty)];
+            chartInfoByChartVersions.emplace(chartVersions, score2dx::ChartInfo{mLevel.value(), mNote.value()});
+        }
+};
+
+}
+
+namespace score2dx
+{
+
+MusicDatabaseJsonContent
+ReadMusicDatabaseJson(std::string_view jsonText)
+{
+    MusicDatabaseJsonContent content;
+    MusicDatabaseSaxHandler handler{content};
+    if (!Json::sax_parse(jsonText.begin(), jsonText.end(), &handler))
+    {
+        throw std::runtime_error("ReadMusicDatabaseJson(): parse failed.");
+    }
+    return content;
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "score2dx/Core/TitleMappingIndex.hpp"
+#include "score2dx/Iidx/ChartInfo.hpp"
+#include "score2dx/Iidx/Definition.hpp"
+
+namespace score2dx
+{
+
+//! @brief Typed content of a music in DB Json musicTable or csMusicTable.
+struct DbMusicContent
+{
+    std::string Genre;
+    std::string Artist;
+    std::string DisplayTitle;
+
+    //! @brief Array of {Index=StyleDifficulty, Map of {ChartVersions, ChartInfo}}.
+    //! Map is empty if music has no such style difficulty.
+    std::array<std::map<std::string, ChartInfo>, StyleDifficultySmartEnum::Size()> ChartInfoByChartVersions;
+};
+
+//! @brief Map of {DbTitle, DbMusicContent}.
+using DbVersionMusicTable = std::unordered_map<std::string, DbMusicContent>;
+
+//! @brief Typed content of DB Json, only contains fields used to build MusicDatabase.
+struct MusicDatabaseJsonContent
+{
+    //! @brief '#meta' 'count', MusicId string of latest music.
+    std::string MetaCount;
+
+    //! @brief Map of {Version, Vector of {Index=MusicIndex, DbTitle}}.
+    std::map<std::string, std::vector<std::string>> VersionTitles;
+
+    //! @brief Map of {Version, DbVersionMusicTable}.
+    std::map<std::string, DbVersionMusicTable> MusicTable;
+    std::map<std::string, DbVersionMusicTable> CsMusicTable;
+
+    std::vector<TitleMapping> TitleMappings;
+};
+
+//! @brief Read DB Json by SAX parsing, fill content directly without building Json DOM.
+//! Unknown keys (e.g. availableVersions, levelLabel) are skipped.
+//! @note Throws if jsonText is not valid Json, or chart info lacks level or note.
+MusicDatabaseJsonContent
+ReadMusicDatabaseJson(std::string_view jsonText);
+
+}
@@ -0,0 +1,74 @@
+#include "score2dx/Core/MusicDatabaseJsonReader.hpp"
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+namespace score2dx
+{
+
+TEST(MusicDatabaseJsonReader, ReadMusicDatabaseJson)
+{
+    const std::string json = R"({
+        "#meta": {"count": "31001", "version": "31"},
+        "csMusicTable": {
+            "04": {
+                "ErAseRmoToR maXimUM": {
+                    "availableVersions": "cs04",
+                    "difficulty": {"SPN": {"cs04": {"level": 5, "note": 574}}},
+                    "info": {"artist": {"latest": "L.E.D.-G VS GUHROOVY"}, "genre": {"latest": "HARDCORE"}}
+                }
+            }
+        },
+        "musicTable": {
+            "00": {
+                "20,November": {
+                    "availableVersions": "00-02",
+                    "difficulty": {
+                        "SPH": {"00": {"level": 3, "note": 301}, "01-02": {"level": 4, "levelLabel": "4+", "note": 301}}
+                    },
+                    "info": {
+                        "artist": {"latest": "dj nagureo"},
+                        "displayTitle": "20, November",
+                        "genre": {"another": "HOUSE", "latest": "HOUSE"}
+                    }
+                }
+            }
+        },
+        "titleMapping": {"csv": {"19，November": "19,November"}, "wiki": {"20 November": "20,November"}},
+        "version": {"00": ["20,November"], "04": ["ErAseRmoToR maXimUM"]}
+    })";
+
+    auto content = ReadMusicDatabaseJson(json);
+    EXPECT_EQ("31001", content.MetaCount);
+    ASSERT_EQ(2u, content.VersionTitles.size());
+    EXPECT_EQ(std::vector<std::string>{"20,November"}, content.VersionTitles["00"]);
+
+    auto &music = content.MusicTable.at("00").at("20,November");
+    EXPECT_EQ("HOUSE", music.Genre);
+    EXPECT_EQ("dj nagureo", music.Artist);
+    EXPECT_EQ("20, November", music.DisplayTitle);
+    auto &sphChartInfos = music.ChartInfoByChartVersions[static_cast<std::size_t>(StyleDifficulty::SPH)];
+    ASSERT_EQ(2u, sphChartInfos.size());
+    EXPECT_EQ((ChartInfo{3, 301}), sphChartInfos.at("00"));
+    EXPECT_EQ((ChartInfo{4, 301}), sphChartInfos.at("01-02"));
+    EXPECT_TRUE(music.ChartInfoByChartVersions[static_cast<std::size_t>(StyleDifficulty::SPN)].empty());
+
+    auto &csMusic = content.CsMusicTable.at("04").at("ErAseRmoToR maXimUM");
+    EXPECT_EQ("HARDCORE", csMusic.Genre);
+    EXPECT_TRUE(csMusic.DisplayTitle.empty());
+    EXPECT_EQ((ChartInfo{5, 574}), csMusic.ChartInfoByChartVersions[static_cast<std::size_t>(StyleDifficulty::SPN)].at("cs04"));
+    EXPECT_FALSE(content.MusicTable.contains("04"));
+
+    ASSERT_EQ(2u, content.TitleMappings.size());
+    EXPECT_EQ("19，November", content.TitleMappings[0].Title);
+    EXPECT_EQ("19,November", content.TitleMappings[0].DbTitle);
+    EXPECT_EQ(TitleMappingSection::csv, content.TitleMappings[0].Section);
+    EXPECT_EQ(TitleMappingSection::wiki, content.TitleMappings[1].Section);
+
+    EXPECT_THROW(ReadMusicDatabaseJson(R"({"version": {"00": [)"), std::runtime_error);
+    EXPECT_THROW(ReadMusicDatabaseJson(R"({"musicTable": {"00": {"A": {"difficulty": {"SPN": {"00": {"level": 1}}}}}}})"),
+                 std::runtime_error);
+}
+
+}
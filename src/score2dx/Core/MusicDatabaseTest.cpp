@@ -1,15 +1,85 @@
 #include "score2dx/Core/MusicDatabase.hpp"
 
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include "ies/Common/IntegralRangeUsing.hpp"
 #include "ies/StdUtil/FormatString.hxx"
 
+#include "score2dx/Core/BinaryStream.hxx"
+#include "score2dx/Core/TestUtil.hpp"
 #include "score2dx/Iidx/Version.hpp"
 
+namespace fs = std::filesystem;
+
 namespace score2dx
 {
 
+namespace
+{
+
+//'' snapshot header: Magic(string), FormatVersion(u32), SourceHash(u64).
+std::pair<std::uint32_t, std::uint64_t>
+ReadSnapshotHeader(const fs::path &snapshotPath)
+{
+    auto snapshot = ReadFile(snapshotPath);
+    BinaryReader reader{snapshot};
+    if (reader.ReadString()!="S2DB") { throw std::runtime_error("not a snapshot."); }
+    auto formatVersion = reader.Read<std::uint32_t>();
+    auto sourceHash = reader.Read<std::uint64_t>();
+    return {formatVersion, sourceHash};
+}
+
+void
+ExpectSameTables(const MusicDatabase &expected, const MusicDatabase &actual)
+{
+    auto &expectedMusics = expected.GetAllTimeMusics();
+    auto &actualMusics = actual.GetAllTimeMusics();
+    ASSERT_EQ(expectedMusics.size(), actualMusics.size());
+    for (auto versionIndex : IndexRange{0, expectedMusics.size()})
+    {
+        ASSERT_EQ(expectedMusics[versionIndex].size(), actualMusics[versionIndex].size());
+        for (auto musicIndex : IndexRange{0, expectedMusics[versionIndex].size()})
+        {
+            auto &expectedMusic = expectedMusics[versionIndex][musicIndex];
+            auto &actualMusic = actualMusics[versionIndex][musicIndex];
+            auto musicId = expectedMusic.GetMusicId();
+            ASSERT_EQ(musicId, actualMusic.GetMusicId());
+            ASSERT_EQ(expected.GetTitle(musicId), actual.GetTitle(musicId));
+            EXPECT_EQ(expected.IsCsMusic(musicId), actual.IsCsMusic(musicId));
+            for (auto styleDifficulty : StyleDifficultySmartEnum::ToRange())
+            {
+                ASSERT_EQ(expectedMusic.GetChartNotes(styleDifficulty), actualMusic.GetChartNotes(styleDifficulty));
+                for (auto availableVersionIndex : IndexRange{0, VersionNames.size()})
+                {
+                    auto expectedAvailability = expectedMusic.GetChartAvailability(styleDifficulty, availableVersionIndex);
+                    auto actualAvailability = actualMusic.GetChartAvailability(styleDifficulty, availableVersionIndex);
+                    ASSERT_EQ(expectedAvailability.ChartAvailableStatus, actualAvailability.ChartAvailableStatus);
+                    ASSERT_EQ(expectedAvailability.ChartInfoProp, actualAvailability.ChartInfoProp);
+                    ASSERT_EQ(expectedAvailability.ChartIndex, actualAvailability.ChartIndex);
+                }
+            }
+        }
+    }
+
+    auto &expectedActiveVersions = expected.GetActiveVersions();
+    auto &actualActiveVersions = actual.GetActiveVersions();
+    ASSERT_EQ(expectedActiveVersions.size(), actualActiveVersions.size());
+    for (auto &[activeVersionIndex, expectedActiveVersion] : expectedActiveVersions)
+    {
+        auto* actualActiveVersion = actual.FindActiveVersion(activeVersionIndex);
+        ASSERT_NE(nullptr, actualActiveVersion);
+        EXPECT_EQ(expectedActiveVersion.GetChartIdList(), actualActiveVersion->GetChartIdList());
+    }
+}
+
+}
+
 TEST(MusicDatabase, ToRangeList)
 {
     //'' gentle stress [modified]
@@ -23,4 +93,82 @@ TEST(MusicDatabase, ToRangeList)
     ASSERT_EQ(expectRangeList.GetRanges(), ToRangeList("01-05, 09-16, 24, 27-29").GetRanges());
 }
 
+TEST(MusicDatabase, SnapshotBinaryStream)
+{
+    BinaryWriter writer;
+    writer.WriteString("S2DB");
+    writer.Write(std::uint64_t{31048});
+    writer.WriteString("");
+    writer.Write(std::uint8_t{2});
+
+    BinaryReader reader{writer.GetBuffer()};
+    EXPECT_EQ("S2DB", reader.ReadString());
+    EXPECT_EQ(31048u, reader.Read<std::uint64_t>());
+    EXPECT_EQ("", reader.ReadString());
+    EXPECT_EQ(2u, reader.Read<std::uint8_t>());
+    EXPECT_EQ(0u, reader.GetRemainSize());
+    ASSERT_THROW(reader.Read<std::uint8_t>(), std::runtime_error);
+}
+
+TEST(MusicDatabase, Snapshot)
+{
+    if (!fs::exists(DefaultMusicDatabaseFilename))
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    TestDirectory testDirectory{"score2dx_music_database_snapshot_test"};
+    auto &directory = testDirectory.GetPath();
+    auto databasePath = directory/fs::path{DefaultMusicDatabaseFilename}.filename();
+    auto snapshotPath = fs::path{databasePath}.replace_extension(".s2db");
+    fs::copy_file(DefaultMusicDatabaseFilename, databasePath);
+
+    MusicDatabaseOptions jsonOptions;
+    jsonOptions.UseSnapshot = false;
+    MusicDatabase jsonDatabase{databasePath.string(), jsonOptions};
+    ASSERT_FALSE(fs::exists(snapshotPath));
+
+    //'' first load writes snapshot, later load restores from it without rewriting.
+    MusicDatabase{databasePath.string()};
+    ASSERT_TRUE(fs::exists(snapshotPath));
+    auto [formatVersion, sourceHash] = ReadSnapshotHeader(snapshotPath);
+    EXPECT_EQ(jsonDatabase.GetSourceHash(), sourceHash);
+
+    auto oldWriteTime = fs::last_write_time(snapshotPath)-std::chrono::hours{1};
+    fs::last_write_time(snapshotPath, oldWriteTime);
+    {
+        MusicDatabase snapshotDatabase{databasePath.string()};
+        EXPECT_EQ(oldWriteTime, fs::last_write_time(snapshotPath));
+        ExpectSameTables(jsonDatabase, snapshotDatabase);
+
+        MusicDatabaseOptions lazyOptions;
+        lazyOptions.LazyMaterialize = true;
+        MusicDatabase lazyDatabase{databasePath.string(), lazyOptions};
+        EXPECT_EQ(oldWriteTime, fs::last_write_time(snapshotPath));
+        ExpectSameTables(jsonDatabase, lazyDatabase);
+    }
+
+    //'' format version mismatch: snapshot is rejected and rebuilt from Json.
+    {
+        auto snapshot = ReadFile(snapshotPath);
+        auto mismatchVersion = formatVersion+1;
+        std::memcpy(snapshot.data()+sizeof(std::uint32_t)+4, &mismatchVersion, sizeof(mismatchVersion));
+        std::ofstream{snapshotPath, std::ios::binary|std::ios::trunc} << snapshot;
+        ASSERT_EQ(mismatchVersion, ReadSnapshotHeader(snapshotPath).first);
+
+        MusicDatabase rebuiltDatabase{databasePath.string()};
+        EXPECT_EQ(formatVersion, ReadSnapshotHeader(snapshotPath).first);
+        ExpectSameTables(jsonDatabase, rebuiltDatabase);
+    }
+
+    //'' changed Json content: snapshot of old source hash is rebuilt.
+    {
+        std::ofstream{databasePath, std::ios::binary|std::ios::app} << "\n";
+        MusicDatabase rebuiltDatabase{databasePath.string()};
+        EXPECT_NE(sourceHash, rebuiltDatabase.GetSourceHash());
+        EXPECT_EQ(rebuiltDatabase.GetSourceHash(), ReadSnapshotHeader(snapshotPath).second);
+        ExpectSameTables(jsonDatabase, rebuiltDatabase);
+    }
+}
+
 }
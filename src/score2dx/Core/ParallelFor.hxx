@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace score2dx
+{
+
+//! @brief Resolve requested thread count, 0 means hardware concurrency.
+inline std::size_t
+ResolveThreadCount(std::size_t threadCount)
+{
+    if (threadCount!=0) { return threadCount; }
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+//! @brief Call function(index) for each index in [0, count) on pool of threadCount workers (0 = hardware concurrency).
+//! Workers take next index from shared counter, calling thread is one of the workers.
+//! If a worker thread cannot be started, remaining workers (at least calling thread) take its indexes.
+//! @note Every index is called even if some throw (also with single worker), then exception of the lowest
+//! failed index is rethrown, so result is deterministic as long as each call only writes state owned by its index.
+template <typename Function>
+void
+ParallelFor(std::size_t count, std::size_t threadCount, Function &&function)
+{
+    auto workerCount = std::min(ResolveThreadCount(threadCount), count);
+
+    std::atomic<std::size_t> nextIndex{0};
+    std::vector<std::exception_ptr> exceptions(count);
+    auto work = [&]()
+    {
+        for (auto index = nextIndex++; index<count; index = nextIndex++)
+        {
+            try
+            {
+                function(index);
+            }
+            catch (...)
+            {
+                exceptions[index] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    if (workerCount>1)
+    {
+        workers.reserve(workerCount-1);
+        try
+        {
+            for (std::size_t i = 1; i<workerCount; ++i)
+            {
+                workers.emplace_back(work);
+            }
+        }
+        catch (const std::system_error &)
+        {
+            //'' e.g. thread resource exhausted, started workers and calling thread finish all indexes.
+        }
+    }
+    work();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    for (auto &exception : exceptions)
+    {
+        if (exception) { std::rethrow_exception(exception); }
+    }
+}
+
+}
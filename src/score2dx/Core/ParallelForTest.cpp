@@ -0,0 +1,49 @@
+#include "score2dx/Core/ParallelFor.hxx"
+
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace score2dx
+{
+
+TEST(ParallelFor, ParallelFor)
+{
+    for (std::size_t threadCount : {0, 1, 3, 64})
+    {
+        std::vector<std::size_t> squares(100, 0);
+        ParallelFor(squares.size(), threadCount, [&](std::size_t i) { squares[i] = i*i; });
+        for (std::size_t i = 0; i<squares.size(); ++i)
+        {
+            ASSERT_EQ(i*i, squares[i]);
+        }
+    }
+
+    ParallelFor(0, 4, [](std::size_t) { FAIL(); });
+}
+
+TEST(ParallelFor, RethrowLowestFailedIndex)
+{
+    //'' single worker calls every index too, side effects do not depend on thread count.
+    for (std::size_t threadCount : {1, 4})
+    {
+        std::vector<int> called(50, 0);
+        try
+        {
+            ParallelFor(called.size(), threadCount, [&](std::size_t i)
+            {
+                called[i] = 1;
+                if (i%10==7) { throw std::runtime_error(std::to_string(i)); }
+            });
+            FAIL();
+        }
+        catch (const std::runtime_error &e)
+        {
+            EXPECT_EQ("7", std::string{e.what()});
+        }
+        EXPECT_EQ(std::vector<int>(50, 1), called);
+    }
+}
+
+}
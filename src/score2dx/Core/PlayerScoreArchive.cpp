@@ -0,0 +1,412 @@
+#include "score2dx/Core/PlayerScoreArchive.hpp"
+
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "ies/Common/IntegralRangeUsing.hpp"
+
+#include "score2dx/Core/BinaryStream.hxx"
+#include "score2dx/Iidx/Version.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr char PlayerScoreArchiveMagic[4]{'S', '2', 'P', 'A'};
+//'' increase when header or record layout changes.
+constexpr std::uint32_t PlayerScoreArchiveFormatVersion = 2;
+//'' read as other value if archive is written in other byte order.
+constexpr std::uint32_t ByteOrderMark = 0x01020304;
+constexpr std::size_t IidxIdCapacity = 12;
+
+struct ArchiveHeader
+{
+    char Magic[4]{};
+    std::uint32_t FormatVersion{0};
+    std::uint32_t ByteOrderMark{0};
+    std::uint32_t MusicScoreCount{0};
+    std::uint32_t ChartScoreCount{0};
+    //'' null padded.
+    char IidxId[IidxIdCapacity]{};
+    std::uint64_t DatabaseSourceHash{0};
+};
+
+static_assert(sizeof(ArchiveHeader)==40);
+static_assert(sizeof(score2dx::ArchiveMusicScoreRecord)==20);
+static_assert(sizeof(score2dx::ArchiveChartScoreRecord)==12);
+static_assert(std::is_trivially_copyable_v<score2dx::ArchiveMusicScoreRecord>);
+static_assert(std::is_trivially_copyable_v<score2dx::ArchiveChartScoreRecord>);
+//'' chart score records follow header and music score records without padding.
+static_assert(sizeof(ArchiveHeader)%alignof(score2dx::ArchiveMusicScoreRecord)==0);
+static_assert(sizeof(score2dx::ArchiveMusicScoreRecord)%alignof(score2dx::ArchiveChartScoreRecord)==0);
+static_assert(score2dx::DifficultySmartEnum::Size()<=8, "DifficultyMask is 8 bits.");
+
+template <typename T>
+T
+ToArchiveValue(std::size_t value, std::size_t limit, const char* name)
+{
+    if (value>limit)
+    {
+        throw std::runtime_error(std::string{name}+" ["+std::to_string(value)+"] is out of archive range.");
+    }
+    return static_cast<T>(value);
+}
+
+template <typename T>
+T
+ToArchiveValue(int value, std::size_t limit, const char* name)
+{
+    if (value<0)
+    {
+        throw std::runtime_error(std::string{name}+" ["+std::to_string(value)+"] is negative.");
+    }
+    return ToArchiveValue<T>(static_cast<std::size_t>(value), limit, name);
+}
+
+std::uint32_t
+PackDateTime(std::string_view dateTime)
+{
+    if (dateTime.empty())
+    {
+        return 0;
+    }
+
+    //'' "YYYY-MM-DD HH:MM"
+    auto ParseDigits = [&dateTime](std::size_t begin, std::size_t size) -> std::uint32_t
+    {
+        std::uint32_t value = 0;
+        for (auto i = begin; i<begin+size; ++i)
+        {
+            if (dateTime[i]<'0'||dateTime[i]>'9')
+            {
+                throw std::runtime_error("invalid DateTime ["+std::string{dateTime}+"].");
+            }
+            value = value*10+static_cast<std::uint32_t>(dateTime[i]-'0');
+        }
+        return value;
+    };
+
+    if (dateTime.size()!=16||dateTime[4]!='-'||dateTime[7]!='-'||dateTime[10]!=' '||dateTime[13]!=':')
+    {
+        throw std::runtime_error("invalid DateTime ["+std::string{dateTime}+"].");
+    }
+
+    auto year = ParseDigits(0, 4);
+    auto month = ParseDigits(5, 2);
+    auto day = ParseDigits(8, 2);
+    auto hour = ParseDigits(11, 2);
+    auto minute = ParseDigits(14, 2);
+    if (year>0xFFF||month==0||month>12||day==0||day>31||hour>23||minute>59)
+    {
+        throw std::runtime_error("invalid DateTime ["+std::string{dateTime}+"].");
+    }
+
+    return year<<20|month<<16|day<<11|hour<<6|minute;
+}
+
+std::string
+UnpackDateTime(std::uint32_t packedDateTime)
+{
+    if (packedDateTime==0)
+    {
+        return {};
+    }
+
+    std::string dateTime{"0000-00-00 00:00"};
+    auto WriteDigits = [&dateTime](std::size_t begin, std::size_t size, std::uint32_t value)
+    {
+        for (auto i = begin+size; i>begin; --i)
+        {
+            dateTime[i-1] = static_cast<char>('0'+value%10);
+            value /= 10;
+        }
+    };
+
+    WriteDigits(0, 4, packedDateTime>>20);
+    WriteDigits(5, 2, (packedDateTime>>16)&0xF);
+    WriteDigits(8, 2, (packedDateTime>>11)&0x1F);
+    WriteDigits(11, 2, (packedDateTime>>6)&0x1F);
+    WriteDigits(14, 2, packedDateTime&0x3F);
+    return dateTime;
+}
+
+}
+
+namespace score2dx
+{
+
+PlayerScoreArchive::
+PlayerScoreArchive(const std::string &filename,
+                   const MusicDatabase &musicDatabase)
+:   mFile(filename)
+{
+    auto view = mFile.GetView();
+    auto Invalid = [&filename](const std::string &reason)
+    {
+        return std::runtime_error("invalid player score archive ["+filename+"]: "+reason);
+    };
+
+    if (view.size()<sizeof(ArchiveHeader))
+    {
+        throw Invalid("file is too small.");
+    }
+
+    ArchiveHeader header;
+    std::memcpy(&header, view.data(), sizeof(ArchiveHeader));
+    if (std::memcmp(header.Magic, PlayerScoreArchiveMagic, sizeof(header.Magic))!=0)
+    {
+        throw Invalid("incorrect magic.");
+    }
+    if (header.ByteOrderMark!=ByteOrderMark)
+    {
+        throw Invalid("written in other byte order.");
+    }
+    if (header.FormatVersion!=PlayerScoreArchiveFormatVersion)
+    {
+        throw Invalid("unsupported format version ["+std::to_string(header.FormatVersion)+"].");
+    }
+    if (header.DatabaseSourceHash!=musicDatabase.GetSourceHash())
+    {
+        throw Invalid("written with other music database than ["+musicDatabase.GetFilename()+"].");
+    }
+
+    auto musicScoreBytes = static_cast<std::size_t>(header.MusicScoreCount)*sizeof(ArchiveMusicScoreRecord);
+    auto chartScoreBytes = static_cast<std::size_t>(header.ChartScoreCount)*sizeof(ArchiveChartScoreRecord);
+    if (view.size()!=sizeof(ArchiveHeader)+musicScoreBytes+chartScoreBytes)
+    {
+        throw Invalid("size is not agreed with record counts.");
+    }
+
+    //'' mapped view is page aligned, records are used in place.
+    auto* musicScoreData = view.data()+sizeof(ArchiveHeader);
+    if (reinterpret_cast<std::uintptr_t>(musicScoreData)%alignof(ArchiveMusicScoreRecord)!=0)
+    {
+        throw Invalid("records are not aligned.");
+    }
+
+    std::string_view iidxId{header.IidxId, IidxIdCapacity};
+    mIidxId = iidxId.substr(0, iidxId.find('\0'));
+    if (!IsIidxId(mIidxId))
+    {
+        throw Invalid("["+mIidxId+"] is not a valid IIDX ID.");
+    }
+    mDatabaseSourceHash = header.DatabaseSourceHash;
+
+    mMusicScoreRecords =
+    {
+        reinterpret_cast<const ArchiveMusicScoreRecord*>(musicScoreData),
+        header.MusicScoreCount
+    };
+    mChartScoreRecords =
+    {
+        reinterpret_cast<const ArchiveChartScoreRecord*>(musicScoreData+musicScoreBytes),
+        header.ChartScoreCount
+    };
+}
+
+const std::string &
+PlayerScoreArchive::
+GetIidxId()
+const
+{
+    return mIidxId;
+}
+
+std::span<const ArchiveMusicScoreRecord>
+PlayerScoreArchive::
+GetMusicScoreRecords()
+const
+{
+    return mMusicScoreRecords;
+}
+
+MusicScore
+PlayerScoreArchive::
+ToMusicScore(const ArchiveMusicScoreRecord &record)
+const
+{
+    auto chartScoreCount = static_cast<std::size_t>(std::popcount(record.DifficultyMask));
+    if (record.PlayStyle>=PlayStyleSmartEnum::Size()
+        ||record.ScoreSource>=ScoreSourceSmartEnum::Size()
+        ||record.ScoreVersionIndex>=VersionNames.size()
+        ||(record.DifficultyMask>>DifficultySmartEnum::Size())!=0
+        ||record.ChartScoreBegin>mChartScoreRecords.size()
+        ||chartScoreCount>mChartScoreRecords.size()-record.ChartScoreBegin)
+    {
+        throw std::runtime_error("PlayerScoreArchive: invalid music score record of music ["+std::to_string(record.MusicId)+"].");
+    }
+
+    MusicScore musicScore
+    {
+        record.MusicId,
+        static_cast<PlayStyle>(record.PlayStyle),
+        record.PlayCount,
+        UnpackDateTime(record.PackedDateTime),
+        static_cast<ScoreSource>(record.ScoreSource)
+    };
+
+    auto chartScoreIndex = static_cast<std::size_t>(record.ChartScoreBegin);
+    for (auto difficulty : DifficultySmartEnum::ToRange())
+    {
+        if (!(record.DifficultyMask&(1u<<static_cast<std::size_t>(difficulty))))
+        {
+            continue;
+        }
+
+        auto &chartScoreRecord = mChartScoreRecords[chartScoreIndex++];
+        if (chartScoreRecord.ClearType>=ClearTypeSmartEnum::Size()
+            ||chartScoreRecord.DjLevel>=DjLevelSmartEnum::Size())
+        {
+            throw std::runtime_error("PlayerScoreArchive: invalid chart score record of music ["+std::to_string(record.MusicId)+"].");
+        }
+
+        auto &chartScore = musicScore.EnableChartScore(difficulty);
+        chartScore.Level = chartScoreRecord.Level;
+        chartScore.ClearType = static_cast<ClearType>(chartScoreRecord.ClearType);
+        chartScore.DjLevel = static_cast<DjLevel>(chartScoreRecord.DjLevel);
+        chartScore.ExScore = chartScoreRecord.ExScore;
+        chartScore.PGreatCount = chartScoreRecord.PGreatCount;
+        chartScore.GreatCount = chartScoreRecord.GreatCount;
+        if (chartScoreRecord.MissCount!=ArchiveNoMissCount)
+        {
+            chartScore.MissCount = chartScoreRecord.MissCount;
+        }
+    }
+
+    return musicScore;
+}
+
+std::vector<std::pair<std::size_t, MusicScore>>
+PlayerScoreArchive::
+GetMusicScores()
+const
+{
+    std::vector<std::pair<std::size_t, MusicScore>> musicScores;
+    musicScores.reserve(mMusicScoreRecords.size());
+    for (auto &record : mMusicScoreRecords)
+    {
+        musicScores.emplace_back(record.ScoreVersionIndex, ToMusicScore(record));
+    }
+    return musicScores;
+}
+
+PlayerScore
+PlayerScoreArchive::
+ToPlayerScore(std::shared_ptr<const MusicDatabase> musicDatabase)
+const
+{
+    if (!musicDatabase||musicDatabase->GetSourceHash()!=mDatabaseSourceHash)
+    {
+        throw std::runtime_error("PlayerScoreArchive: musicDatabase is not database of archive.");
+    }
+
+    PlayerScore playerScore{std::move(musicDatabase), mIidxId};
+    for (auto &record : mMusicScoreRecords)
+    {
+        playerScore.AddMusicScore(record.ScoreVersionIndex, ToMusicScore(record));
+    }
+    return playerScore;
+}
+
+void
+WritePlayerScoreArchive(const PlayerScore &playerScore,
+                        const std::string &filename)
+{
+    constexpr auto MaxUint32 = std::numeric_limits<std::uint32_t>::max();
+    constexpr auto MaxUint8 = std::numeric_limits<std::uint8_t>::max();
+    constexpr auto MaxCount = static_cast<std::size_t>(ArchiveNoMissCount-1);
+
+    auto &iidxId = playerScore.GetIidxId();
+    if (iidxId.size()>IidxIdCapacity)
+    {
+        throw std::runtime_error("WritePlayerScoreArchive: IIDX ID ["+iidxId+"] is too long.");
+    }
+
+    std::vector<ArchiveMusicScoreRecord> musicScoreRecords;
+    std::vector<ArchiveChartScoreRecord> chartScoreRecords;
+    for (auto &[musicId, versionScoreTable] : playerScore.GetVersionScoreTables())
+    {
+        for (auto playStyle : PlayStyleSmartEnum::ToRange())
+        {
+            for (auto scoreVersionIndex : IndexRange{0, VersionNames.size()})
+            {
+                for (auto &[dateTime, musicScore] : versionScoreTable.GetMusicScores(scoreVersionIndex, playStyle))
+                {
+                    ArchiveMusicScoreRecord record;
+                    record.MusicId = ToArchiveValue<std::uint32_t>(musicId, MaxUint32, "MusicId");
+                    record.PlayCount = ToArchiveValue<std::uint32_t>(musicScore.GetPlayCount(), MaxUint32, "PlayCount");
+                    record.PackedDateTime = PackDateTime(dateTime);
+                    record.ChartScoreBegin = ToArchiveValue<std::uint32_t>(chartScoreRecords.size(), MaxUint32, "ChartScore count");
+                    record.ScoreVersionIndex = static_cast<std::uint8_t>(scoreVersionIndex);
+                    record.PlayStyle = static_cast<std::uint8_t>(playStyle);
+                    record.ScoreSource = static_cast<std::uint8_t>(musicScore.GetScoreSource());
+
+                    for (auto difficulty : DifficultySmartEnum::ToRange())
+                    {
+                        auto* chartScore = musicScore.GetChartScore(difficulty);
+                        if (!chartScore)
+                        {
+                            continue;
+                        }
+
+                        record.DifficultyMask |= static_cast<std::uint8_t>(1u<<static_cast<std::size_t>(difficulty));
+
+                        ArchiveChartScoreRecord chartScoreRecord;
+                        chartScoreRecord.ExScore = ToArchiveValue<std::uint16_t>(chartScore->ExScore, MaxCount, "ExScore");
+                        chartScoreRecord.PGreatCount = ToArchiveValue<std::uint16_t>(chartScore->PGreatCount, MaxCount, "PGreatCount");
+                        chartScoreRecord.GreatCount = ToArchiveValue<std::uint16_t>(chartScore->GreatCount, MaxCount, "GreatCount");
+                        chartScoreRecord.MissCount = chartScore->MissCount
+                            ? ToArchiveValue<std::uint16_t>(chartScore->MissCount.value(), MaxCount, "MissCount")
+                            : ArchiveNoMissCount;
+                        chartScoreRecord.Level = ToArchiveValue<std::uint8_t>(chartScore->Level, MaxUint8, "Level");
+                        chartScoreRecord.ClearType = static_cast<std::uint8_t>(chartScore->ClearType);
+                        chartScoreRecord.DjLevel = static_cast<std::uint8_t>(chartScore->DjLevel);
+                        chartScoreRecords.push_back(chartScoreRecord);
+                    }
+
+                    musicScoreRecords.push_back(record);
+                }
+            }
+        }
+    }
+
+    ArchiveHeader header;
+    std::memcpy(header.Magic, PlayerScoreArchiveMagic, sizeof(header.Magic));
+    header.FormatVersion = PlayerScoreArchiveFormatVersion;
+    header.ByteOrderMark = ByteOrderMark;
+    header.MusicScoreCount = ToArchiveValue<std::uint32_t>(musicScoreRecords.size(), MaxUint32, "MusicScore count");
+    header.ChartScoreCount = ToArchiveValue<std::uint32_t>(chartScoreRecords.size(), MaxUint32, "ChartScore count");
+    std::memcpy(header.IidxId, iidxId.data(), iidxId.size());
+    header.DatabaseSourceHash = playerScore.GetMusicDatabase().GetSourceHash();
+
+    BinaryWriter writer;
+    writer.Write(header);
+    for (auto &record : musicScoreRecords) { writer.Write(record); }
+    for (auto &record : chartScoreRecords) { writer.Write(record); }
+
+    //'' write to temporary file and rename, avoid other process reading partially written archive.
+    auto temporaryFilename = filename+".tmp";
+    {
+        std::ofstream archiveFile{temporaryFilename, std::ios::binary|std::ios::trunc};
+        if (!archiveFile)
+        {
+            throw std::runtime_error("cannot create file ["+temporaryFilename+"].");
+        }
+        auto &buffer = writer.GetBuffer();
+        archiveFile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!archiveFile)
+        {
+            throw std::runtime_error("cannot write file ["+temporaryFilename+"].");
+        }
+    }
+    fs::rename(temporaryFilename, filename);
+}
+
+}
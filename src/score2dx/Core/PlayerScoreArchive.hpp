@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "score2dx/Core/MappedFile.hpp"
+#include "score2dx/Core/MusicDatabase.hpp"
+#include "score2dx/Score/MusicScore.hpp"
+#include "score2dx/Score/PlayerScore.hpp"
+
+namespace score2dx
+{
+
+const std::string PlayerScoreArchiveExtension{".s2pa"};
+
+//! @brief Fixed size record of a MusicScore in PlayerScoreArchive.
+struct ArchiveMusicScoreRecord
+{
+    std::uint32_t MusicId{0};
+    std::uint32_t PlayCount{0};
+    //! @brief DateTime "YYYY-MM-DD HH:MM" packed as bits of YYYY(12)|MM(4)|DD(5)|HH(5)|MM(6), 0 if empty.
+    //! Order of packed values is same as order of DateTime strings.
+    std::uint32_t PackedDateTime{0};
+    //! @brief Index of first ArchiveChartScoreRecord, records of enabled difficulties are consecutive
+    //! in Difficulty order.
+    std::uint32_t ChartScoreBegin{0};
+    std::uint8_t ScoreVersionIndex{0};
+    std::uint8_t PlayStyle{0};
+    std::uint8_t ScoreSource{0};
+    //! @brief Bit of Difficulty is set if ChartScore of difficulty is enabled.
+    std::uint8_t DifficultyMask{0};
+};
+
+//! @brief Fixed size record of a ChartScore in PlayerScoreArchive.
+struct ArchiveChartScoreRecord
+{
+    std::uint16_t ExScore{0};
+    std::uint16_t PGreatCount{0};
+    std::uint16_t GreatCount{0};
+    //! @brief ArchiveNoMissCount if MissCount is nullopt.
+    std::uint16_t MissCount{0};
+    std::uint8_t Level{0};
+    std::uint8_t ClearType{0};
+    std::uint8_t DjLevel{0};
+    std::uint8_t Reserved{0};
+};
+
+constexpr std::uint16_t ArchiveNoMissCount = 0xFFFF;
+
+//! @brief Read-only view of score2dx binary player score archive, holds all MusicScores of a PlayerScore
+//! (both play styles and all score versions).
+//! Layout:
+//!     Header {Magic "S2PA", FormatVersion, ByteOrderMark, MusicScoreCount, ChartScoreCount, IidxId[12],
+//!             DatabaseSourceHash}
+//!     ArchiveMusicScoreRecord[MusicScoreCount]
+//!     ArchiveChartScoreRecord[ChartScoreCount]
+//! Archive file is memory mapped and records are used in place, only header is validated when opening.
+//! MusicIds are only valid in database written with, archive is identified by MusicDatabase::GetSourceHash
+//! of that database, same as CsvCache.
+//! @note Byte order is native, archive of other byte order is rejected.
+class PlayerScoreArchive
+{
+public:
+    //! @brief Map archive file, throws if it's not an archive of supported format, sizes are inconsistent,
+    //! or it's written with other database than musicDatabase.
+        PlayerScoreArchive(const std::string &filename,
+                           const MusicDatabase &musicDatabase);
+
+        const std::string &
+        GetIidxId()
+        const;
+
+    //! @brief Records in order of {MusicId, PlayStyle, ScoreVersionIndex, DateTime}.
+        std::span<const ArchiveMusicScoreRecord>
+        GetMusicScoreRecords()
+        const;
+
+    //! @brief Build MusicScore of record, throws if record is invalid.
+        MusicScore
+        ToMusicScore(const ArchiveMusicScoreRecord &record)
+        const;
+
+    //! @brief Get vector of {ScoreVersionIndex, MusicScore} of all records.
+        std::vector<std::pair<std::size_t, MusicScore>>
+        GetMusicScores()
+        const;
+
+    //! @brief Build PlayerScore of all records, throws if musicDatabase is not database of archive,
+    //! or music of any record does not exist in musicDatabase.
+    //! @note Does not propagate, same as PlayerScore::AddMusicScore.
+        PlayerScore
+        ToPlayerScore(std::shared_ptr<const MusicDatabase> musicDatabase)
+        const;
+
+private:
+    MappedFile mFile;
+    std::string mIidxId;
+    std::uint64_t mDatabaseSourceHash{0};
+    std::span<const ArchiveMusicScoreRecord> mMusicScoreRecords;
+    std::span<const ArchiveChartScoreRecord> mChartScoreRecords;
+};
+
+//! @brief Write all MusicScores of playerScore to archive file of playerScore's database, see PlayerScoreArchive.
+//! File is written to temporary file then renamed, reader never sees partially written archive.
+//! Throws if a score cannot be represented in archive (e.g. DateTime is not "YYYY-MM-DD HH:MM").
+void
+WritePlayerScoreArchive(const PlayerScore &playerScore,
+                        const std::string &filename);
+
+}
@@ -0,0 +1,178 @@
+#include "score2dx/Core/PlayerScoreArchive.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ies/Common/IntegralRangeUsing.hpp"
+
+#include "score2dx/Core/Core.hpp"
+#include "score2dx/Core/TestUtil.hpp"
+#include "score2dx/Iidx/Version.hpp"
+
+namespace fs = std::filesystem;
+
+namespace score2dx
+{
+
+namespace
+{
+
+void
+ExpectSamePlayerScore(const PlayerScore &expected, const PlayerScore &actual)
+{
+    ASSERT_EQ(expected.GetIidxId(), actual.GetIidxId());
+    ASSERT_EQ(expected.GetVersionScoreTables().size(), actual.GetVersionScoreTables().size());
+    for (auto &[musicId, expectedTable] : expected.GetVersionScoreTables())
+    {
+        auto &actualTable = actual.GetVersionScoreTables().at(musicId);
+        for (auto playStyle : PlayStyleSmartEnum::ToRange())
+        {
+            for (auto scoreVersionIndex : IndexRange{0, VersionNames.size()})
+            {
+                auto &expectedScores = expectedTable.GetMusicScores(scoreVersionIndex, playStyle);
+                auto &actualScores = actualTable.GetMusicScores(scoreVersionIndex, playStyle);
+                ASSERT_EQ(expectedScores.size(), actualScores.size());
+                for (auto &[dateTime, expectedScore] : expectedScores)
+                {
+                    auto &actualScore = actualScores.at(dateTime);
+                    EXPECT_EQ(expectedScore.GetDateTime(), actualScore.GetDateTime());
+                    EXPECT_EQ(expectedScore.GetPlayCount(), actualScore.GetPlayCount());
+                    EXPECT_EQ(expectedScore.GetScoreSource(), actualScore.GetScoreSource());
+                    for (auto difficulty : DifficultySmartEnum::ToRange())
+                    {
+                        auto* expectedChartScore = expectedScore.GetChartScore(difficulty);
+                        auto* actualChartScore = actualScore.GetChartScore(difficulty);
+                        ASSERT_EQ(expectedChartScore==nullptr, actualChartScore==nullptr);
+                        if (expectedChartScore) { EXPECT_EQ(*expectedChartScore, *actualChartScore); }
+                    }
+                }
+            }
+        }
+    }
+}
+
+}
+
+TEST(PlayerScoreArchive, RejectInvalidFile)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase)
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    auto path = fs::temp_directory_path()/("score2dx_invalid_archive"+PlayerScoreArchiveExtension);
+    {
+        std::ofstream file{path, std::ios::binary|std::ios::trunc};
+        file << "S2PA but not an archive.";
+    }
+
+    EXPECT_THROW((PlayerScoreArchive{path.string(), *musicDatabase}), std::runtime_error);
+    fs::remove(path);
+}
+
+TEST(PlayerScoreArchive, SameAsJsonExport)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase)
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    const std::string iidxId{"5483-7391"};
+    TestDirectory testDirectory{"score2dx_player_score_archive_test", {"json", "archive", "expected", "actual"}};
+    auto &directory = testDirectory.GetPath();
+
+    //'' scores of musics of BISTROVER in CastHour and RESIDENT.
+    std::vector<std::string> exportedFilenames;
+    for (auto playStyle : PlayStyleSmartEnum::ToRange())
+    {
+        auto path = directory/"json"/("score2dx_export_"+ToString(static_cast<PlayStyleAcronym>(playStyle))+"_2023-11-04.json");
+        exportedFilenames.emplace_back(WriteExportedJson(*musicDatabase, iidxId, playStyle, {"2021-12-04 15:33", "2022-05-01 09:05", "2023-03-05 21:15"}, path, 8));
+    }
+
+    Core expectedCore{musicDatabase};
+    for (auto &exportedFilename : exportedFilenames)
+    {
+        expectedCore.Import(iidxId, exportedFilename);
+    }
+    expectedCore.ExportArchive(iidxId, (directory/"archive").string());
+    auto archivePath = FindSingleFile(directory/"archive", PlayerScoreArchiveExtension);
+
+    PlayerScoreArchive archive{archivePath.string(), *musicDatabase};
+    EXPECT_EQ(iidxId, archive.GetIidxId());
+    EXPECT_FALSE(archive.GetMusicScoreRecords().empty());
+    ExpectSamePlayerScore(expectedCore.GetPlayerScore(iidxId), archive.ToPlayerScore(musicDatabase));
+
+    Core actualCore{musicDatabase};
+    actualCore.ImportArchive(iidxId, archivePath.string());
+    ExpectSamePlayerScore(expectedCore.GetPlayerScore(iidxId), actualCore.GetPlayerScore(iidxId));
+
+    for (auto playStyle : PlayStyleSmartEnum::ToRange())
+    {
+        expectedCore.Export(iidxId, playStyle, (directory/"expected").string());
+        actualCore.Export(iidxId, playStyle, (directory/"actual").string());
+    }
+    for (auto &entry : fs::directory_iterator{directory/"expected"})
+    {
+        auto expectedJson = ReadFile(entry.path());
+        EXPECT_NE(std::string::npos, expectedJson.find("\"score\""));
+        EXPECT_EQ(expectedJson, ReadFile(directory/"actual"/entry.path().filename()));
+    }
+
+}
+
+TEST(PlayerScoreArchive, RejectOtherDatabase)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase||!fs::exists(DefaultMusicDatabaseFilename))
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    const std::string iidxId{"5483-7391"};
+    TestDirectory testDirectory{"score2dx_player_score_archive_database_test", {"json", "archive", "unknown"}};
+    auto &directory = testDirectory.GetPath();
+    auto exportedFilename = WriteExportedJson(*musicDatabase, iidxId, PlayStyle::SinglePlay, {"2023-03-05 21:15"}, directory/"json"/"score2dx_export_SP_2023-03-05.json");
+    Core core{musicDatabase};
+    core.Import(iidxId, exportedFilename);
+    core.ExportArchive(iidxId, (directory/"archive").string());
+    auto archivePath = FindSingleFile(directory/"archive", PlayerScoreArchiveExtension);
+
+    //'' archive of other database source is rejected, MusicIds may refer to other musics.
+    auto databasePath = directory/fs::path{DefaultMusicDatabaseFilename}.filename();
+    fs::copy_file(DefaultMusicDatabaseFilename, databasePath);
+    std::ofstream{databasePath, std::ios::app} << "\n";
+    MusicDatabaseOptions options;
+    options.UseSnapshot = false;
+    auto otherDatabase = std::make_shared<const MusicDatabase>(databasePath.string(), options);
+    ASSERT_NE(musicDatabase->GetSourceHash(), otherDatabase->GetSourceHash());
+    EXPECT_THROW((PlayerScoreArchive{archivePath.string(), *otherDatabase}), std::runtime_error);
+    EXPECT_THROW(PlayerScoreArchive(archivePath.string(), *musicDatabase).ToPlayerScore(otherDatabase), std::runtime_error);
+    Core otherCore{otherDatabase};
+    EXPECT_THROW(otherCore.ImportArchive(iidxId, archivePath.string()), std::runtime_error);
+    EXPECT_TRUE(otherCore.GetPlayerScores().empty());
+
+    //'' archive having unknown music is rejected before any score is merged.
+    auto archive = ReadFile(archivePath);
+    auto lastRecord = PlayerScoreArchive{archivePath.string(), *musicDatabase}.GetMusicScoreRecords().back();
+    auto recordOffset = archive.find(std::string{reinterpret_cast<const char*>(&lastRecord), sizeof(lastRecord)});
+    ASSERT_NE(std::string::npos, recordOffset);
+    auto unknownMusicId = static_cast<std::uint32_t>(ToMusicId(TestMusicVersionIndex, 999));
+    std::memcpy(archive.data()+recordOffset, &unknownMusicId, sizeof(unknownMusicId));
+    auto unknownArchivePath = directory/"unknown"/archivePath.filename();
+    std::ofstream{unknownArchivePath, std::ios::binary} << archive;
+
+    Core unknownCore{musicDatabase};
+    EXPECT_THROW(unknownCore.ImportArchive(iidxId, unknownArchivePath.string()), std::runtime_error);
+    EXPECT_TRUE(unknownCore.GetPlayerScores().empty());
+}
+
+}
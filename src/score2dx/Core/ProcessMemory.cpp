@@ -0,0 +1,38 @@
+#include "score2dx/Core/ProcessMemory.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+namespace score2dx
+{
+
+std::size_t
+GetProcessMemoryUsage()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    //'' K32 variant is exported by kernel32, not require linking psapi.
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+    return static_cast<std::size_t>(counters.WorkingSetSize);
+#else
+    //'' statm: size resident shared text lib data dt, in pages.
+    std::ifstream statmFile{"/proc/self/statm"};
+    std::size_t totalPages = 0;
+    std::size_t residentPages = 0;
+    if (!(statmFile >> totalPages >> residentPages))
+    {
+        return 0;
+    }
+    return residentPages*static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+}
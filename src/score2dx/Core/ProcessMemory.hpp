@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+namespace score2dx
+{
+
+//! @brief Get current process resident memory (working set) in bytes.
+//! @return 0 if not supported on platform or query failed.
+std::size_t
+GetProcessMemoryUsage();
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+
+namespace score2dx
+{
+
+//! @brief Transparent hash of std::string key, allow unordered containers to find by std::string_view
+//! without constructing std::string. Use with StringViewEqual.
+struct StringViewHash
+{
+    using is_transparent = std::true_type;
+
+    std::size_t operator()(std::string_view sv) const noexcept
+    {
+        return std::hash<std::string_view>()(sv);
+    }
+};
+
+//! @brief Transparent equal of std::string key, use with StringViewHash.
+struct StringViewEqual
+{
+    using is_transparent = std::true_type;
+
+    bool operator()(std::string_view l, std::string_view r) const noexcept
+    {
+        return l==r;
+    }
+};
+
+}
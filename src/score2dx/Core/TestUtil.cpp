@@ -0,0 +1,244 @@
+#include "score2dx/Core/TestUtil.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "fmt/format.h"
+
+#include "ies/Common/IntegralRangeUsing.hpp"
+
+#include "score2dx/Core/ActiveVersion.hpp"
+#include "score2dx/Csv/CsvColumn.hpp"
+#include "score2dx/Iidx/Version.hpp"
+
+namespace fs = std::filesystem;
+
+namespace score2dx
+{
+
+std::shared_ptr<const MusicDatabase>
+FindTestMusicDatabase()
+{
+    try
+    {
+        return GetSharedMusicDatabase();
+    }
+    catch (const std::exception &)
+    {
+        return nullptr;
+    }
+}
+
+std::string
+ReadFile(const fs::path &path)
+{
+    std::ifstream file{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+fs::path
+FindSingleFile(const fs::path &directory,
+               const std::string &extension)
+{
+    std::vector<fs::path> paths;
+    for (auto &entry : fs::directory_iterator{directory})
+    {
+        if (entry.path().extension()==extension) { paths.emplace_back(entry.path()); }
+    }
+    if (paths.size()!=1)
+    {
+        throw std::runtime_error("expect single ["+extension+"] file in ["+directory.string()+"].");
+    }
+    return paths.front();
+}
+
+TestDirectory::
+TestDirectory(const std::string &name,
+              std::initializer_list<std::string> subDirectories)
+:   mPath(fs::temp_directory_path()/name)
+{
+    fs::remove_all(mPath);
+    fs::create_directories(mPath);
+    for (auto &subDirectory : subDirectories)
+    {
+        fs::create_directories(mPath/subDirectory);
+    }
+}
+
+TestDirectory::
+~TestDirectory()
+{
+    std::error_code errorCode;
+    fs::remove_all(mPath, errorCode);
+}
+
+const fs::path &
+TestDirectory::
+GetPath()
+const
+{
+    return mPath;
+}
+
+Json
+MakeExportedJson(const MusicDatabase &musicDatabase,
+                 const std::string &iidxId,
+                 PlayStyle playStyle,
+                 const std::vector<std::string> &dateTimes,
+                 std::size_t musicCount)
+{
+    Json exported;
+    exported["metadata"]["id"] = iidxId;
+    exported["metadata"]["playStyle"] = ToString(playStyle);
+
+    auto &musics = musicDatabase.GetAllTimeMusics().at(TestMusicVersionIndex);
+    for (auto musicIndex : IndexRange{0, std::min(musics.size(), musicCount)})
+    {
+        auto musicId = ToMusicId(TestMusicVersionIndex, musicIndex);
+        for (auto dateTimeIndex : IndexRange{0, dateTimes.size()})
+        {
+            auto &dateTime = dateTimes[dateTimeIndex];
+            auto* activeVersion = musicDatabase.FindActiveVersion(FindVersionIndexFromDateTime(dateTime).value());
+            if (!activeVersion)
+            {
+                throw std::runtime_error("no active version of ["+dateTime+"].");
+            }
+
+            auto &scoreJson = exported["data"][VersionNames[TestMusicVersionIndex]][musicDatabase.GetTitle(musicId)][dateTime];
+            scoreJson["play"] = musicIndex+dateTimeIndex+1;
+            scoreJson["score"] = Json::object();
+            for (auto difficulty : activeVersion->GetAvailableCharts(musicId, playStyle))
+            {
+                auto pgreat = static_cast<int>(musicIndex*37+dateTimeIndex*5+static_cast<std::size_t>(difficulty));
+                auto great = static_cast<int>(difficulty)*11;
+                auto miss = musicIndex%3==0 ? std::string{"---"} : std::to_string(musicIndex);
+                scoreJson["score"][ToString(static_cast<DifficultyAcronym>(difficulty))] = std::vector<std::string>
+                {
+                    std::to_string(pgreat*2+great),
+                    std::to_string(pgreat),
+                    std::to_string(great),
+                    miss,
+                    ToString(musicIndex%2 ? ClearType::HARD_CLEAR : ClearType::EASY_CLEAR),
+                    "---"
+                };
+            }
+        }
+    }
+
+    return exported;
+}
+
+std::string
+WriteExportedJson(const MusicDatabase &musicDatabase,
+                  const std::string &iidxId,
+                  PlayStyle playStyle,
+                  const std::vector<std::string> &dateTimes,
+                  const fs::path &path,
+                  std::size_t musicCount)
+{
+    std::ofstream{path} << MakeExportedJson(musicDatabase, iidxId, playStyle, dateTimes, musicCount).dump();
+    return path.string();
+}
+
+std::string
+MakeCsvContent(const MusicDatabase &musicDatabase,
+               PlayStyle playStyle,
+               std::size_t activeVersionIndex,
+               const std::string &date,
+               std::size_t seed)
+{
+    std::string content;
+    for (auto columnIndex : IndexRange{0, CsvColumnSize})
+    {
+        content += (columnIndex==0 ? "" : ",")+fmt::format("Column{}", columnIndex);
+    }
+    content += "\n";
+
+    std::size_t rowIndex = 0;
+    auto &allTimeMusics = musicDatabase.GetAllTimeMusics();
+    for (auto versionIndex : IndexRange{2, activeVersionIndex+1})
+    {
+        for (auto musicIndex : IndexRange{0, allTimeMusics[versionIndex].size()})
+        {
+            auto musicId = ToMusicId(versionIndex, musicIndex);
+            auto &title = musicDatabase.GetTitle(musicId);
+            if (title.find_first_of(",\"")!=std::string::npos
+                ||musicDatabase.FindCsvMusicId(versionIndex, title)!=musicId)
+            {
+                continue;
+            }
+
+            std::string chartColumns;
+            bool isAvailable = false;
+            for (auto difficulty : DifficultySmartEnum::ToRange())
+            {
+                auto styleDifficulty = ConvertToStyleDifficulty(playStyle, difficulty);
+                auto findChartInfo = musicDatabase.FindChartInfo(musicId, styleDifficulty, activeVersionIndex);
+                if (!findChartInfo)
+                {
+                    chartColumns += ",0,0,0,0,---,NO PLAY,---";
+                    continue;
+                }
+
+                isAvailable = true;
+                auto difficultyIndex = static_cast<std::size_t>(difficulty);
+                auto note = static_cast<std::size_t>(std::max(findChartInfo->Note, 1));
+                auto pgreat = (musicIndex*37+difficultyIndex*5+seed*13)%note;
+                auto great = std::min(difficultyIndex*11+seed, note-pgreat);
+                auto clearType = (musicIndex+seed)%2 ? ClearType::HARD_CLEAR : ClearType::EASY_CLEAR;
+                chartColumns += fmt::format(",{},{},{},{},{},{},---",
+                                            findChartInfo->Level, pgreat*2+great, pgreat, great,
+                                            (musicIndex+seed)%3==0 ? std::string{"---"} : std::to_string(musicIndex%10),
+                                            ToSpaceSeparated(clearType));
+            }
+            if (!isAvailable) { continue; }
+
+            content += fmt::format("{},{},GENRE,ARTIST,{}{},{} {:02}:{:02}\n",
+                                   VersionNames[versionIndex], title, musicIndex+seed+1, chartColumns,
+                                   date, rowIndex/60%24, rowIndex%60);
+            ++rowIndex;
+        }
+    }
+
+    return content;
+}
+
+std::string
+WriteCsv(const MusicDatabase &musicDatabase,
+         PlayStyle playStyle,
+         std::size_t activeVersionIndex,
+         const std::string &date,
+         const fs::path &path,
+         std::size_t seed)
+{
+    std::ofstream{path, std::ios::binary} << MakeCsvContent(musicDatabase, playStyle, activeVersionIndex, date, seed);
+    return path.string();
+}
+
+std::string
+ToTestString(const MusicScore &musicScore)
+{
+    auto text = std::to_string(musicScore.GetPlayCount())+" "+musicScore.GetDateTime();
+    for (auto &[difficulty, chartScore] : musicScore.GetChartScores())
+    {
+        text += " "+ToString(difficulty)+": "+ToString(*chartScore);
+    }
+    return text;
+}
+
+std::string
+ToTestString(const Csv &csv)
+{
+    auto text = fmt::format("{} {} {} {} {} {}\n",
+                            csv.GetFilename(), ToString(csv.GetPlayStyle()), csv.GetVersion(), csv.GetVersionIndex(),
+                            csv.GetLastDateTime(), csv.GetTotalPlayCount());
+    for (auto &[musicId, musicScore] : csv.GetScores())
+    {
+        text += ToMusicIdString(musicId)+" "+ToTestString(musicScore)+"\n";
+    }
+    return text;
+}
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "score2dx/Core/JsonDefinition.hpp"
+#include "score2dx/Core/MusicDatabase.hpp"
+#include "score2dx/Csv/Csv.hpp"
+#include "score2dx/Iidx/Definition.hpp"
+#include "score2dx/Score/MusicScore.hpp"
+
+namespace score2dx
+{
+
+//! @brief VersionIndex of musics in generated test data (BISTROVER).
+constexpr std::size_t TestMusicVersionIndex = 28;
+
+//! @brief Shared MusicDatabase for tests, nullptr if it's not available (test should skip).
+std::shared_ptr<const MusicDatabase>
+FindTestMusicDatabase();
+
+std::string
+ReadFile(const std::filesystem::path &path);
+
+//! @brief Get the only file of extension in directory, throws if there is none or more.
+std::filesystem::path
+FindSingleFile(const std::filesystem::path &directory,
+               const std::string &extension);
+
+//! @brief Empty directory of name in temp directory with subDirectories, removed with its content at destruction.
+class TestDirectory
+{
+public:
+        explicit TestDirectory(const std::string &name,
+                               std::initializer_list<std::string> subDirectories={});
+
+        ~TestDirectory();
+
+        TestDirectory(const TestDirectory &) = delete;
+        TestDirectory &
+        operator=(const TestDirectory &) = delete;
+
+        const std::filesystem::path &
+        GetPath()
+        const;
+
+private:
+    std::filesystem::path mPath;
+};
+
+//! @brief Make exported Json of playStyle, scores of first musicCount musics of TestMusicVersionIndex at each
+//! dateTime, of charts available at version of dateTime. Score values differ by music, difficulty and dateTime.
+Json
+MakeExportedJson(const MusicDatabase &musicDatabase,
+                 const std::string &iidxId,
+                 PlayStyle playStyle,
+                 const std::vector<std::string> &dateTimes,
+                 std::size_t musicCount=4);
+
+//! @brief Write MakeExportedJson to path.
+//! @return path string.
+std::string
+WriteExportedJson(const MusicDatabase &musicDatabase,
+                  const std::string &iidxId,
+                  PlayStyle playStyle,
+                  const std::vector<std::string> &dateTimes,
+                  const std::filesystem::path &path,
+                  std::size_t musicCount=4);
+
+//! @brief Make official CSV content of playStyle at activeVersionIndex: header line and a row of each music of
+//! version [2, activeVersionIndex] available at activeVersionIndex, in version order. Rows are played at date,
+//! score values differ by music, difficulty and seed. Titles having comma or quote are skipped.
+std::string
+MakeCsvContent(const MusicDatabase &musicDatabase,
+               PlayStyle playStyle,
+               std::size_t activeVersionIndex,
+               const std::string &date,
+               std::size_t seed=0);
+
+//! @brief Write MakeCsvContent to path.
+//! @return path string.
+std::string
+WriteCsv(const MusicDatabase &musicDatabase,
+         PlayStyle playStyle,
+         std::size_t activeVersionIndex,
+         const std::string &date,
+         const std::filesystem::path &path,
+         std::size_t seed=0);
+
+//! @brief Play count, DateTime and enabled chart scores of musicScore in text, to compare parsed scores.
+std::string
+ToTestString(const MusicScore &musicScore);
+
+//! @brief Summary (except path) and scores of csv in text, to compare parsed results.
+std::string
+ToTestString(const Csv &csv);
+
+}
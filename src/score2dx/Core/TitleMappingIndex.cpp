@@ -0,0 +1,83 @@
+#include "score2dx/Core/TitleMappingIndex.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#include "score2dx/Core/BinaryStream.hxx"
+
+namespace score2dx
+{
+
+TitleMappingIndex::
+TitleMappingIndex(std::vector<TitleMapping> mappings)
+{
+    std::stable_sort(mappings.begin(), mappings.end(),
+        [](const TitleMapping &lhs, const TitleMapping &rhs)
+        {
+            if (lhs.Section!=rhs.Section) { return lhs.Section<rhs.Section; }
+            return lhs.Title<rhs.Title;
+        }
+    );
+
+    if (mappings.size()>=UINT32_MAX/2)
+    {
+        throw std::runtime_error("TitleMappingIndex: too many mappings.");
+    }
+
+    mMappings.reserve(mappings.size());
+    mSlots.assign(std::bit_ceil(std::max<std::size_t>(mappings.size()*2, 1)), 0);
+    auto mask = mSlots.size()-1;
+
+    for (auto &mapping : mappings)
+    {
+        auto slotIndex = ToFnv1aHash(mapping.Title)&mask;
+        auto isDuplicated = false;
+        while (mSlots[slotIndex]!=0)
+        {
+            if (mMappings[mSlots[slotIndex]-1].Title==mapping.Title)
+            {
+                isDuplicated = true;
+                break;
+            }
+            slotIndex = (slotIndex+1)&mask;
+        }
+
+        if (isDuplicated) { continue; }
+
+        mMappings.emplace_back(std::move(mapping));
+        mSlots[slotIndex] = static_cast<std::uint32_t>(mMappings.size());
+    }
+}
+
+const TitleMapping*
+TitleMappingIndex::
+Find(std::string_view title)
+const
+{
+    if (mMappings.empty()) { return nullptr; }
+
+    auto mask = mSlots.size()-1;
+    auto slotIndex = ToFnv1aHash(title)&mask;
+    while (mSlots[slotIndex]!=0)
+    {
+        auto &mapping = mMappings[mSlots[slotIndex]-1];
+        if (mapping.Title==title)
+        {
+            return &mapping;
+        }
+        slotIndex = (slotIndex+1)&mask;
+    }
+
+    return nullptr;
+}
+
+const std::vector<TitleMapping> &
+TitleMappingIndex::
+GetMappings()
+const
+{
+    return mMappings;
+}
+
+}
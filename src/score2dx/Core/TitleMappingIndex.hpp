@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ies/Common/SmartEnum.hxx"
+
+namespace score2dx
+{
+
+//! @brief Sections of database titleMapping, in lookup priority order.
+//! @see MusicDatabase::FindDbTitle for meaning of sections.
+IES_SMART_ENUM(TitleMappingSection,
+    csv,
+    display,
+    wiki
+);
+
+struct TitleMapping
+{
+    std::string Title;
+    std::string DbTitle;
+    TitleMappingSection Section{TitleMappingSection::csv};
+};
+
+//! @brief Immutable open addressing (linear probing) hash index of {Title, TitleMapping}.
+//! Lookup by string_view, does not allocate.
+class TitleMappingIndex
+{
+public:
+        TitleMappingIndex() = default;
+
+    //! @brief Build index from mappings. If a title appears more than once,
+    //! the mapping with higher priority section is kept (csv > display > wiki).
+        explicit TitleMappingIndex(std::vector<TitleMapping> mappings);
+
+    //! @return nullptr if title has no mapping.
+        const TitleMapping*
+        Find(std::string_view title)
+        const;
+
+    //! @brief Vector of {Index=EntryIndex, TitleMapping}, sorted by section then title.
+        const std::vector<TitleMapping> &
+        GetMappings()
+        const;
+
+private:
+    std::vector<TitleMapping> mMappings;
+
+    //! @brief Vector of {Index=SlotIndex, EntryIndex+1}, 0 denotes empty slot.
+    //! @note Size is power of two and at least twice of mapping count.
+    std::vector<std::uint32_t> mSlots;
+};
+
+}
@@ -0,0 +1,35 @@
+#include "score2dx/Core/TitleMappingIndex.hpp"
+
+#include <gtest/gtest.h>
+
+namespace score2dx
+{
+
+TEST(TitleMappingIndex, Find)
+{
+    TitleMappingIndex index
+    {
+        {
+            {"Anisakis -somatic mutation type\"Forza\"-", "Anisakis -somatic mutation type \"Forza\"-", TitleMappingSection::wiki},
+            {"quell～the seventh slave～", "quell~the seventh slave~", TitleMappingSection::csv},
+            {"quell～the seventh slave～", "quell the seventh slave", TitleMappingSection::wiki},
+            {"LOVE♡SHINE", "LOVE SHINE", TitleMappingSection::display}
+        }
+    };
+
+    auto* csvMapping = index.Find("quell～the seventh slave～");
+    ASSERT_NE(nullptr, csvMapping);
+    EXPECT_EQ("quell~the seventh slave~", csvMapping->DbTitle);
+    EXPECT_EQ(TitleMappingSection::csv, csvMapping->Section);
+
+    auto* displayMapping = index.Find("LOVE♡SHINE");
+    ASSERT_NE(nullptr, displayMapping);
+    EXPECT_EQ("LOVE SHINE", displayMapping->DbTitle);
+    EXPECT_EQ(TitleMappingSection::display, displayMapping->Section);
+
+    EXPECT_EQ(3u, index.GetMappings().size());
+    EXPECT_EQ(nullptr, index.Find("LOVE SHINE"));
+    ASSERT_EQ(nullptr, TitleMappingIndex{}.Find("LOVE♡SHINE"));
+}
+
+}
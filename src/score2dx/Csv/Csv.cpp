@@ -2,18 +2,25 @@
 
 #include <algorithm>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
+#include <istream>
 #include <map>
+#include <optional>
 #include <set>
 #include <string_view>
 #include <sstream>
+#include <vector>
 
 #include "ies/Common/SmartEnum.hxx"
 #include "ies/StdUtil/MapApply.hxx"
 #include "ies/Time/ScopeTimePrinter.hxx"
 
+#include "score2dx/Core/BinaryStream.hxx"
+#include "score2dx/Core/MappedFile.hpp"
+#include "score2dx/Core/ParallelFor.hxx"
 #include "score2dx/Csv/CsvColumn.hpp"
+#include "score2dx/Csv/CsvRowTokenizer.hpp"
+#include "score2dx/Csv/CsvStreamParser.hpp"
 #include "score2dx/Iidx/Definition.hpp"
 #include "score2dx/Iidx/Version.hpp"
 #include "score2dx/Score/MusicScore.hpp"
@@ -24,6 +31,249 @@ namespace fs = std::filesystem;
 namespace score2dx
 {
 
+namespace
+{
+
+//! @brief Minimum bytes of rows per chunk, smaller CSV is parsed by fewer workers.
+constexpr std::size_t MinCsvChunkSize = 64*1024;
+
+//! @brief Bytes read from stream at a time by Csv(std::istream&).
+constexpr std::size_t CsvStreamBlockSize = 64*1024;
+
+//! @brief Rows of CSV content parsed independently, merged into Csv in chunk order.
+struct CsvChunk
+{
+    std::string_view Content;
+
+    std::vector<MusicScore> MusicScores;
+    //'' Map of {VersionIndex, MusicCount}.
+    std::map<std::size_t, int> VersionMusicCounts;
+    //! @brief Version of last parsed row, empty if no row is parsed.
+    std::optional<std::size_t> LastVersionIndex;
+    std::size_t TotalPlayCount{0};
+    //'' views into CSV content, content outlives chunks.
+    std::string_view MinDateTime;
+    std::string_view MaxDateTime;
+
+    //! @brief Count of non-empty lines visited, including failed line.
+    int LineCount{0};
+    //! @brief Error of first failed line, empty if all lines are parsed.
+    std::string Error;
+    std::string_view ErrorLine;
+
+    //'' console output of chunk, printed in chunk order after all chunks are parsed.
+    std::ostringstream Output;
+    std::ostringstream ErrorOutput;
+};
+
+//! @brief Split content at line boundaries into at most chunkCount chunks of similar size.
+std::vector<CsvChunk>
+SplitCsvChunks(std::string_view content, std::size_t chunkCount)
+{
+    std::vector<CsvChunk> chunks(std::max<std::size_t>(chunkCount, 1));
+    std::size_t begin = 0;
+    std::size_t usedCount = 0;
+    for (std::size_t i = 0; i<chunks.size()&&begin<content.size(); ++i)
+    {
+        auto end = content.size();
+        if (i+1<chunks.size())
+        {
+            auto newline = content.find('\n', std::max(begin, content.size()*(i+1)/chunks.size()));
+            end = newline==std::string_view::npos ? content.size() : newline+1;
+        }
+        chunks[i].Content = content.substr(begin, end-begin);
+        begin = end;
+        ++usedCount;
+    }
+    chunks.resize(usedCount);
+    return chunks;
+}
+
+void
+ParseCsvChunk(CsvChunk &chunk,
+              const MusicDatabase &musicDatabase,
+              PlayStyle playStyle,
+              std::size_t activeVersionIndex,
+              bool checkWithDatabase)
+{
+    CsvRowTokenizer tokenizer{chunk.Content};
+    CsvRowToken row;
+    CsvParser parser;
+
+    try
+    {
+        while (tokenizer.Next(row))
+        {
+            ++chunk.LineCount;
+            auto csvMusic = parser.ParseRow(row);
+
+            if (csvMusic.CsvVersionIndex==0)
+            {
+                chunk.ErrorOutput << "Cannot find version for line [" << row.Line << "], skipped.\n";
+                continue;
+            }
+
+            auto findMusicId = musicDatabase.FindCsvMusicId(csvMusic.CsvVersionIndex, csvMusic.Title);
+            if (!findMusicId)
+            {
+                //'' new music of latest version is rejected by the single lookup, 1st&substream is never latest.
+                if (csvMusic.CsvVersionIndex==GetLatestVersionIndex())
+                {
+                    chunk.Output << "Possible ["+ToVersionString(csvMusic.CsvVersionIndex)+"] new music title ["+std::string{csvMusic.Title}+"] not in database, skipped.\n";
+                    continue;
+                }
+
+                auto dbTitle = musicDatabase.FindCsvDbTitle(csvMusic.Title).value_or(std::string{csvMusic.Title});
+                if (csvMusic.CsvVersionIndex==1)
+                {
+                    throw std::runtime_error("cannot find Ver["+ToVersionString(csvMusic.CsvVersionIndex)+"] title "+dbTitle+" version index.");
+                }
+                throw std::runtime_error("music title ["+dbTitle+"] is not listed in it's version ["+ToVersionString(csvMusic.CsvVersionIndex)+"] in database");
+            }
+
+            auto musicId = findMusicId.value();
+            auto versionIndex = GetVersionIndex(musicId);
+            //'' database title is only needed by checkWithDatabase messages.
+            std::string_view dbTitle;
+            if (checkWithDatabase)
+            {
+                dbTitle = musicDatabase.GetTitle(musicId);
+            }
+
+            /*
+            if (checkWithDatabase)
+            {
+                auto musicId = ToMusicId(versionIndex, musicIndex);
+                auto musicInfo = musicDatabase.GetLatestMusicInfo(musicId);
+
+                auto &dbArtist = musicInfo.GetField(MusicInfoField::Artist);
+                auto &csvArtist = columns[static_cast<std::size_t>(CsvMusicColumn::Artist)];
+                if (csvArtist!=dbArtist)
+                {
+                    chunk.Output << "[" << dbTitle << "] artist mismatch:\n"
+                              << "CSV [" << csvArtist << "]\n"
+                              << "DB [" << dbArtist << "]\n";
+                }
+
+                auto &dbGenre = musicInfo.GetField(MusicInfoField::Genre);
+                auto &csvGenre = columns[static_cast<std::size_t>(CsvMusicColumn::Genre)];
+                if (csvGenre!=dbGenre)
+                {
+                    chunk.Output << "[" << dbTitle << "] genre mismatch:\n"
+                              << "CSV [" << csvGenre << "]\n"
+                              << "DB [" << dbGenre << "]\n";
+                }
+            }
+            */
+
+            chunk.LastVersionIndex = versionIndex;
+            ies::MapIncrementCount(chunk.VersionMusicCounts, versionIndex);
+
+            chunk.TotalPlayCount += csvMusic.PlayCount;
+
+            auto &dateTime = csvMusic.DateTime;
+            if (chunk.MaxDateTime.empty() || dateTime>chunk.MaxDateTime)
+            {
+                chunk.MaxDateTime = dateTime;
+            }
+            if (chunk.MinDateTime.empty() || dateTime<chunk.MinDateTime)
+            {
+                chunk.MinDateTime = dateTime;
+            }
+
+            auto &musicScore = chunk.MusicScores.emplace_back(musicId, playStyle, csvMusic.PlayCount, std::string{dateTime}, ScoreSource::OfficialCsv);
+
+            for (auto difficulty : DifficultySmartEnum::ToRange())
+            {
+                auto difficultyIndex = static_cast<std::size_t>(difficulty);
+                auto &csvChartScore = csvMusic.ChartScores[difficultyIndex];
+
+                if (csvChartScore.Level==0)
+                {
+                    continue;
+                }
+
+                auto &chartScore = musicScore.EnableChartScore(difficulty);
+                chartScore = csvChartScore;
+
+                if (checkWithDatabase)
+                {
+                    auto styleDifficulty = ConvertToStyleDifficulty(playStyle, difficulty);
+                    auto findChartInfo = musicDatabase.FindChartInfo(musicId, styleDifficulty, activeVersionIndex);
+                    if (!findChartInfo)
+                    {
+                        chunk.Output << "[" << dbTitle << "] Cannot find chart info.\n";
+                    }
+                    else
+                    {
+                        auto &chartInfo = *findChartInfo;
+                        if (chartScore.Level!=chartInfo.Level)
+                        {
+                            chunk.Output << "[" << dbTitle << "] level mismatch:\n"
+                                      << "CSV [" << chartScore.Level << "]\n"
+                                      << "DB [" << chartInfo.Level << "]\n";
+                        }
+                    }
+                }
+
+                if (checkWithDatabase && chartScore.ExScore!=0)
+                {
+                    auto styleDifficulty = ConvertToStyleDifficulty(playStyle, difficulty);
+                    auto findChartInfo = musicDatabase.FindChartInfo(
+                        musicId,
+                        styleDifficulty,
+                        activeVersionIndex
+                    );
+
+                    if (!findChartInfo)
+                    {
+                        chunk.Output << ToVersionString(versionIndex) << " Title [" << dbTitle << "]\n"
+                                  << "DateTime: " << dateTime << "\n"
+                                  << "ActiveVersion: " << ToVersionString(activeVersionIndex) << "\n"
+                                  << "StyleDifficulty: " << ToString(styleDifficulty) << "\n";
+                        throw std::runtime_error("cannot find chart info");
+                    }
+
+                    auto &chartInfo = *findChartInfo;
+                    if (chartInfo.Note<=0)
+                    {
+                        chunk.Output << ToVersionString(versionIndex) << " Title [" << dbTitle << "]\n"
+                                  << "DateTime: " << dateTime << "\n"
+                                  << "ActiveVersion: " << ToVersionString(activeVersionIndex) << "\n"
+                                  << "StyleDifficulty: " << ToString(styleDifficulty) << "\n";
+                        throw std::runtime_error("DB chart info note is non-positive.");
+                    }
+
+                    auto actualDjLevel = FindDjLevel(chartInfo.Note, chartScore.ExScore);
+                    if (actualDjLevel!=chartScore.DjLevel)
+                    {
+                        chunk.Output << "Error: unmatched DJ level in CSV:"
+                                  << "\n[" << ToVersionString(versionIndex)
+                                  << "][" << dbTitle
+                                  << "][" << ToString(styleDifficulty)
+                                  << "]\nLevel: " << chartInfo.Level
+                                  << ", Note: " << chartInfo.Note
+                                  << ", Score: " << chartScore.ExScore
+                                  << ", Actual DJ Level: " << ToString(actualDjLevel)
+                                  << ", Data DJ Level: " << ToString(chartScore.DjLevel)
+                                  << "\nDateTime: " << dateTime
+                                  << ", ActiveVersion: " << ToVersionString(activeVersionIndex)
+                                  << ".\n";
+                        chartScore.DjLevel = actualDjLevel;
+                    }
+                }
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        chunk.Error = e.what();
+        chunk.ErrorLine = row.Line;
+    }
+}
+
+}
+
 std::map<std::size_t, std::string>
 GetColumnHeaders()
 {
@@ -48,340 +298,456 @@ Csv::
 Csv(const std::string &csvPath,
     const MusicDatabase &musicDatabase,
     bool verbose,
-    bool checkWithDatabase)
+    bool checkWithDatabase,
+    std::size_t parseThreadCount)
 {
     ies::Time::ScopeTimePrinter<std::chrono::milliseconds> timePrinter{"CSV construct"};
 
-    //'' default name [IIDX ID]_[sp|dp]_score.csv
-    //'' e.g. 5483-7391_dp_score.csv
-    //''      012345678901234567
-    //'' minimum stem size: 18
-    //''
-    //'' user may add date to distinguish different csv saved.
-    //'' e.g. 5483-7391_dp_score_2020-11-21.csv
-    //'' requirement:
-    //''  1. must in form of [IIDX_ID]_[sp|dp]_score(_[Date]).csv
-    //''  2. only date part is optionally and may allow some flexibility.
+    try
+    {
+        auto path = fs::canonical(csvPath).lexically_normal().string();
+        MappedFile csvFile{path};
+        SetPath(path, verbose);
+        Parse(csvFile.GetView(), musicDatabase, verbose, checkWithDatabase, parseThreadCount);
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error("Csv::Csv(): exception:\n    "+std::string{e.what()});
+    }
+}
+
+Csv::
+Csv(const std::string &csvPath,
+    std::span<const char> content,
+    const MusicDatabase &musicDatabase,
+    bool verbose,
+    bool checkWithDatabase,
+    std::size_t parseThreadCount)
+{
+    ies::Time::ScopeTimePrinter<std::chrono::milliseconds> timePrinter{"CSV construct"};
 
     try
     {
-        auto path = fs::canonical(csvPath).lexically_normal();
-        mPath = path.string();
-        if (verbose) { std::cout << "Reading CSV file: [" << mPath << "].\n"; }
+        auto path = fs::path{csvPath}.lexically_normal().string();
+        SetPath(path, verbose);
+        Parse(std::string_view{content.data(), content.size()}, musicDatabase, verbose, checkWithDatabase, parseThreadCount);
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error("Csv::Csv(): exception:\n    "+std::string{e.what()});
+    }
+}
 
-        mFilename = path.filename().string();
-        auto [isValid, invalidReason] = IsValidCsvFilename(mFilename);
-        if (!isValid)
-        {
-            throw std::runtime_error("CSV invalid filename, reason: "+invalidReason+".");
-        }
+Csv::
+Csv(const std::string &iidxId,
+    PlayStyle playStyle,
+    std::string_view content,
+    const MusicDatabase &musicDatabase,
+    bool verbose,
+    bool checkWithDatabase,
+    std::size_t parseThreadCount)
+{
+    ies::Time::ScopeTimePrinter<std::chrono::milliseconds> timePrinter{"CSV construct"};
 
-        mIidxId = mFilename.substr(0, 9);
+    try
+    {
+        SetPlayer(iidxId, playStyle, verbose);
+        Parse(content, musicDatabase, verbose, checkWithDatabase, parseThreadCount);
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error("Csv::Csv(): exception:\n    "+std::string{e.what()});
+    }
+}
 
-        if (verbose) { std::cout << "IIDX ID [" << mIidxId << "].\n"; }
+Csv::
+Csv(const std::string &iidxId,
+    PlayStyle playStyle,
+    std::istream &stream,
+    const MusicDatabase &musicDatabase,
+    bool verbose)
+{
+    ies::Time::ScopeTimePrinter<std::chrono::milliseconds> timePrinter{"CSV construct"};
 
-        if (mFilename[10]=='d')
+    try
+    {
+        CsvStreamParser parser{iidxId, playStyle, musicDatabase, verbose};
+        std::vector<char> block(CsvStreamBlockSize);
+        while (stream)
         {
-            mPlayStyle = PlayStyle::DoublePlay;
+            stream.read(block.data(), static_cast<std::streamsize>(block.size()));
+            parser.Append(std::string_view{block.data(), static_cast<std::size_t>(stream.gcount())});
+        }
+        if (stream.bad())
+        {
+            throw std::runtime_error("cannot read CSV stream.");
         }
 
-        if (verbose) { std::cout << "PlayStyle [" << ToString(mPlayStyle) << "].\n"; }
-
-        //'' Map of {VersionIndex, MusicCount}.
-        std::map<std::size_t, int> versionMusicCounts;
-        std::ifstream csvFile{csvPath};
-        int lineCount = 0;
-
-        std::size_t lastVersionIndex = 0;
-        std::map<std::string, int> debugCounts;
-        std::string minDateTime;
-        std::string maxDateTime;
-
-        std::map<std::string, ies::Time::NsCountType> profNsCounts;
+        *this = std::move(*parser.Finish());
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error("Csv::Csv(): exception:\n    "+std::string{e.what()});
+    }
+}
 
-        auto fileSize = fs::file_size(mPath);
-        std::vector<char> bytes(fileSize);
-        csvFile.read(bytes.data(), fileSize);
-        std::string buffer(bytes.data(), bytes.size());
-        std::string_view bufferView{buffer};
-        auto lineView = bufferView;
+Csv::
+Csv(BinaryReader &reader)
+{
+    mPath = reader.ReadString();
+    mFilename = reader.ReadString();
+    mIidxId = reader.ReadString();
+    mPlayStyle = static_cast<PlayStyle>(reader.Read<std::uint8_t>());
+    mVersion = reader.ReadString();
+    mVersionIndex = reader.Read<std::uint32_t>();
+    mLastDateTime = reader.ReadString();
+    mMusicCount = reader.Read<std::uint64_t>();
+    mTotalPlayCount = reader.Read<std::uint64_t>();
+
+    if (static_cast<std::size_t>(mPlayStyle)>=PlayStyleSmartEnum::Size()||mVersionIndex>=VersionNames.size())
+    {
+        throw std::runtime_error("Csv::Csv(): invalid binary data.");
+    }
 
-        try
+    auto scoreCount = reader.Read<std::uint32_t>();
+    for (std::uint32_t i = 0; i<scoreCount; ++i)
+    {
+        auto musicId = static_cast<std::size_t>(reader.Read<std::uint64_t>());
+        auto playCount = static_cast<std::size_t>(reader.Read<std::uint64_t>());
+        auto dateTime = reader.ReadString();
+        auto &musicScore = mMusicScores.emplace_hint(
+            mMusicScores.end(),
+            std::piecewise_construct,
+            std::forward_as_tuple(musicId),
+            std::forward_as_tuple(musicId, mPlayStyle, playCount, std::string{dateTime}, ScoreSource::OfficialCsv)
+        )->second;
+
+        auto enableMask = reader.Read<std::uint8_t>();
+        for (auto difficulty : DifficultySmartEnum::ToRange())
         {
-            auto lastLineBegin = bufferView.find_last_of('\n', bufferView.size()-2);
-            if (lastLineBegin==std::string_view::npos)
+            if ((enableMask&(1u<<static_cast<std::size_t>(difficulty)))==0) { continue; }
+
+            auto &chartScore = musicScore.EnableChartScore(difficulty);
+            chartScore.Level = reader.Read<std::int32_t>();
+            chartScore.ClearType = static_cast<ClearType>(reader.Read<std::uint8_t>());
+            chartScore.DjLevel = static_cast<DjLevel>(reader.Read<std::uint8_t>());
+            chartScore.ExScore = reader.Read<std::int32_t>();
+            chartScore.PGreatCount = reader.Read<std::int32_t>();
+            chartScore.GreatCount = reader.Read<std::int32_t>();
+            if (reader.Read<std::uint8_t>()!=0)
             {
-                throw std::runtime_error("CSV has less than two lines.");
+                chartScore.MissCount = reader.Read<std::int32_t>();
             }
-            lastLineBegin = lastLineBegin+1;
+        }
+    }
+}
 
-            auto lastLineFirstComma = bufferView.find_first_of(',', lastLineBegin);
-            if (lastLineFirstComma==std::string_view::npos)
-            {
-                throw std::runtime_error("CSV last line has no comma.");
-            }
-            //std::cout << "Last version = [" << bufferView.substr(lastLineBegin, lastLineFirstComma-lastLineBegin) << "]\n";
-            auto csvVersion = buffer.substr(lastLineBegin, lastLineFirstComma-lastLineBegin);
-            auto findCsvVersionIndex = FindVersionIndex(csvVersion);
-            if (!findCsvVersionIndex)
-            {
-                throw std::runtime_error("Cannot find index of CSV version ["+csvVersion+"].");
-            }
+Csv::
+Csv(const Csv &csv,
+    const MusicDatabase &sourceDatabase,
+    const MusicDatabase &musicDatabase)
+:   mPath(csv.mPath),
+    mFilename(csv.mFilename),
+    mIidxId(csv.mIidxId),
+    mPlayStyle(csv.mPlayStyle),
+    mVersion(csv.mVersion),
+    mVersionIndex(csv.mVersionIndex),
+    mLastDateTime(csv.mLastDateTime),
+    mMusicCount(csv.mMusicCount),
+    mTotalPlayCount(csv.mTotalPlayCount)
+{
+    for (auto &[sourceMusicId, sourceMusicScore] : csv.mMusicScores)
+    {
+        auto findMusicId = musicDatabase.FindMusicId(sourceDatabase, sourceMusicId);
+        if (!findMusicId)
+        {
+            std::cout << "Csv ["+mFilename+"]["+mLastDateTime+"]: score of music ["+sourceDatabase.GetTitle(sourceMusicId)
+                         +"] is dropped, music is not found in database.\n";
+            continue;
+        }
 
-            auto activeVersionIndex = findCsvVersionIndex.value();
+        auto &musicScore = mMusicScores.emplace(findMusicId.value(), sourceMusicScore).first->second;
+        musicScore.SetMusicId(findMusicId.value());
+    }
+}
 
-            std::size_t start = 0;
-            std::size_t end = 0;
+void
+Csv::
+WriteBinary(BinaryWriter &writer)
+const
+{
+    writer.WriteString(mPath);
+    writer.WriteString(mFilename);
+    writer.WriteString(mIidxId);
+    writer.Write(static_cast<std::uint8_t>(mPlayStyle));
+    writer.WriteString(mVersion);
+    writer.Write(static_cast<std::uint32_t>(mVersionIndex));
+    writer.WriteString(mLastDateTime);
+    writer.Write(static_cast<std::uint64_t>(mMusicCount));
+    writer.Write(static_cast<std::uint64_t>(mTotalPlayCount));
+
+    writer.Write(static_cast<std::uint32_t>(mMusicScores.size()));
+    for (auto &[musicId, musicScore] : mMusicScores)
+    {
+        writer.Write(static_cast<std::uint64_t>(musicId));
+        writer.Write(static_cast<std::uint64_t>(musicScore.GetPlayCount()));
+        writer.WriteString(musicScore.GetDateTime());
 
-            while ((start = bufferView.find_first_not_of('\n', end))!=std::string_view::npos)
+        std::uint8_t enableMask = 0;
+        for (auto difficulty : DifficultySmartEnum::ToRange())
+        {
+            if (musicScore.GetChartScore(difficulty))
             {
-                end = bufferView.find('\n', start+1);
-                if (end==std::string_view::npos)
-                {
-                    end = buffer.length();
-                }
+                enableMask |= static_cast<std::uint8_t>(1u<<static_cast<std::size_t>(difficulty));
+            }
+        }
+        writer.Write(enableMask);
 
-                ++lineCount;
-                if (lineCount==1)
-                {
-                    continue;
-                }
+        for (auto difficulty : DifficultySmartEnum::ToRange())
+        {
+            auto* chartScore = musicScore.GetChartScore(difficulty);
+            if (!chartScore) { continue; }
+
+            writer.Write(static_cast<std::int32_t>(chartScore->Level));
+            writer.Write(static_cast<std::uint8_t>(chartScore->ClearType));
+            writer.Write(static_cast<std::uint8_t>(chartScore->DjLevel));
+            writer.Write(static_cast<std::int32_t>(chartScore->ExScore));
+            writer.Write(static_cast<std::int32_t>(chartScore->PGreatCount));
+            writer.Write(static_cast<std::int32_t>(chartScore->GreatCount));
+            writer.Write(static_cast<std::uint8_t>(chartScore->MissCount.has_value()));
+            if (chartScore->MissCount)
+            {
+                writer.Write(static_cast<std::int32_t>(chartScore->MissCount.value()));
+            }
+        }
+    }
+}
 
-                lineView = bufferView.substr(start, end-start);
+void
+Csv::
+SetPath(const std::string &path,
+        bool verbose)
+{
+    //'' default name [IIDX ID]_[sp|dp]_score.csv
+    //'' e.g. 5483-7391_dp_score.csv
+    //''      012345678901234567
+    //'' minimum stem size: 18
+    //''
+    //'' user may add date to distinguish different csv saved.
+    //'' e.g. 5483-7391_dp_score_2020-11-21.csv
+    //'' requirement:
+    //''  1. must in form of [IIDX_ID]_[sp|dp]_score(_[Date]).csv
+    //''  2. only date part is optionally and may allow some flexibility.
 
-                auto csvMusic = ParseCsvLine(lineView);
+    mPath = path;
+    if (verbose) { std::cout << "Reading CSV file: [" << mPath << "].\n"; }
 
-                auto* dbTitlePtr = &csvMusic.Title;
-                auto findMappedTitle = musicDatabase.FindCsvDbTitle(csvMusic.Title);
-                if (findMappedTitle)
-                {
-                    dbTitlePtr = &findMappedTitle.value();
-                }
+    mFilename = fs::path{path}.filename().string();
+    auto [isValid, invalidReason] = IsValidCsvFilename(mFilename);
+    if (!isValid)
+    {
+        throw std::runtime_error("CSV invalid filename, reason: "+invalidReason+".");
+    }
 
-                auto &dbTitle = *dbTitlePtr;
+    mIidxId = mFilename.substr(0, 9);
 
-                if (csvMusic.CsvVersionIndex==0)
-                {
-                    std::cerr << "Cannot find version for line [" << lineView << "], skipped.\n";
-                    continue;
-                }
+    if (verbose) { std::cout << "IIDX ID [" << mIidxId << "].\n"; }
 
-                std::optional<std::size_t> findVersionIndex = csvMusic.CsvVersionIndex;
-                if (csvMusic.CsvVersionIndex==1)
-                {
-                    findVersionIndex = musicDatabase.Find1stSubVersionIndex(dbTitle);
-                }
+    if (mFilename[10]=='d')
+    {
+        mPlayStyle = PlayStyle::DoublePlay;
+    }
 
-                if (!findVersionIndex)
-                {
-                    throw std::runtime_error("cannot find Ver["+ToVersionString(csvMusic.CsvVersionIndex)+"] title "+dbTitle+" version index.");
-                }
+    if (verbose) { std::cout << "PlayStyle [" << ToString(mPlayStyle) << "].\n"; }
+}
 
-                auto versionIndex = findVersionIndex.value();
+void
+Csv::
+SetPlayer(const std::string &iidxId,
+          PlayStyle playStyle,
+          bool verbose)
+{
+    if (!IsIidxId(iidxId))
+    {
+        throw std::runtime_error("invalid IIDX ID ["+iidxId+"].");
+    }
 
-                auto findMusicId = musicDatabase.FindMusicId(versionIndex, dbTitle);
-                if (!findMusicId)
-                {
-                    if (versionIndex==GetLatestVersionIndex())
-                    {
-                        std::cout << "Possible ["+ToVersionString(versionIndex)+"] new music title ["+csvMusic.Title+"] not in database, skipped.\n";
-                        continue;
-                    }
-                    throw std::runtime_error("music title ["+dbTitle+"] is not listed in it's version ["+ToVersionString(versionIndex)+"] in database");
-                }
+    mPath.clear();
+    mFilename = ToCsvFilename(iidxId, playStyle);
+    mIidxId = iidxId;
+    mPlayStyle = playStyle;
 
-                auto musicId = findMusicId.value();
+    if (verbose) { std::cout << "Reading CSV content of IIDX ID [" << mIidxId << "] PlayStyle [" << ToString(mPlayStyle) << "].\n"; }
+}
 
-                /*
-                if (checkWithDatabase)
-                {
-                    auto musicId = ToMusicId(versionIndex, musicIndex);
-                    auto musicInfo = musicDatabase.GetLatestMusicInfo(musicId);
+void
+Csv::
+Parse(std::string_view content,
+      const MusicDatabase &musicDatabase,
+      bool verbose,
+      bool checkWithDatabase,
+      std::size_t parseThreadCount)
+{
+    auto bufferView = content;
+    std::size_t activeVersionIndex = 0;
+    std::string_view bodyView;
 
-                    auto &dbArtist = musicInfo.GetField(MusicInfoField::Artist);
-                    auto &csvArtist = columns[static_cast<std::size_t>(CsvMusicColumn::Artist)];
-                    if (csvArtist!=dbArtist)
-                    {
-                        std::cout << "[" << dbTitle << "] artist mismatch:\n"
-                                  << "CSV [" << csvArtist << "]\n"
-                                  << "DB [" << dbArtist << "]\n";
-                    }
+    try
+    {
+        auto lastLineBegin = bufferView.find_last_of('\n', bufferView.size()-2);
+        if (lastLineBegin==std::string_view::npos)
+        {
+            throw std::runtime_error("CSV has less than two lines.");
+        }
+        lastLineBegin = lastLineBegin+1;
 
-                    auto &dbGenre = musicInfo.GetField(MusicInfoField::Genre);
-                    auto &csvGenre = columns[static_cast<std::size_t>(CsvMusicColumn::Genre)];
-                    if (csvGenre!=dbGenre)
-                    {
-                        std::cout << "[" << dbTitle << "] genre mismatch:\n"
-                                  << "CSV [" << csvGenre << "]\n"
-                                  << "DB [" << dbGenre << "]\n";
-                    }
-                }
-                */
+        auto lastLineFirstComma = bufferView.find_first_of(',', lastLineBegin);
+        if (lastLineFirstComma==std::string_view::npos)
+        {
+            throw std::runtime_error("CSV last line has no comma.");
+        }
+        //std::cout << "Last version = [" << bufferView.substr(lastLineBegin, lastLineFirstComma-lastLineBegin) << "]\n";
+        auto csvVersion = std::string{bufferView.substr(lastLineBegin, lastLineFirstComma-lastLineBegin)};
+        auto findCsvVersionIndex = FindVersionIndex(csvVersion);
+        if (!findCsvVersionIndex)
+        {
+            throw std::runtime_error("Cannot find index of CSV version ["+csvVersion+"].");
+        }
 
-                lastVersionIndex = versionIndex;
-                ies::MapIncrementCount(versionMusicCounts, versionIndex);
+        activeVersionIndex = findCsvVersionIndex.value();
 
-                mTotalPlayCount += csvMusic.PlayCount;
+        //'' skip header line.
+        CsvRowTokenizer tokenizer{bufferView};
+        CsvRowToken header;
+        tokenizer.Next(header);
+        auto headerEnd = static_cast<std::size_t>(header.Line.data()-bufferView.data())+header.Line.size();
+        bodyView = bufferView.substr(std::min(headerEnd+1, bufferView.size()));
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error("ParseCsvLine exception:\n    "
+                                 +std::string{e.what()}+"\n"
+                                 +"Line (0): "+std::string{bufferView}+"\n");
+    }
 
-                auto &dateTime = csvMusic.DateTime;
-                if (maxDateTime.empty() || dateTime>maxDateTime)
-                {
-                    maxDateTime = dateTime;
-                }
-                if (minDateTime.empty() || dateTime<minDateTime)
-                {
-                    minDateTime = dateTime;
-                }
+    ParseProgress progress;
+    ParseRows(bodyView, musicDatabase, activeVersionIndex, checkWithDatabase, parseThreadCount, progress);
+    FinishParse(progress, verbose);
+}
 
-                auto itPair = mMusicScores.emplace(
-                    std::piecewise_construct,
-                    std::forward_as_tuple(musicId),
-                    std::forward_as_tuple(musicId, mPlayStyle, csvMusic.PlayCount, dateTime, ScoreSource::OfficialCsv)
-                );
-                auto &musicScore = itPair.first->second;
+void
+Csv::
+ParseRows(std::string_view rows,
+          const MusicDatabase &musicDatabase,
+          std::size_t activeVersionIndex,
+          bool checkWithDatabase,
+          std::size_t parseThreadCount,
+          ParseProgress &progress)
+{
+    //'' rows are independent, parse chunks of rows in parallel then merge in file order,
+    //'' so duplicated music keeps score of first row as serial parsing.
+    auto workerCount = ResolveThreadCount(parseThreadCount);
+    auto chunkCount = workerCount<=1 ? 1 : std::min(workerCount*4, rows.size()/MinCsvChunkSize+1);
+    auto chunks = SplitCsvChunks(rows, chunkCount);
+    ParallelFor(chunks.size(), workerCount, [&](std::size_t chunkIndex)
+    {
+        ParseCsvChunk(chunks[chunkIndex], musicDatabase, mPlayStyle, activeVersionIndex, checkWithDatabase);
+    });
 
-                for (auto difficulty : DifficultySmartEnum::ToRange())
-                {
-                    auto difficultyIndex = static_cast<std::size_t>(difficulty);
-                    auto &csvChartScore = csvMusic.ChartScores[difficultyIndex];
+    for (auto &chunk : chunks)
+    {
+        std::cout << chunk.Output.str();
+        std::cerr << chunk.ErrorOutput.str();
 
-                    if (csvChartScore.Level==0)
-                    {
-                        continue;
-                    }
+        progress.LineCount += chunk.LineCount;
+        if (!chunk.Error.empty())
+        {
+            throw std::runtime_error("ParseCsvLine exception:\n    "
+                                     +chunk.Error+"\n"
+                                     +"Line ("+std::to_string(progress.LineCount)+"): "+std::string{chunk.ErrorLine}+"\n");
+        }
 
-                    auto &chartScore = musicScore.EnableChartScore(difficulty);
-                    chartScore = csvChartScore;
+        for (auto &musicScore : chunk.MusicScores)
+        {
+            mMusicScores.emplace(musicScore.GetMusicId(), std::move(musicScore));
+        }
 
-                    if (checkWithDatabase)
-                    {
-                        auto styleDifficulty = ConvertToStyleDifficulty(mPlayStyle, difficulty);
-                        auto* findChartInfo = musicDatabase.FindChartInfo(musicId, styleDifficulty, activeVersionIndex);
-                        if (!findChartInfo)
-                        {
-                            std::cout << "[" << dbTitle << "] Cannot find chart info.\n";
-                        }
-                        else
-                        {
-                            auto &chartInfo = *findChartInfo;
-                            if (chartScore.Level!=chartInfo.Level)
-                            {
-                                std::cout << "[" << dbTitle << "] level mismatch:\n"
-                                          << "CSV [" << chartScore.Level << "]\n"
-                                          << "DB [" << chartInfo.Level << "]\n";
-                            }
-                        }
-                    }
+        for (auto &[versionIndex, count] : chunk.VersionMusicCounts)
+        {
+            progress.VersionMusicCounts[versionIndex] += count;
+        }
 
-                    if (checkWithDatabase && chartScore.ExScore!=0)
-                    {
-                        auto styleDifficulty = ConvertToStyleDifficulty(mPlayStyle, difficulty);
-                        auto* findChartInfo = musicDatabase.FindChartInfo(
-                            musicId,
-                            styleDifficulty,
-                            activeVersionIndex
-                        );
-
-                        if (!findChartInfo)
-                        {
-                            std::cout << ToVersionString(versionIndex) << " Title [" << dbTitle << "]\n"
-                                      << "DateTime: " << dateTime << "\n"
-                                      << "ActiveVersion: " << ToVersionString(activeVersionIndex) << "\n"
-                                      << "StyleDifficulty: " << ToString(styleDifficulty) << "\n";
-                            throw std::runtime_error("cannot find chart info");
-                        }
+        if (chunk.LastVersionIndex)
+        {
+            progress.LastVersionIndex = chunk.LastVersionIndex.value();
+        }
 
-                        auto &chartInfo = *findChartInfo;
-                        if (chartInfo.Note<=0)
-                        {
-                            std::cout << ToVersionString(versionIndex) << " Title [" << dbTitle << "]\n"
-                                      << "DateTime: " << dateTime << "\n"
-                                      << "ActiveVersion: " << ToVersionString(activeVersionIndex) << "\n"
-                                      << "StyleDifficulty: " << ToString(styleDifficulty) << "\n";
-                            throw std::runtime_error("DB chart info note is non-positive.");
-                        }
+        mTotalPlayCount += chunk.TotalPlayCount;
 
-                        auto actualDjLevel = FindDjLevel(chartInfo.Note, chartScore.ExScore);
-                        if (actualDjLevel!=chartScore.DjLevel)
-                        {
-                            std::cout << "Error: unmatched DJ level in CSV:"
-                                      << "\n[" << ToVersionString(versionIndex)
-                                      << "][" << dbTitle
-                                      << "][" << ToString(styleDifficulty)
-                                      << "]\nLevel: " << chartInfo.Level
-                                      << ", Note: " << chartInfo.Note
-                                      << ", Score: " << chartScore.ExScore
-                                      << ", Actual DJ Level: " << ToString(actualDjLevel)
-                                      << ", Data DJ Level: " << ToString(chartScore.DjLevel)
-                                      << "\nDateTime: " << dateTime
-                                      << ", ActiveVersion: " << ToVersionString(activeVersionIndex)
-                                      << ".\n";
-                            chartScore.DjLevel = actualDjLevel;
-                        }
-                    }
-                }
-            }
+        if (!chunk.MaxDateTime.empty() && (progress.MaxDateTime.empty() || chunk.MaxDateTime>progress.MaxDateTime))
+        {
+            progress.MaxDateTime = chunk.MaxDateTime;
         }
-        catch (const std::exception &e)
+        if (!chunk.MinDateTime.empty() && (progress.MinDateTime.empty() || chunk.MinDateTime<progress.MinDateTime))
         {
-            throw std::runtime_error("ParseCsvLine exception:\n    "
-                                     +std::string{e.what()}+"\n"
-                                     +"Line ("+std::to_string(lineCount)+"): "+std::string{lineView}+"\n");
+            progress.MinDateTime = chunk.MinDateTime;
         }
+    }
+}
 
-        mVersion = VersionNames.at(lastVersionIndex);
-        mVersionIndex = lastVersionIndex;
+void
+Csv::
+FinishParse(const ParseProgress &progress,
+            bool verbose)
+{
+    mVersion = VersionNames.at(progress.LastVersionIndex);
+    mVersionIndex = progress.LastVersionIndex;
 
-        std::size_t totalMusicCount = 0;
-        if (verbose)
+    std::size_t totalMusicCount = 0;
+    if (verbose)
+    {
+        std::cout << "CSV Version [" << mVersion << "]\n"
+                  << "Each version music count:\n";
+        for (auto &[versionIndex, count] : progress.VersionMusicCounts)
         {
-            std::cout << "CSV Version [" << mVersion << "]\n"
-                      << "Each version music count:\n";
-            for (auto &[versionIndex, count] : versionMusicCounts)
+            //std::cout << "[" << VersionNames[versionIndex] << "] " << count << " musics.\n";
+            if (versionIndex%5==0)
             {
-                //std::cout << "[" << VersionNames[versionIndex] << "] " << count << " musics.\n";
-                if (versionIndex%5==0)
-                {
-                    if (versionIndex!=0)
-                    {
-                        std::cout << "\n";
-                    }
-                }
-                else
+                if (versionIndex!=0)
                 {
-                    std::cout << ", ";
+                    std::cout << "\n";
                 }
-                std::cout << count;
-                totalMusicCount += count;
             }
-            std::cout << "\n"
-                      << "TotalMusicCount [" << totalMusicCount << "].\n";
+            else
+            {
+                std::cout << ", ";
+            }
+            std::cout << count;
+            totalMusicCount += count;
         }
+        std::cout << "\n"
+                  << "TotalMusicCount [" << totalMusicCount << "].\n";
+    }
 
-        for (auto &[versionIndex, count] : versionMusicCounts)
-        {
-            (void)versionIndex;
-            mMusicCount += count;
-        }
+    for (auto &[versionIndex, count] : progress.VersionMusicCounts)
+    {
+        (void)versionIndex;
+        mMusicCount += count;
+    }
 
-        if (maxDateTime.empty())
-        {
-            throw std::runtime_error("empty date times in csv.");
-        }
+    if (progress.MaxDateTime.empty())
+    {
+        throw std::runtime_error("empty date times in csv.");
+    }
 
-        mLastDateTime = maxDateTime;
+    mLastDateTime = progress.MaxDateTime;
 
-        if (verbose) { std::cout << "DateTime [" << minDateTime << ", " << maxDateTime << "].\n"; }
+    if (verbose) { std::cout << "DateTime [" << progress.MinDateTime << ", " << progress.MaxDateTime << "].\n"; }
 
 //        for (auto &[timeName, nsCount] : profNsCounts)
 //        {
 //            s2Time::Print<std::chrono::milliseconds>(nsCount, "    "+timeName);
 //        }
-    }
-    catch (const std::exception &e)
-    {
-        throw std::runtime_error("Csv::Csv(): exception:\n    "+std::string{e.what()});
-    }
 }
 
 const std::string &
@@ -454,6 +820,14 @@ const
               << "    Total PlayCount [" << mTotalPlayCount << "]\n";
 }
 
+std::string
+ToCsvFilename(const std::string &iidxId,
+              PlayStyle playStyle)
+{
+    auto playStyleName = playStyle==PlayStyle::DoublePlay ? "dp" : "sp";
+    return iidxId+"_"+playStyleName+"_score.csv";
+}
+
 std::pair<bool, std::string>
 IsValidCsvFilename(std::string_view filename)
 {
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <iosfwd>
 #include <map>
+#include <span>
 #include <string>
 #include <string_view>
 
@@ -11,6 +13,10 @@
 namespace score2dx
 {
 
+class BinaryReader;
+class BinaryWriter;
+class CsvStreamParser;
+
 const std::string ExampleCsvFilename = "5483-7391_dp_score.csv";
 const std::size_t MinCsvFilenameSize = ExampleCsvFilename.size();
 
@@ -27,10 +33,59 @@ const std::size_t MinCsvFilenameSize = ExampleCsvFilename.size();
 class Csv
 {
 public:
+    //! @brief Parse CSV file at csvPath, file is memory mapped and parsed in place.
+    //! Rows are split into chunks at line boundaries and parsed by parseThreadCount workers
+    //! (0 = hardware concurrency), result is same as serial parsing.
+        Csv(const std::string &csvPath,
+            const MusicDatabase &musicDatabase,
+            bool verbose=false,
+            bool checkWithDatabase=false,
+            std::size_t parseThreadCount=1);
+
+    //! @brief Parse CSV content from caller-owned bytes in place, csvPath only provides filename
+    //! (IIDX ID and play style) and does not need to exist.
+    //! @note content is only accessed during construction.
         Csv(const std::string &csvPath,
+            std::span<const char> content,
+            const MusicDatabase &musicDatabase,
+            bool verbose=false,
+            bool checkWithDatabase=false,
+            std::size_t parseThreadCount=1);
+
+    //! @brief Parse CSV content of player iidxId from caller-owned bytes in place, e.g. HTTP body.
+    //! IIDX ID and play style are given instead of filename, filename is default filename of them
+    //! (e.g. ExampleCsvFilename) and path is empty.
+    //! @note content is only accessed during construction.
+        Csv(const std::string &iidxId,
+            PlayStyle playStyle,
+            std::string_view content,
             const MusicDatabase &musicDatabase,
             bool verbose=false,
-            bool checkWithDatabase=false);
+            bool checkWithDatabase=false,
+            std::size_t parseThreadCount=1);
+
+    //! @brief Read CSV content of player iidxId from stream until end, rows are parsed block by block
+    //! while reading, see CsvStreamParser. Filename and path are same as constructing from content.
+        Csv(const std::string &iidxId,
+            PlayStyle playStyle,
+            std::istream &stream,
+            const MusicDatabase &musicDatabase,
+            bool verbose=false);
+
+    //! @brief Restore parsed Csv written by WriteBinary, throws if data is invalid.
+        explicit Csv(BinaryReader &reader);
+
+    //! @brief Copy csv parsed with sourceDatabase, its MusicScores are keyed by MusicId of same music
+    //! in musicDatabase (e.g. reloaded database), see MusicDatabase::FindMusicId(sourceDatabase, sourceMusicId).
+    //! Scores of music not found in musicDatabase are dropped and reported.
+        Csv(const Csv &csv,
+            const MusicDatabase &sourceDatabase,
+            const MusicDatabase &musicDatabase);
+
+    //! @brief Write parsed result (summary and MusicScores), restore by Csv(BinaryReader&).
+        void
+        WriteBinary(BinaryWriter &writer)
+        const;
 
         const std::string &
         GetFilename()
@@ -65,6 +120,20 @@ public:
         const;
 
 private:
+    friend class CsvStreamParser;
+
+    //! @brief Progress of rows merged in file order, see ParseRows.
+    struct ParseProgress
+    {
+        //! @brief Count of non-empty lines merged, header is line 1.
+        int LineCount{1};
+        std::size_t LastVersionIndex{0};
+        std::string MinDateTime;
+        std::string MaxDateTime;
+        //! @brief Map of {VersionIndex, MusicCount}.
+        std::map<std::size_t, int> VersionMusicCounts;
+    };
+
     std::string mPath;
     std::string mFilename;
     std::string mIidxId;
@@ -78,8 +147,50 @@ private:
 
     //! @brief Map of {MusicId, MusicScore}.
     std::map<std::size_t, MusicScore> mMusicScores;
+
+    //! @brief Empty Csv filled by CsvStreamParser.
+        Csv() = default;
+
+    //! @brief Set path, filename, IIDX ID and play style from path of CSV file.
+        void
+        SetPath(const std::string &path,
+                bool verbose);
+
+    //! @brief Set IIDX ID and play style, with empty path and default filename.
+        void
+        SetPlayer(const std::string &iidxId,
+                  PlayStyle playStyle,
+                  bool verbose);
+
+        void
+        Parse(std::string_view content,
+              const MusicDatabase &musicDatabase,
+              bool verbose,
+              bool checkWithDatabase,
+              std::size_t parseThreadCount);
+
+    //! @brief Parse rows (complete lines without header) on parseThreadCount workers, and merge into
+    //! MusicScores and progress in row order.
+    //! activeVersionIndex is only used if checkWithDatabase.
+        void
+        ParseRows(std::string_view rows,
+                  const MusicDatabase &musicDatabase,
+                  std::size_t activeVersionIndex,
+                  bool checkWithDatabase,
+                  std::size_t parseThreadCount,
+                  ParseProgress &progress);
+
+    //! @brief Set summary (version, music count, last date time) after all rows are merged.
+        void
+        FinishParse(const ParseProgress &progress,
+                    bool verbose);
 };
 
+//! @brief Default CSV filename of player, e.g. ExampleCsvFilename.
+std::string
+ToCsvFilename(const std::string &iidxId,
+              PlayStyle playStyle);
+
 //! @return {IsValid, InvalidReason}.
 std::pair<bool, std::string>
 IsValidCsvFilename(std::string_view filename);
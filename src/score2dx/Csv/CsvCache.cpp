@@ -0,0 +1,206 @@
+#include "score2dx/Csv/CsvCache.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+#include "ies/StdUtil/Find.hxx"
+
+#include "score2dx/Core/BinaryStream.hxx"
+#include "score2dx/Core/MappedFile.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+const std::string CsvCacheMagic{"S2CC"};
+//'' increase when Csv::WriteBinary or cache layout changes.
+constexpr std::uint32_t CsvCacheFormatVersion = 1;
+
+}
+
+namespace score2dx
+{
+
+CsvCache::
+CsvCache(std::string cacheFilename,
+         const MusicDatabase &musicDatabase)
+:   mCacheFilename(std::move(cacheFilename)),
+    mMusicDatabase(musicDatabase)
+{
+    if (!fs::exists(mCacheFilename)||!fs::is_regular_file(mCacheFilename))
+    {
+        return;
+    }
+
+    try
+    {
+        MappedFile cacheFile{mCacheFilename};
+        BinaryReader reader{cacheFile.GetView()};
+
+        if (reader.ReadString()!=CsvCacheMagic
+            ||reader.Read<std::uint32_t>()!=CsvCacheFormatVersion
+            ||reader.Read<std::uint64_t>()!=mMusicDatabase.GetSourceHash())
+        {
+            return;
+        }
+
+        auto entryCount = reader.Read<std::uint32_t>();
+        for (std::uint32_t i = 0; i<entryCount; ++i)
+        {
+            std::string path{reader.ReadString()};
+            Entry entry;
+            entry.FileSize = reader.Read<std::uint64_t>();
+            entry.LastWriteTime = reader.Read<std::int64_t>();
+            entry.ContentHash = reader.Read<std::uint64_t>();
+            entry.CsvBinary = reader.ReadString();
+            mCachedEntries.emplace(std::move(path), std::move(entry));
+        }
+
+        if (reader.GetRemainSize()!=0)
+        {
+            throw std::runtime_error("trailing bytes.");
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Discard invalid CSV cache [" << mCacheFilename << "]: " << e.what() << "\n";
+        mCachedEntries.clear();
+    }
+}
+
+std::unique_ptr<Csv>
+CsvCache::
+Load(const std::string &csvPath,
+     bool verbose)
+{
+    auto path = fs::canonical(csvPath).lexically_normal().string();
+
+    Entry entry;
+    entry.FileSize = fs::file_size(path);
+    entry.LastWriteTime = static_cast<std::int64_t>(fs::last_write_time(path).time_since_epoch().count());
+
+    //'' cached entries are immutable after construction, no guard needed.
+    const Entry* cachedEntry = nullptr;
+    if (auto findEntry = ies::Find(mCachedEntries, path))
+    {
+        cachedEntry = &findEntry.value()->second;
+    }
+
+    auto restore = [&](const Entry &restoredEntry)
+    {
+        BinaryReader reader{restoredEntry.CsvBinary};
+        auto csv = std::make_unique<Csv>(reader);
+        if (reader.GetRemainSize()!=0)
+        {
+            throw std::runtime_error("CsvCache: trailing bytes of ["+path+"].");
+        }
+        return csv;
+    };
+
+    std::unique_ptr<Csv> csv;
+    if (cachedEntry
+        &&cachedEntry->FileSize==entry.FileSize
+        &&cachedEntry->LastWriteTime==entry.LastWriteTime)
+    {
+        if (verbose) { std::cout << "Restore CSV [" << path << "] from cache.\n"; }
+        csv = restore(*cachedEntry);
+        entry = *cachedEntry;
+    }
+    else
+    {
+        MappedFile csvFile{path};
+        entry.ContentHash = ToFnv1aHash(csvFile.GetView());
+        if (cachedEntry&&cachedEntry->ContentHash==entry.ContentHash)
+        {
+            if (verbose) { std::cout << "Restore CSV [" << path << "] from cache, content is unchanged.\n"; }
+            csv = restore(*cachedEntry);
+            entry.CsvBinary = cachedEntry->CsvBinary;
+        }
+        else
+        {
+            auto content = csvFile.GetView();
+            csv = std::make_unique<Csv>(path, std::span<const char>{content.data(), content.size()}, mMusicDatabase, verbose);
+            BinaryWriter writer;
+            csv->WriteBinary(writer);
+            entry.CsvBinary = writer.GetBuffer();
+        }
+
+        std::scoped_lock lock{mMutex};
+        mIsChanged = true;
+    }
+
+    std::scoped_lock lock{mMutex};
+    mLoadedEntries[path] = std::move(entry);
+    return csv;
+}
+
+void
+CsvCache::
+Save(bool pruneUnloaded)
+const
+{
+    std::scoped_lock lock{mMutex};
+
+    //'' Map of {CSV canonical path, Entry} to write.
+    std::map<std::string_view, const Entry*> savedEntries;
+    for (auto &[path, entry] : mLoadedEntries)
+    {
+        savedEntries.emplace(path, &entry);
+    }
+    if (!pruneUnloaded)
+    {
+        for (auto &[path, entry] : mCachedEntries)
+        {
+            std::error_code errorCode;
+            if (!savedEntries.contains(path)&&fs::is_regular_file(path, errorCode))
+            {
+                savedEntries.emplace(path, &entry);
+            }
+        }
+    }
+
+    //'' unchanged entries are restored from cached entries, same size means same entries.
+    if (!mIsChanged&&savedEntries.size()==mCachedEntries.size())
+    {
+        return;
+    }
+
+    BinaryWriter writer;
+    writer.WriteString(CsvCacheMagic);
+    writer.Write(CsvCacheFormatVersion);
+    writer.Write(mMusicDatabase.GetSourceHash());
+    writer.Write(static_cast<std::uint32_t>(savedEntries.size()));
+    for (auto &[path, entryPtr] : savedEntries)
+    {
+        auto &entry = *entryPtr;
+        writer.WriteString(path);
+        writer.Write(entry.FileSize);
+        writer.Write(entry.LastWriteTime);
+        writer.Write(entry.ContentHash);
+        writer.WriteString(entry.CsvBinary);
+    }
+
+    //'' write to temporary file and rename, avoid other process reading partially written cache.
+    auto temporaryFilename = mCacheFilename+".tmp";
+    {
+        std::ofstream cacheFile{temporaryFilename, std::ios::binary|std::ios::trunc};
+        if (!cacheFile)
+        {
+            throw std::runtime_error("cannot create file ["+temporaryFilename+"].");
+        }
+        auto &buffer = writer.GetBuffer();
+        cacheFile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!cacheFile)
+        {
+            throw std::runtime_error("cannot write file ["+temporaryFilename+"].");
+        }
+    }
+    fs::rename(temporaryFilename, mCacheFilename);
+}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "score2dx/Core/MusicDatabase.hpp"
+#include "score2dx/Csv/Csv.hpp"
+
+namespace score2dx
+{
+
+const std::string CsvCacheFilename{"score2dx_csv_cache.s2cc"};
+
+//! @brief Persistent cache of parsed Csv of a directory, saved as single binary file.
+//! Entry is keyed by CSV path, file size, last write time and content hash:
+//!     1. Same size and last write time: restore Csv from entry without reading CSV.
+//!     2. Otherwise read CSV and compare content hash, restore if same, parse CSV again if changed.
+//! Whole cache is discarded if it is written by other format or MusicDatabase (source hash).
+//! @note Byte order is native, cache file is for same machine.
+class CsvCache
+{
+public:
+    //! @brief Read cache file if it exists and is valid, otherwise start with empty cache.
+        CsvCache(std::string cacheFilename,
+                 const MusicDatabase &musicDatabase);
+
+    //! @brief Restore Csv at csvPath from cache, or parse CSV and update cache.
+    //! Throws same as Csv constructor if CSV is parsed and invalid.
+    //! @note Thread safe, different CSVs can be loaded concurrently.
+        std::unique_ptr<Csv>
+        Load(const std::string &csvPath,
+             bool verbose=false);
+
+    //! @brief Write cache file of CSVs loaded since construction if anything changed.
+    //! Entries of CSVs not loaded are kept if their CSV still exists, unless pruneUnloaded
+    //! (all CSVs of directory are loaded, e.g. LoadDirectory), then they are dropped.
+        void
+        Save(bool pruneUnloaded)
+        const;
+
+private:
+    struct Entry
+    {
+        std::uint64_t FileSize{0};
+        std::int64_t LastWriteTime{0};
+        std::uint64_t ContentHash{0};
+        //! @brief Data of Csv::WriteBinary.
+        std::string CsvBinary;
+    };
+
+    std::string mCacheFilename;
+    const MusicDatabase &mMusicDatabase;
+
+    //! @brief Map of {CSV canonical path, Entry} read from cache file, immutable after construction.
+    std::map<std::string, Entry> mCachedEntries;
+    //! @brief Guard loaded entries and change flag for concurrent Load.
+    mutable std::mutex mMutex;
+    //! @brief Map of {CSV canonical path, Entry} of CSVs loaded since construction.
+    std::map<std::string, Entry> mLoadedEntries;
+    bool mIsChanged{false};
+};
+
+}
@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "score2dx/Core/BinaryStream.hxx"
+#include "score2dx/Core/TestUtil.hpp"
+#include "score2dx/Csv/CsvCache.hpp"
+
+namespace fs = std::filesystem;
+
+namespace score2dx
+{
+
+namespace
+{
+
+enum class LoadResult
+{
+    Restored,
+    RestoredByContent,
+    Parsed
+};
+
+std::string
+ToBinary(const Csv &csv)
+{
+    BinaryWriter writer;
+    csv.WriteBinary(writer);
+    return writer.GetBuffer();
+}
+
+//! @brief Load csvPath by new CsvCache of directory and save it, csv is set to loaded Csv.
+LoadResult
+LoadBySavedCache(const fs::path &directory,
+                 const MusicDatabase &musicDatabase,
+                 const fs::path &csvPath,
+                 std::unique_ptr<Csv> &csv)
+{
+    CsvCache csvCache{(directory/CsvCacheFilename).string(), musicDatabase};
+    testing::internal::CaptureStdout();
+    csv = csvCache.Load(csvPath.string(), true);
+    auto output = testing::internal::GetCapturedStdout();
+    csvCache.Save(true);
+
+    if (output.find("from cache, content is unchanged.")!=std::string::npos) { return LoadResult::RestoredByContent; }
+    if (output.find("from cache.")!=std::string::npos) { return LoadResult::Restored; }
+    return LoadResult::Parsed;
+}
+
+}
+
+TEST(CsvCache, Load)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase)
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    TestDirectory testDirectory{"score2dx_csv_cache_test"};
+    auto &directory = testDirectory.GetPath();
+    auto csvPath = directory/"5483-7391_sp_score.csv";
+    auto cachePath = directory/CsvCacheFilename;
+    auto content = MakeCsvContent(*musicDatabase, PlayStyle::SinglePlay, 30, "2023-03-05");
+    std::ofstream{csvPath, std::ios::binary} << content;
+
+    std::unique_ptr<Csv> csv;
+    ASSERT_EQ(LoadResult::Parsed, LoadBySavedCache(directory, *musicDatabase, csvPath, csv));
+    ASSERT_TRUE(fs::exists(cachePath));
+    auto expectedBinary = ToBinary(Csv{csvPath.string(), *musicDatabase});
+    EXPECT_EQ(expectedBinary, ToBinary(*csv));
+
+    //'' same size and last write time: restored without reading CSV, even if content is changed in place.
+    {
+        auto lastWriteTime = fs::last_write_time(csvPath);
+        auto sameSizeContent = content;
+        sameSizeContent.replace(sameSizeContent.rfind("2023-03-05"), 10, "2023-03-04");
+        std::ofstream{csvPath, std::ios::binary|std::ios::trunc} << sameSizeContent;
+        fs::last_write_time(csvPath, lastWriteTime);
+
+        EXPECT_EQ(LoadResult::Restored, LoadBySavedCache(directory, *musicDatabase, csvPath, csv));
+        EXPECT_EQ(expectedBinary, ToBinary(*csv));
+
+        std::ofstream{csvPath, std::ios::binary|std::ios::trunc} << content;
+    }
+
+    //'' touched: content hash is same, restored and entry is updated to new last write time.
+    fs::last_write_time(csvPath, fs::last_write_time(csvPath)+std::chrono::hours{1});
+    EXPECT_EQ(LoadResult::RestoredByContent, LoadBySavedCache(directory, *musicDatabase, csvPath, csv));
+    EXPECT_EQ(expectedBinary, ToBinary(*csv));
+    EXPECT_EQ(LoadResult::Restored, LoadBySavedCache(directory, *musicDatabase, csvPath, csv));
+
+    //'' edited: parsed again.
+    auto editedContent = MakeCsvContent(*musicDatabase, PlayStyle::SinglePlay, 30, "2023-03-06", 1);
+    std::ofstream{csvPath, std::ios::binary|std::ios::trunc} << editedContent;
+    EXPECT_EQ(LoadResult::Parsed, LoadBySavedCache(directory, *musicDatabase, csvPath, csv));
+    auto editedBinary = ToBinary(Csv{csvPath.string(), *musicDatabase});
+    EXPECT_NE(expectedBinary, editedBinary);
+    EXPECT_EQ(editedBinary, ToBinary(*csv));
+    EXPECT_EQ(LoadResult::Restored, LoadBySavedCache(directory, *musicDatabase, csvPath, csv));
+    EXPECT_EQ(editedBinary, ToBinary(*csv));
+}
+
+TEST(CsvCache, Invalidate)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase||!fs::exists(DefaultMusicDatabaseFilename))
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    TestDirectory testDirectory{"score2dx_csv_cache_invalidate_test"};
+    auto &directory = testDirectory.GetPath();
+    auto csvPath = directory/"5483-7391_dp_score.csv";
+    auto cachePath = directory/CsvCacheFilename;
+    std::ofstream{csvPath, std::ios::binary} << MakeCsvContent(*musicDatabase, PlayStyle::DoublePlay, 30, "2023-03-05");
+
+    std::unique_ptr<Csv> csv;
+    ASSERT_EQ(LoadResult::Parsed, LoadBySavedCache(directory, *musicDatabase, csvPath, csv));
+    auto expectedBinary = ToBinary(*csv);
+    auto cache = ReadFile(cachePath);
+
+    //'' corrupt or truncated cache is discarded.
+    for (auto &invalidCache : {cache.substr(0, cache.size()/2), cache+"trailing", std::string{"S2CC"}})
+    {
+        std::ofstream{cachePath, std::ios::binary|std::ios::trunc} << invalidCache;
+        EXPECT_EQ(LoadResult::Parsed, LoadBySavedCache(directory, *musicDatabase, csvPath, csv));
+        EXPECT_EQ(expectedBinary, ToBinary(*csv));
+        EXPECT_EQ(cache, ReadFile(cachePath));
+    }
+
+    //'' cache of other MusicDatabase source is discarded.
+    auto databasePath = directory/fs::path{DefaultMusicDatabaseFilename}.filename();
+    fs::copy_file(DefaultMusicDatabaseFilename, databasePath);
+    std::ofstream{databasePath, std::ios::app} << "\n";
+    MusicDatabaseOptions options;
+    options.UseSnapshot = false;
+    MusicDatabase otherDatabase{databasePath.string(), options};
+    ASSERT_NE(musicDatabase->GetSourceHash(), otherDatabase.GetSourceHash());
+
+    EXPECT_EQ(LoadResult::Parsed, LoadBySavedCache(directory, otherDatabase, csvPath, csv));
+    EXPECT_EQ(LoadResult::Restored, LoadBySavedCache(directory, otherDatabase, csvPath, csv));
+    EXPECT_EQ(LoadResult::Parsed, LoadBySavedCache(directory, *musicDatabase, csvPath, csv));
+}
+
+}
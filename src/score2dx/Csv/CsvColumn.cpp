@@ -12,34 +12,43 @@
 #include "ies/Time/TimeUtilFormat.hxx"
 
 #include "score2dx/Core/CheckedParse.hxx"
+#include "score2dx/Core/StringViewHash.hxx"
+#include "score2dx/Csv/CsvRowTokenizer.hpp"
 #include "score2dx/Iidx/Definition.hpp"
 #include "score2dx/Iidx/Version.hpp"
 
 namespace
 {
 
-struct StringViewComparator
-{
-    using is_transparent = std::true_type;
+using StringViewIndexMap = std::unordered_map<std::string, std::size_t, score2dx::StringViewHash, score2dx::StringViewEqual>;
 
-    bool operator()(std::string_view l, std::string_view r) const noexcept
-    {
-        return l==r;
-    }
+//! @brief Immutable lookup tables shared by all CsvParsers.
+struct CsvLookupTables
+{
+    StringViewIndexMap CsvClearTypeIndexMap;
+    StringViewIndexMap DjLevelIndexMap;
 };
 
-struct StringViewHash
+//! @note Initialized once on first call, initialization of function local static is thread-safe.
+const CsvLookupTables &
+GetCsvLookupTables()
 {
-    using is_transparent = std::true_type;
-
-    auto operator()(std::string_view sv) const noexcept
+    static const CsvLookupTables lookupTables = []()
     {
-        return std::hash<std::string_view>()(sv);
-    }
-};
+        CsvLookupTables tables;
+        for (auto clearType : score2dx::ClearTypeSmartEnum::ToRange())
+        {
+            tables.CsvClearTypeIndexMap.emplace(score2dx::ToSpaceSeparated(clearType), static_cast<std::size_t>(clearType));
+        }
+        for (auto djLevel : score2dx::DjLevelSmartEnum::ToRange())
+        {
+            tables.DjLevelIndexMap.emplace(score2dx::ToString(djLevel), static_cast<std::size_t>(djLevel));
+        }
+        return tables;
+    }();
 
-std::unordered_map<std::string, std::size_t, StringViewHash, StringViewComparator> CsvClearTypeIndexMap;
-std::unordered_map<std::string, std::size_t, StringViewHash, StringViewComparator> DjLevelIndexMap;
+    return lookupTables;
+}
 
 }
 
@@ -55,191 +64,123 @@ ToCsvColumnIndex(Difficulty difficulty, CsvScoreColumn scoreColumn)
 }
 
 CsvMusic
-ParseCsvLine(std::string_view csvLine)
+CsvParser::
+ParseLine(std::string_view csvLine)
 {
-    //auto begin = ies::Time::Now();
-
-    static std::size_t PreviousParsedVersionIndex = 0;
-
-    if (CsvClearTypeIndexMap.empty())
+    CsvRowTokenizer tokenizer{csvLine};
+    CsvRowToken row;
+    if (!tokenizer.Next(row))
     {
-        for (auto clearType : ClearTypeSmartEnum::ToRange())
-        {
-            CsvClearTypeIndexMap.emplace(ToSpaceSeparated(clearType), static_cast<std::size_t>(clearType));
-        }
+        throw std::runtime_error("csvLine has incorrect column count.");
     }
 
-    if (DjLevelIndexMap.empty())
-    {
-        for (auto djLevel : DjLevelSmartEnum::ToRange())
-        {
-            DjLevelIndexMap.emplace(ToString(djLevel), static_cast<std::size_t>(djLevel));
-        }
-    }
+    return ParseRow(row);
+}
 
-    auto count = std::count(csvLine.begin(), csvLine.end(), ',');
-    if (count!=CsvColumnSize-1)
+CsvMusic
+CsvParser::
+ParseRow(const CsvRowToken &row)
+{
+    //auto begin = ies::Time::Now();
+
+    auto &[csvClearTypeIndexMap, djLevelIndexMap] = GetCsvLookupTables();
+
+    if (row.CommaCount!=CsvColumnSize-1)
     {
         throw std::runtime_error("csvLine has incorrect column count.");
     }
 
     CsvMusic music;
 
-    std::size_t start = 0;
-    std::size_t end = 0;
-    std::size_t index = 0;
-
-    while ((start = csvLine.find_first_not_of(',', end))!=std::string_view::npos)
+    auto version = row.GetColumn(static_cast<std::size_t>(CsvMusicColumn::Version));
+    if (mPreviousParsedVersionIndex!=0&&version==VersionNames[mPreviousParsedVersionIndex])
     {
-        end = csvLine.find(',', start+1);
-        if (end==std::string_view::npos)
+        music.CsvVersionIndex = mPreviousParsedVersionIndex;
+    }
+    else if (version==Official1stSubVersionName)
+    {
+        music.CsvVersionIndex = 1;
+        mPreviousParsedVersionIndex = 1;
+    }
+    else
+    {
+        for (auto i : IndexRange{2, VersionNames.size()})
         {
-            end = csvLine.length();
+            if (version==VersionNames[i])
+            {
+                music.CsvVersionIndex = i;
+                mPreviousParsedVersionIndex = i;
+                break;
+            }
         }
+    }
 
-        auto column = csvLine.substr(start, end-start);
+    music.Title = row.GetColumn(static_cast<std::size_t>(CsvMusicColumn::Title));
+    music.Genre = row.GetColumn(static_cast<std::size_t>(CsvMusicColumn::Genre));
+    music.Artist = row.GetColumn(static_cast<std::size_t>(CsvMusicColumn::Artist));
+    CheckedParse(row.GetColumn(static_cast<std::size_t>(CsvMusicColumn::PlayCount)), music.PlayCount, "PlayCount");
 
-        if (index<CsvMusicColumnSmartEnum::Size())
+    for (auto difficulty : DifficultySmartEnum::ToRange())
+    {
+        auto &chartScore = music.ChartScores[static_cast<std::size_t>(difficulty)];
+        auto getColumn = [&](CsvScoreColumn scoreColumn)
         {
-            auto musicColumn = static_cast<CsvMusicColumn>(index);
-
-            switch (musicColumn)
-            {
-                case CsvMusicColumn::Version:
-                {
-                    if (PreviousParsedVersionIndex!=0)
-                    {
-                        if (column==VersionNames[PreviousParsedVersionIndex])
-                        {
-                            music.CsvVersionIndex = PreviousParsedVersionIndex;
-                            break;
-                        }
-                    }
-
-                    if (column==Official1stSubVersionName)
-                    {
-                        music.CsvVersionIndex = 1;
-                        PreviousParsedVersionIndex = 1;
-                        break;
-                    }
+            return row.GetColumn(ToCsvColumnIndex(difficulty, scoreColumn));
+        };
 
-                    for (auto i : IndexRange{2, VersionNames.size()})
-                    {
-                        if (column==VersionNames[i])
-                        {
-                            music.CsvVersionIndex = i;
-                            PreviousParsedVersionIndex = i;
-                            break;
-                        }
-                    }
+        CheckedParse(getColumn(CsvScoreColumn::Level), chartScore.Level, "Level");
+        CheckedParse(getColumn(CsvScoreColumn::ExScore), chartScore.ExScore, "ExScore");
+        CheckedParse(getColumn(CsvScoreColumn::PGreatCount), chartScore.PGreatCount, "PGreatCount");
+        CheckedParse(getColumn(CsvScoreColumn::GreatCount), chartScore.GreatCount, "GreatCount");
 
-                    break;
-                }
-                case CsvMusicColumn::Title:
-                {
-                    music.Title = column;
-                    break;
-                }
-                case CsvMusicColumn::Genre:
-                {
-                    music.Genre = column;
-                    break;
-                }
-                case CsvMusicColumn::Artist:
-                {
-                    music.Artist = column;
-                    break;
-                }
-                case CsvMusicColumn::PlayCount:
-                {
-                    CheckedParse(column, music.PlayCount, "PlayCount");
-                    break;
-                }
-                default:
-                    break;
-            }
-        }
-        else if (index==DateTimeColumnIndex)
+        //'' HARD failed will have ex score but no miss count.
+        auto missCountColumn = getColumn(CsvScoreColumn::MissCount);
+        if (missCountColumn!="---")
         {
-            music.DateTime = column;
+            int missCount{0};
+            CheckedParse(missCountColumn, missCount, "GreatCount");
+            chartScore.MissCount = missCount;
         }
-        else
-        {
-            auto allScoreIndex = (index-CsvMusicColumnSmartEnum::Size());
-            auto difficultyIndex = allScoreIndex/CsvScoreColumnSmartEnum::Size();
-            auto scoreColumn = static_cast<CsvScoreColumn>(allScoreIndex%CsvScoreColumnSmartEnum::Size());
 
-            auto &chartScore = music.ChartScores[difficultyIndex];
+        auto clearTypeColumn = getColumn(CsvScoreColumn::ClearType);
+        auto findClearTypeIndex = ies::Find(csvClearTypeIndexMap, clearTypeColumn);
+        if (!findClearTypeIndex)
+        {
+            throw std::runtime_error("Incorrect CSV clear type ["+std::string{clearTypeColumn}+"].");
+        }
+        chartScore.ClearType = static_cast<ClearType>(findClearTypeIndex.value()->second);
 
-            switch (scoreColumn)
+        auto djLevelColumn = getColumn(CsvScoreColumn::DjLevel);
+        if (djLevelColumn!="---")
+        {
+            auto findDjLevelIndex = ies::Find(djLevelIndexMap, djLevelColumn);
+            if (!findDjLevelIndex)
             {
-                case CsvScoreColumn::Level:
-                {
-                    CheckedParse(column, chartScore.Level, "Level");
-                    break;
-                }
-                case CsvScoreColumn::ExScore:
-                {
-                    CheckedParse(column, chartScore.ExScore, "ExScore");
-                    break;
-                }
-                case CsvScoreColumn::PGreatCount:
-                {
-                    CheckedParse(column, chartScore.PGreatCount, "PGreatCount");
-                    break;
-                }
-                case CsvScoreColumn::GreatCount:
-                {
-                    CheckedParse(column, chartScore.GreatCount, "GreatCount");
-                    break;
-                }
-                case CsvScoreColumn::MissCount:
-                {
-                    //'' HARD failed will have ex score but no miss count.
-                    if (column!="---")
-                    {
-                        int missCount{0};
-                        CheckedParse(column, missCount, "GreatCount");
-                        chartScore.MissCount = missCount;
-                    }
-                    break;
-                }
-                case CsvScoreColumn::ClearType:
-                {
-                    auto findClearTypeIndex = ies::Find(CsvClearTypeIndexMap, column);
-                    if (!findClearTypeIndex)
-                    {
-                        throw std::runtime_error("Incorrect CSV clear type ["+std::string{column}+"].");
-                    }
-                    chartScore.ClearType = static_cast<ClearType>(findClearTypeIndex.value()->second);
-                    break;
-                }
-                case CsvScoreColumn::DjLevel:
-                {
-                    if (column!="---")
-                    {
-                        auto findDjLevelIndex = ies::Find(DjLevelIndexMap, column);
-                        if (!findDjLevelIndex)
-                        {
-                            throw std::runtime_error("Incorrect CSV dj level ["+std::string{column}+"].");
-                        }
-                        chartScore.DjLevel = static_cast<DjLevel>(findDjLevelIndex.value()->second);
-                    }
-                    break;
-                }
-                default:
-                    break;
+                throw std::runtime_error("Incorrect CSV dj level ["+std::string{djLevelColumn}+"].");
             }
+            chartScore.DjLevel = static_cast<DjLevel>(findDjLevelIndex.value()->second);
         }
-
-        ++index;
     }
 
-    //ies::Time::Print<std::chrono::microseconds>(ies::Time::CountNs(begin), "ParseCsvLine");
+    music.DateTime = row.GetColumn(DateTimeColumnIndex);
+
+    //ies::Time::Print<std::chrono::microseconds>(ies::Time::CountNs(begin), "ParseCsvRow");
 
     return music;
 }
 
+CsvMusic
+ParseCsvLine(std::string_view csvLine)
+{
+    return CsvParser{}.ParseLine(csvLine);
+}
+
+CsvMusic
+ParseCsvRow(const CsvRowToken &row)
+{
+    return CsvParser{}.ParseRow(row);
+}
+
 void
 Print(const CsvMusic& csvMusic)
 {
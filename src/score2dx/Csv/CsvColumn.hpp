@@ -46,22 +46,51 @@ constexpr std::size_t CsvColumnSize = DateTimeColumnIndex+1;
 std::size_t
 ToCsvColumnIndex(Difficulty difficulty, CsvScoreColumn scoreColumn);
 
+//! @brief Decoded CSV row, text fields are views into parsed line.
+//! @note Views are valid as long as parsed buffer, copy field that must outlive buffer (e.g. DateTime of MusicScore).
 struct CsvMusic
 {
     //'' [1, 29], 0 means error version string, 1 means "1st&substream".
     std::size_t CsvVersionIndex{0};
     std::size_t PlayCount{0};
-    std::string Title;
-    std::string Genre;
-    std::string Artist;
-    std::string DateTime;
+    std::string_view Title;
+    std::string_view Genre;
+    std::string_view Artist;
+    std::string_view DateTime;
 
     std::array<ChartScore, DifficultySmartEnum::Size()> ChartScores;
 };
 
+struct CsvRowToken;
+
+//! @brief Parse context of one CSV, holds per-parse state (version of previous row as fast path of version column),
+//! lookup tables are immutable and shared by all CsvParsers.
+//! @note A CsvParser is used by one thread at a time, different CsvParsers can parse concurrently.
+class CsvParser
+{
+public:
+    //! @brief Tokenize and decode single line, throws if line does not have CsvColumnSize columns.
+    //! @note Returned views point into csvLine.
+        CsvMusic
+        ParseLine(std::string_view csvLine);
+
+    //! @brief Decode columns of tokenized row, throws if row does not have CsvColumnSize columns or column is invalid.
+        CsvMusic
+        ParseRow(const CsvRowToken &row);
+
+private:
+    //! @brief CsvVersionIndex of previous parsed row, 0 if none.
+    std::size_t mPreviousParsedVersionIndex{0};
+};
+
+//! @brief Parse line with a new CsvParser, returned views point into csvLine.
 CsvMusic
 ParseCsvLine(std::string_view csvLine);
 
+//! @brief Parse row with a new CsvParser.
+CsvMusic
+ParseCsvRow(const CsvRowToken &row);
+
 void
 Print(const CsvMusic& csvMusic);
 
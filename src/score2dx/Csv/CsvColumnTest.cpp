@@ -0,0 +1,49 @@
+#include "score2dx/Csv/CsvColumn.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "score2dx/Iidx/Version.hpp"
+
+namespace score2dx
+{
+
+TEST(CsvParser, ConcurrentParse)
+{
+    const std::string scoreColumns{",4,0,0,0,0,---,NO PLAY,---,5,980,443,94,1,FULLCOMBO CLEAR,AAA,9,1679,747,185,2,FULLCOMBO CLEAR,AA,11,1881,757,367,59,EASY CLEAR,A,0,0,0,0,---,NO PLAY,---,2021-12-04 15:33"};
+    const std::vector<std::string> versions{"CastHour", Official1stSubVersionName, "HEROIC VERSE", "CastHour"};
+    const std::vector<std::size_t> expectedVersionIndexes{FindVersionIndex("CastHour").value(), 1, FindVersionIndex("HEROIC VERSE").value(), FindVersionIndex("CastHour").value()};
+
+    std::atomic<std::size_t> mismatchCount{0};
+    std::vector<std::thread> threads;
+    for (std::size_t threadIndex = 0; threadIndex<4; ++threadIndex)
+    {
+        threads.emplace_back([&, threadIndex]()
+        {
+            CsvParser parser;
+            for (std::size_t i = 0; i<500; ++i)
+            {
+                auto versionIndex = (threadIndex+i)%versions.size();
+                auto title = "Title "+std::to_string(threadIndex);
+                auto line = versions[versionIndex]+","+title+",GENRE,ARTIST"+scoreColumns;
+                auto csvMusic = parser.ParseLine(line);
+                if (csvMusic.CsvVersionIndex!=expectedVersionIndexes[versionIndex]||csvMusic.Title!=title)
+                {
+                    ++mismatchCount;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(0u, mismatchCount.load());
+}
+
+}
@@ -0,0 +1,138 @@
+#include "score2dx/Csv/CsvRowTokenizer.hpp"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)||defined(_M_X64)||(defined(_M_IX86_FP)&&_M_IX86_FP>=2)
+#define SCORE2DX_CSV_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+#if defined(__AVX2__)
+
+constexpr std::size_t SimdWidth = 32;
+
+//! @brief Bit i is set if data[i] is ',' or '\n'.
+std::uint32_t
+MatchSeparators(const char* data)
+{
+    auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    auto commas = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(','));
+    auto newlines = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'));
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(commas, newlines)));
+}
+
+#elif defined(SCORE2DX_CSV_SSE2)
+
+constexpr std::size_t SimdWidth = 16;
+
+//! @brief Bit i is set if data[i] is ',' or '\n'.
+std::uint32_t
+MatchSeparators(const char* data)
+{
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    auto commas = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(','));
+    auto newlines = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_or_si128(commas, newlines)));
+}
+
+#endif
+
+void
+AddComma(score2dx::CsvRowToken &row, std::size_t &commaCount, std::size_t offset)
+{
+    if (commaCount<row.CommaOffsets.size())
+    {
+        row.CommaOffsets[commaCount] = offset;
+    }
+    ++commaCount;
+}
+
+}
+
+namespace score2dx
+{
+
+std::string_view
+CsvRowToken::
+GetColumn(std::size_t columnIndex)
+const
+{
+    auto begin = columnIndex==0 ? 0 : CommaOffsets[columnIndex-1]+1;
+    auto end = columnIndex<CommaOffsets.size() ? CommaOffsets[columnIndex] : Line.size();
+    return Line.substr(begin, end-begin);
+}
+
+CsvRowTokenizer::
+CsvRowTokenizer(std::string_view buffer)
+:   mBuffer(buffer)
+{
+}
+
+bool
+CsvRowTokenizer::
+Next(CsvRowToken &row)
+{
+    auto* data = mBuffer.data();
+    auto size = mBuffer.size();
+    while (mPosition<size&&data[mPosition]=='\n')
+    {
+        ++mPosition;
+    }
+    if (mPosition>=size)
+    {
+        return false;
+    }
+
+    auto lineBegin = mPosition;
+    auto lineEnd = size;
+    auto foundNewline = false;
+    std::size_t commaCount = 0;
+    auto position = lineBegin;
+
+#if defined(__AVX2__)||defined(SCORE2DX_CSV_SSE2)
+    for (; !foundNewline&&position+SimdWidth<=size; position += SimdWidth)
+    {
+        auto mask = MatchSeparators(data+position);
+        while (mask!=0)
+        {
+            auto offset = position+static_cast<std::size_t>(std::countr_zero(mask));
+            if (data[offset]=='\n')
+            {
+                lineEnd = offset;
+                foundNewline = true;
+                break;
+            }
+
+            AddComma(row, commaCount, offset-lineBegin);
+            mask &= mask-1;
+        }
+    }
+#endif
+
+    //'' tail shorter than SIMD width, or whole line if SIMD is not available.
+    for (; !foundNewline&&position<size; ++position)
+    {
+        if (data[position]=='\n')
+        {
+            lineEnd = position;
+            foundNewline = true;
+        }
+        else if (data[position]==',')
+        {
+            AddComma(row, commaCount, position-lineBegin);
+        }
+    }
+
+    row.Line = mBuffer.substr(lineBegin, lineEnd-lineBegin);
+    row.CommaCount = commaCount;
+    mPosition = foundNewline ? lineEnd+1 : size;
+    return true;
+}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "score2dx/Csv/CsvColumn.hpp"
+
+namespace score2dx
+{
+
+//! @brief Comma offsets of one CSV line.
+struct CsvRowToken
+{
+    //! @brief Line without trailing '\n'.
+    std::string_view Line;
+    //! @brief Number of commas in Line, row has CsvColumnSize columns only if CommaCount==CsvColumnSize-1.
+    std::size_t CommaCount{0};
+    //! @brief Offsets in Line of first min(CommaCount, CsvColumnSize-1) commas.
+    std::array<std::size_t, CsvColumnSize-1> CommaOffsets{};
+
+    //! @brief Get column at columnIndex, only valid if row has CsvColumnSize columns.
+        std::string_view
+        GetColumn(std::size_t columnIndex)
+        const;
+};
+
+//! @brief Split CSV buffer into rows, finding commas and newlines of each line in single pass.
+//! Scan 32 (AVX2) or 16 (SSE2) bytes a time when available, otherwise byte by byte.
+//! @note Empty lines are skipped. Quote is not handled, official CSV does not quote columns.
+class CsvRowTokenizer
+{
+public:
+    //! @brief Buffer must outlive tokenizer and returned tokens.
+        explicit CsvRowTokenizer(std::string_view buffer);
+
+    //! @brief Tokenize next non-empty line into row.
+    //! @return false if no line remains, row is untouched.
+        bool
+        Next(CsvRowToken &row);
+
+private:
+    std::string_view mBuffer;
+    std::size_t mPosition{0};
+};
+
+}
@@ -0,0 +1,65 @@
+#include "score2dx/Csv/CsvRowTokenizer.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace score2dx
+{
+
+namespace
+{
+
+const std::string CastHourLine{"CastHour,DISPARATE,CYBERPUNK,BEMANI Sound Team \"Captain Sonic\",4,0,0,0,0,---,NO PLAY,---,5,980,443,94,1,FULLCOMBO CLEAR,AAA,9,1679,747,185,2,FULLCOMBO CLEAR,AA,11,1881,757,367,59,EASY CLEAR,A,0,0,0,0,---,NO PLAY,---,2021-12-04 15:33"};
+
+}
+
+TEST(CsvRowTokenizer, Next)
+{
+    std::string buffer = "\n"+CastHourLine+"\n\n"+"a,b,,c\n"+CastHourLine;
+    CsvRowTokenizer tokenizer{buffer};
+    CsvRowToken row;
+
+    ASSERT_TRUE(tokenizer.Next(row));
+    EXPECT_EQ(CastHourLine, row.Line);
+    ASSERT_EQ(CsvColumnSize-1, row.CommaCount);
+    EXPECT_EQ("CastHour", row.GetColumn(0));
+    EXPECT_EQ("BEMANI Sound Team \"Captain Sonic\"", row.GetColumn(3));
+    EXPECT_EQ("FULLCOMBO CLEAR", row.GetColumn(ToCsvColumnIndex(Difficulty::Hyper, CsvScoreColumn::ClearType)));
+    EXPECT_EQ("2021-12-04 15:33", row.GetColumn(DateTimeColumnIndex));
+
+    ASSERT_TRUE(tokenizer.Next(row));
+    EXPECT_EQ("a,b,,c", row.Line);
+    ASSERT_EQ(3u, row.CommaCount);
+    EXPECT_EQ(1u, row.CommaOffsets[0]);
+    EXPECT_EQ(3u, row.CommaOffsets[1]);
+    EXPECT_EQ(4u, row.CommaOffsets[2]);
+
+    ASSERT_TRUE(tokenizer.Next(row));
+    EXPECT_EQ(CastHourLine, row.Line);
+    EXPECT_EQ(CsvColumnSize-1, row.CommaCount);
+
+    ASSERT_FALSE(tokenizer.Next(row));
+}
+
+TEST(CsvRowTokenizer, ParseCsvLine)
+{
+    auto csvMusic = ParseCsvLine(CastHourLine);
+    EXPECT_EQ("DISPARATE", csvMusic.Title);
+    EXPECT_EQ("CYBERPUNK", csvMusic.Genre);
+    EXPECT_EQ(4u, csvMusic.PlayCount);
+    EXPECT_EQ("2021-12-04 15:33", csvMusic.DateTime);
+
+    auto &anotherScore = csvMusic.ChartScores[static_cast<std::size_t>(Difficulty::Another)];
+    EXPECT_EQ(11, anotherScore.Level);
+    EXPECT_EQ(1881, anotherScore.ExScore);
+    EXPECT_EQ(59, anotherScore.MissCount.value());
+    EXPECT_EQ(ClearType::EASY_CLEAR, anotherScore.ClearType);
+    EXPECT_EQ(DjLevel::A, anotherScore.DjLevel);
+
+    EXPECT_THROW(ParseCsvLine(""), std::runtime_error);
+    ASSERT_THROW(ParseCsvLine(CastHourLine+",extra"), std::runtime_error);
+}
+
+}
@@ -0,0 +1,102 @@
+#include "score2dx/Csv/CsvStreamParser.hpp"
+
+#include <stdexcept>
+
+#include "score2dx/Iidx/Version.hpp"
+
+namespace score2dx
+{
+
+CsvStreamParser::
+CsvStreamParser(const std::string &iidxId,
+                PlayStyle playStyle,
+                const MusicDatabase &musicDatabase,
+                bool verbose)
+:   mMusicDatabase(musicDatabase),
+    mVerbose(verbose),
+    mCsv(new Csv())
+{
+    mCsv->SetPlayer(iidxId, playStyle, verbose);
+}
+
+void
+CsvStreamParser::
+Append(std::string_view chunk)
+{
+    if (!mCsv)
+    {
+        throw std::runtime_error("CsvStreamParser::Append(): parser is finished.");
+    }
+
+    auto lastNewline = chunk.rfind('\n');
+    if (lastNewline==std::string_view::npos)
+    {
+        mPendingLine += chunk;
+        return;
+    }
+
+    //'' complete pending line with first line of chunk, then parse rest complete lines in place.
+    auto firstNewline = chunk.find('\n');
+    mPendingLine += chunk.substr(0, firstNewline+1);
+    ParseLines(mPendingLine);
+    ParseLines(chunk.substr(firstNewline+1, lastNewline-firstNewline));
+    mPendingLine = chunk.substr(lastNewline+1);
+}
+
+std::unique_ptr<Csv>
+CsvStreamParser::
+Finish()
+{
+    if (!mCsv)
+    {
+        throw std::runtime_error("CsvStreamParser::Finish(): parser is finished.");
+    }
+
+    ParseLines(mPendingLine);
+    mPendingLine.clear();
+
+    if (mLastRowVersion.empty())
+    {
+        throw std::runtime_error("ParseCsvLine exception:\n    CSV has less than two lines.\n");
+    }
+    if (!FindVersionIndex(mLastRowVersion))
+    {
+        throw std::runtime_error("ParseCsvLine exception:\n    Cannot find index of CSV version ["+mLastRowVersion+"].\n");
+    }
+
+    mCsv->FinishParse(mProgress, mVerbose);
+    return std::move(mCsv);
+}
+
+void
+CsvStreamParser::
+ParseLines(std::string_view lines)
+{
+    if (!mHasHeader)
+    {
+        auto headerBegin = lines.find_first_not_of('\n');
+        if (headerBegin==std::string_view::npos)
+        {
+            return;
+        }
+
+        auto headerEnd = lines.find('\n', headerBegin);
+        mHasHeader = true;
+        lines = headerEnd==std::string_view::npos ? std::string_view{} : lines.substr(headerEnd+1);
+    }
+
+    auto rowsEnd = lines.find_last_not_of('\n');
+    if (rowsEnd==std::string_view::npos)
+    {
+        return;
+    }
+
+    auto lastRowBegin = lines.rfind('\n', rowsEnd);
+    auto lastRow = lines.substr(lastRowBegin==std::string_view::npos ? 0 : lastRowBegin+1);
+    mLastRowVersion = lastRow.substr(0, lastRow.find(','));
+
+    //'' active version is unknown until last row, only used by checkWithDatabase.
+    mCsv->ParseRows(lines, mMusicDatabase, 0, false, 1, mProgress);
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "score2dx/Core/MusicDatabase.hpp"
+#include "score2dx/Csv/Csv.hpp"
+
+namespace score2dx
+{
+
+//! @brief Parse official CSV content incrementally as chunks arrive, e.g. body of upload request,
+//! so parsing overlaps receiving. IIDX ID and play style are given instead of filename.
+//! Complete lines of each appended chunk are parsed immediately, incomplete last line is kept until
+//! next chunk or Finish. Result is same as Csv constructed from whole content.
+//! @note checkWithDatabase is not supported, it needs active version from last line of CSV.
+class CsvStreamParser
+{
+public:
+    //! @brief Throws if iidxId is invalid.
+        CsvStreamParser(const std::string &iidxId,
+                        PlayStyle playStyle,
+                        const MusicDatabase &musicDatabase,
+                        bool verbose=false);
+
+    //! @brief Append next chunk of content, chunk is not accessed after return.
+    //! Throws if a complete row is invalid, parser should be discarded then.
+        void
+        Append(std::string_view chunk);
+
+    //! @brief Parse remaining content and get parsed Csv, throws if content is invalid.
+    //! @note Parser cannot be used after Finish.
+        std::unique_ptr<Csv>
+        Finish();
+
+private:
+    const MusicDatabase &mMusicDatabase;
+    bool mVerbose{false};
+    //! @brief Csv being parsed, empty after Finish.
+    std::unique_ptr<Csv> mCsv;
+    Csv::ParseProgress mProgress;
+    bool mHasHeader{false};
+    //! @brief Incomplete last line of appended chunks.
+    std::string mPendingLine;
+    //! @brief Version column of last row, CSV version.
+    std::string mLastRowVersion;
+
+    //! @brief Parse complete lines, first non-empty line of content is header.
+        void
+        ParseLines(std::string_view lines);
+};
+
+}
@@ -0,0 +1,112 @@
+#include "score2dx/Csv/CsvStreamParser.hpp"
+
+#include <algorithm>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "score2dx/Core/TestUtil.hpp"
+
+namespace score2dx
+{
+
+namespace
+{
+
+const std::string TestIidxId{"5483-7391"};
+
+//! @brief Parse content by CsvStreamParser, appended in chunks split at splitOffsets.
+std::string
+ParseSplit(std::string_view content,
+           const MusicDatabase &musicDatabase,
+           std::vector<std::size_t> splitOffsets)
+{
+    CsvStreamParser parser{TestIidxId, PlayStyle::SinglePlay, musicDatabase};
+    std::size_t begin = 0;
+    splitOffsets.emplace_back(content.size());
+    for (auto offset : splitOffsets)
+    {
+        parser.Append(content.substr(begin, offset-begin));
+        begin = offset;
+    }
+    return ToTestString(*parser.Finish());
+}
+
+//! @brief Parse content by CsvStreamParser, appended in chunks of chunkSize.
+std::string
+ParseChunks(std::string_view content,
+            const MusicDatabase &musicDatabase,
+            std::size_t chunkSize)
+{
+    CsvStreamParser parser{TestIidxId, PlayStyle::SinglePlay, musicDatabase};
+    for (std::size_t begin = 0; begin<content.size(); begin += chunkSize)
+    {
+        parser.Append(content.substr(begin, chunkSize));
+    }
+    return ToTestString(*parser.Finish());
+}
+
+}
+
+TEST(CsvStreamParser, Chunks)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase)
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    auto fullContent = MakeCsvContent(*musicDatabase, PlayStyle::SinglePlay, 30, "2023-03-05");
+    auto csvPath = ToCsvFilename(TestIidxId, PlayStyle::SinglePlay);
+
+    for (std::string_view content : {std::string_view{fullContent}, std::string_view{fullContent}.substr(0, fullContent.size()-1)})
+    {
+        SCOPED_TRACE(content.back()=='\n' ? "trailing newline" : "no trailing newline");
+        auto expected = ToTestString(Csv{csvPath, std::span<const char>{content.data(), content.size()}, *musicDatabase});
+
+        for (std::size_t chunkSize : {std::size_t{1}, std::size_t{7}, std::size_t{4099}, content.size()})
+        {
+            EXPECT_EQ(expected, ParseChunks(content, *musicDatabase, chunkSize)) << "chunkSize " << chunkSize;
+        }
+
+        //'' header split, then first row split, then last row split before its newline.
+        auto headerEnd = content.find('\n');
+        auto firstRowEnd = content.find('\n', headerEnd+1);
+        EXPECT_EQ(expected, ParseSplit(content, *musicDatabase, {headerEnd/2, headerEnd+1+(firstRowEnd-headerEnd)/2, content.size()-3}));
+        EXPECT_EQ(expected, ParseSplit(content, *musicDatabase, {headerEnd, headerEnd+1, firstRowEnd, firstRowEnd+1}));
+
+        std::istringstream stream{std::string{content}};
+        EXPECT_EQ(expected, ToTestString(Csv{TestIidxId, PlayStyle::SinglePlay, stream, *musicDatabase}));
+    }
+}
+
+TEST(CsvStreamParser, InvalidContent)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase)
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    EXPECT_THROW((CsvStreamParser{"invalid", PlayStyle::SinglePlay, *musicDatabase}), std::runtime_error);
+
+    CsvStreamParser headerOnlyParser{TestIidxId, PlayStyle::SinglePlay, *musicDatabase};
+    headerOnlyParser.Append("header,only");
+    EXPECT_THROW(headerOnlyParser.Finish(), std::runtime_error);
+
+    auto content = MakeCsvContent(*musicDatabase, PlayStyle::SinglePlay, 30, "2023-03-05");
+    auto secondRowBegin = content.find('\n', content.find('\n')+1)+1;
+    content.insert(secondRowBegin, "RESIDENT,BROKEN\n");
+    CsvStreamParser parser{TestIidxId, PlayStyle::SinglePlay, *musicDatabase};
+    EXPECT_THROW(parser.Append(content), std::runtime_error);
+
+    std::istringstream stream{content};
+    EXPECT_THROW((Csv{TestIidxId, PlayStyle::SinglePlay, stream, *musicDatabase}), std::runtime_error);
+}
+
+}
@@ -1,5 +1,10 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+#include "score2dx/Core/TestUtil.hpp"
 #include "score2dx/Csv/Csv.hpp"
 
 namespace score2dx
@@ -12,4 +17,94 @@ TEST(StringTree, TreeSpec)
 }
 */
 
+namespace
+{
+
+const std::string TestIidxId{"5483-7391"};
+
+void
+ExpectSameScores(const Csv &expected, const Csv &actual)
+{
+    ASSERT_EQ(expected.GetScores().size(), actual.GetScores().size());
+    for (auto &[musicId, musicScore] : expected.GetScores())
+    {
+        auto findMusicScore = actual.GetScores().find(musicId);
+        ASSERT_NE(actual.GetScores().end(), findMusicScore);
+        EXPECT_EQ(ToTestString(musicScore), ToTestString(findMusicScore->second));
+    }
+}
+
+std::string
+FindMinDateTime(const Csv &csv)
+{
+    std::string minDateTime;
+    for (auto &[musicId, musicScore] : csv.GetScores())
+    {
+        if (minDateTime.empty()||musicScore.GetDateTime()<minDateTime) { minDateTime = musicScore.GetDateTime(); }
+    }
+    return minDateTime;
+}
+
+std::string
+GetParseError(std::string_view content,
+              const MusicDatabase &musicDatabase,
+              std::size_t parseThreadCount)
+{
+    try
+    {
+        Csv csv{TestIidxId, PlayStyle::SinglePlay, content, musicDatabase, false, false, parseThreadCount};
+    }
+    catch (const std::exception &e)
+    {
+        return e.what();
+    }
+    return {};
+}
+
+}
+
+TEST(Csv, ParseRowsThreadCount)
+{
+    auto musicDatabase = FindTestMusicDatabase();
+    if (!musicDatabase)
+    {
+        GTEST_SKIP() << "music database is not available.";
+    }
+
+    //'' every row is played again later with other scores, each duplicated row is in a later chunk than its first row.
+    auto firstContent = MakeCsvContent(*musicDatabase, PlayStyle::SinglePlay, 30, "2023-03-05");
+    auto duplicatedContent = MakeCsvContent(*musicDatabase, PlayStyle::SinglePlay, 30, "2023-03-06", 1);
+    auto content = firstContent+duplicatedContent.substr(duplicatedContent.find('\n')+1);
+    ASSERT_GT(content.size(), 4*64*1024u);
+
+    Csv firstCsv{TestIidxId, PlayStyle::SinglePlay, firstContent, *musicDatabase};
+    Csv serialCsv{TestIidxId, PlayStyle::SinglePlay, content, *musicDatabase, false, false, 1};
+    ExpectSameScores(firstCsv, serialCsv);
+    EXPECT_EQ(30u, serialCsv.GetVersionIndex());
+    EXPECT_EQ("2023-03-06", serialCsv.GetLastDateTime().substr(0, 10));
+
+    for (std::size_t parseThreadCount : {2, 4, 0})
+    {
+        Csv csv{TestIidxId, PlayStyle::SinglePlay, content, *musicDatabase, false, false, parseThreadCount};
+        ExpectSameScores(serialCsv, csv);
+        EXPECT_EQ(serialCsv.GetVersionIndex(), csv.GetVersionIndex());
+        EXPECT_EQ(serialCsv.GetTotalPlayCount(), csv.GetTotalPlayCount());
+        EXPECT_EQ(serialCsv.GetLastDateTime(), csv.GetLastDateTime());
+        EXPECT_EQ(FindMinDateTime(serialCsv), FindMinDateTime(csv));
+    }
+
+    //'' error reports line number in whole CSV file, not in chunk.
+    auto brokenLineBegin = content.rfind('\n', content.size()*3/4)+1;
+    auto brokenLineEnd = content.find('\n', brokenLineBegin);
+    auto brokenContent = content;
+    brokenContent.replace(brokenLineBegin, brokenLineEnd-brokenLineBegin, "RESIDENT,BROKEN");
+    auto lineNumber = std::count(content.begin(), content.begin()+static_cast<std::ptrdiff_t>(brokenLineBegin), '\n')+1;
+    auto serialError = GetParseError(brokenContent, *musicDatabase, 1);
+    EXPECT_NE(std::string::npos, serialError.find("Line ("+std::to_string(lineNumber)+"): RESIDENT,BROKEN"));
+    for (std::size_t parseThreadCount : {2, 4, 0})
+    {
+        EXPECT_EQ(serialError, GetParseError(brokenContent, *musicDatabase, parseThreadCount));
+    }
+}
+
 }
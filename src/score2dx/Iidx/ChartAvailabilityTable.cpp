@@ -0,0 +1,237 @@
+#include "score2dx/Iidx/ChartAvailabilityTable.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace score2dx
+{
+
+ChartAvailabilityTable::
+ChartAvailabilityTable(std::size_t chartCount, std::size_t versionCount)
+:   mChartCount(chartCount),
+    mVersionCount(versionCount),
+    mStatuses(chartCount*versionCount, static_cast<std::uint8_t>(ChartStatus::NotAvailable)),
+    mLevels(chartCount*versionCount, 0),
+    mNotes(chartCount*versionCount, 0),
+    mChartIndexes(chartCount*versionCount, 0),
+    mContainingRangeBegins(chartCount*versionCount, 0),
+    mContainingRangeEnds(chartCount*versionCount, 0),
+    mSameChartVersions(chartCount*versionCount, 0),
+    mSameChartBegins(chartCount*versionCount, 0),
+    mSameChartEnds(chartCount*versionCount, 0)
+{
+    if (versionCount>std::numeric_limits<std::uint8_t>::max())
+    {
+        throw std::runtime_error("ChartAvailabilityTable: versionCount out of range.");
+    }
+}
+
+std::size_t
+ChartAvailabilityTable::
+GetChartCount()
+const
+{
+    return mChartCount;
+}
+
+std::size_t
+ChartAvailabilityTable::
+GetVersionCount()
+const
+{
+    return mVersionCount;
+}
+
+ChartAvailability
+ChartAvailabilityTable::
+Get(std::size_t chartRow, std::size_t versionIndex)
+const
+{
+    auto cellIndex = ToCellIndex(chartRow, versionIndex);
+
+    ChartAvailability availability;
+    availability.ChartAvailableStatus = static_cast<ChartStatus>(mStatuses[cellIndex]);
+    availability.ChartInfoProp = ChartInfo{mLevels[cellIndex], mNotes[cellIndex]};
+    availability.ChartIndex = mChartIndexes[cellIndex];
+    return availability;
+}
+
+ChartStatus
+ChartAvailabilityTable::
+GetStatus(std::size_t chartRow, std::size_t versionIndex)
+const
+{
+    return static_cast<ChartStatus>(mStatuses[ToCellIndex(chartRow, versionIndex)]);
+}
+
+ChartInfo
+ChartAvailabilityTable::
+GetChartInfo(std::size_t chartRow, std::size_t versionIndex)
+const
+{
+    auto cellIndex = ToCellIndex(chartRow, versionIndex);
+    return ChartInfo{mLevels[cellIndex], mNotes[cellIndex]};
+}
+
+std::size_t
+ChartAvailabilityTable::
+GetChartIndex(std::size_t chartRow, std::size_t versionIndex)
+const
+{
+    return mChartIndexes[ToCellIndex(chartRow, versionIndex)];
+}
+
+std::span<const std::uint8_t>
+ChartAvailabilityTable::
+GetStatusColumn(std::size_t versionIndex)
+const
+{
+    if (versionIndex>=mVersionCount)
+    {
+        throw std::runtime_error("ChartAvailabilityTable: versionIndex is out of bound.");
+    }
+
+    return std::span<const std::uint8_t>{mStatuses}.subspan(versionIndex*mChartCount, mChartCount);
+}
+
+void
+ChartAvailabilityTable::
+Set(std::size_t chartRow, std::size_t versionIndex, const ChartAvailability &availability)
+{
+    auto &chartInfo = availability.ChartInfoProp;
+    if (chartInfo.Level<0||chartInfo.Level>std::numeric_limits<std::uint8_t>::max()
+        ||chartInfo.Note<0||chartInfo.Note>std::numeric_limits<std::uint16_t>::max()
+        ||availability.ChartIndex>std::numeric_limits<std::uint8_t>::max())
+    {
+        throw std::runtime_error("ChartAvailabilityTable::Set(): level, note or chart index out of range.");
+    }
+
+    auto cellIndex = ToCellIndex(chartRow, versionIndex);
+    mStatuses[cellIndex] = static_cast<std::uint8_t>(availability.ChartAvailableStatus);
+    mLevels[cellIndex] = static_cast<std::uint8_t>(chartInfo.Level);
+    mNotes[cellIndex] = static_cast<std::uint16_t>(chartInfo.Note);
+    mChartIndexes[cellIndex] = static_cast<std::uint8_t>(availability.ChartIndex);
+}
+
+void
+ChartAvailabilityTable::
+SetStatus(std::size_t chartRow, std::size_t versionIndex, ChartStatus status)
+{
+    mStatuses[ToCellIndex(chartRow, versionIndex)] = static_cast<std::uint8_t>(status);
+}
+
+void
+ChartAvailabilityTable::
+IndexChartRow(std::size_t chartRow)
+{
+    if (mVersionCount==0) { return; }
+
+    //'' containing range begin: nearest BeginAvailable at or before version, version itself if none.
+    std::optional<std::size_t> lastBeginAvailable;
+    for (std::size_t versionIndex = 0; versionIndex<mVersionCount; ++versionIndex)
+    {
+        auto cellIndex = ToCellIndex(chartRow, versionIndex);
+        auto status = static_cast<ChartStatus>(mStatuses[cellIndex]);
+        if (status==ChartStatus::BeginAvailable)
+        {
+            lastBeginAvailable = versionIndex;
+        }
+
+        auto isAvailable = status==ChartStatus::BeginAvailable||status==ChartStatus::Available;
+        auto begin = lastBeginAvailable.value_or(versionIndex);
+        mContainingRangeBegins[cellIndex] = static_cast<std::uint8_t>(isAvailable ? begin : 0);
+    }
+
+    //'' containing range end: first Removed after version, version+1 if latest or not removed afterward.
+    std::optional<std::size_t> nextRemoved;
+    for (auto versionIndex = mVersionCount; versionIndex-->0;)
+    {
+        auto cellIndex = ToCellIndex(chartRow, versionIndex);
+        auto status = static_cast<ChartStatus>(mStatuses[cellIndex]);
+        auto isAvailable = status==ChartStatus::BeginAvailable||status==ChartStatus::Available;
+        auto end = nextRemoved.value_or(versionIndex+1);
+        mContainingRangeEnds[cellIndex] = static_cast<std::uint8_t>(isAvailable ? end : 0);
+
+        if (status==ChartStatus::Removed)
+        {
+            nextRemoved = versionIndex;
+        }
+    }
+
+    //'' same chart versions: row versions sorted by chart index, each cell records its chart index group.
+    auto rowVersions = std::span<std::uint8_t>{mSameChartVersions}.subspan(chartRow*mVersionCount, mVersionCount);
+    std::iota(rowVersions.begin(), rowVersions.end(), std::uint8_t{0});
+    std::stable_sort(rowVersions.begin(), rowVersions.end(),
+        [&](std::uint8_t lhs, std::uint8_t rhs)
+        {
+            return GetChartIndex(chartRow, lhs)<GetChartIndex(chartRow, rhs);
+        }
+    );
+
+    std::size_t groupBegin = 0;
+    while (groupBegin<mVersionCount)
+    {
+        auto chartIndex = GetChartIndex(chartRow, rowVersions[groupBegin]);
+        auto groupEnd = groupBegin+1;
+        while (groupEnd<mVersionCount&&GetChartIndex(chartRow, rowVersions[groupEnd])==chartIndex)
+        {
+            ++groupEnd;
+        }
+
+        for (auto i = groupBegin; i<groupEnd; ++i)
+        {
+            auto cellIndex = ToCellIndex(chartRow, rowVersions[i]);
+            mSameChartBegins[cellIndex] = static_cast<std::uint8_t>(groupBegin);
+            mSameChartEnds[cellIndex] = static_cast<std::uint8_t>(groupEnd);
+        }
+        groupBegin = groupEnd;
+    }
+}
+
+std::optional<ies::IndexRange>
+ChartAvailabilityTable::
+FindContainingAvailableVersionRange(std::size_t chartRow, std::size_t versionIndex)
+const
+{
+    auto cellIndex = ToCellIndex(chartRow, versionIndex);
+    auto status = static_cast<ChartStatus>(mStatuses[cellIndex]);
+    if (status==ChartStatus::NotAvailable||status==ChartStatus::Removed)
+    {
+        return std::nullopt;
+    }
+
+    return ies::IndexRange{mContainingRangeBegins[cellIndex], mContainingRangeEnds[cellIndex]};
+}
+
+std::span<const std::uint8_t>
+ChartAvailabilityTable::
+GetSameChartVersions(std::size_t chartRow, std::size_t versionIndex)
+const
+{
+    auto cellIndex = ToCellIndex(chartRow, versionIndex);
+    if (static_cast<ChartStatus>(mStatuses[cellIndex])==ChartStatus::NotAvailable)
+    {
+        return {};
+    }
+
+    auto begin = mSameChartBegins[cellIndex];
+    auto end = mSameChartEnds[cellIndex];
+    return std::span<const std::uint8_t>{mSameChartVersions}.subspan(chartRow*mVersionCount+begin, end-begin);
+}
+
+std::size_t
+ChartAvailabilityTable::
+ToCellIndex(std::size_t chartRow, std::size_t versionIndex)
+const
+{
+    if (chartRow>=mChartCount||versionIndex>=mVersionCount)
+    {
+        throw std::runtime_error("ChartAvailabilityTable: chartRow or versionIndex is out of bound.");
+    }
+
+    return versionIndex*mChartCount+chartRow;
+}
+
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "ies/Common/IntegralRange.hxx"
+#include "ies/Common/SmartEnum.hxx"
+
+#include "score2dx/Iidx/ChartInfo.hpp"
+
+namespace score2dx
+{
+
+//! @brief ChartStatus denotes chart's availbility in timeline.
+//! NotAvailable: before chart debut (all versions before music's version)
+//!     Exception: two copula music 'Routing' and 'Shakunetsu Pt.2 Long Train Running'
+//!     "previewed" in pendual, will have 22 as BeginAvailable.
+//! BeginAvailable denotes first debut or revived version.
+//! Available denotes continued available version after BeginAvailable.
+//! Removed denotes version after music removed (to before it's next revive).
+//! Example: DPN of 'LUV TO ME(disco mix)' has ChartVersions '00-04, 06, 10-15'
+//!     00 01 02 03 04 05 06 07 08 09 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29
+//!     BA A  A  A  A  RM BA RM RM RM BA A  A  A  A  A  RM RM RM RM RM RM RM RM RM RM RM RM RM RM
+IES_SMART_ENUM(ChartStatus,
+    NotAvailable,
+    BeginAvailable,
+    Available,
+    Removed
+);
+
+struct ChartAvailability
+{
+    ChartStatus ChartAvailableStatus{ChartStatus::NotAvailable};
+    //! @brief ChartInfo may change because level changed.
+    ChartInfo ChartInfoProp{0, 0};
+    //! @brief Two charts are regarded as same chart if they have same notes.
+    //! This Index point to unique note chart and can use to identify chart.
+    //! @note ChartInfo may be changed (level change).
+    std::size_t ChartIndex{0};
+};
+
+//! @brief Dense structure-of-arrays table of ChartAvailability, indexed by {ChartRow, VersionIndex}.
+//! ChartRow is dense index of a music's style difficulty assigned by table owner (e.g. MusicDatabase).
+//! Each field is a separate column, cells of same version are contiguous, so scanning all charts at a version
+//! (e.g. generate active version) reads one status column sequentially.
+//! Each chart row also has interval index answering containing available range and same chart versions
+//! without scanning or allocating, rebuilt by IndexChartRow after row is written.
+//! @note Different rows can be written and indexed concurrently, table size is fixed at construction.
+class ChartAvailabilityTable
+{
+public:
+        ChartAvailabilityTable() = default;
+
+    //! @brief Create table of chartCount charts and versionCount versions, all cells are NotAvailable.
+    //! @note versionCount must fit std::uint8_t.
+        ChartAvailabilityTable(std::size_t chartCount, std::size_t versionCount);
+
+        std::size_t
+        GetChartCount()
+        const;
+
+        std::size_t
+        GetVersionCount()
+        const;
+
+        ChartAvailability
+        Get(std::size_t chartRow, std::size_t versionIndex)
+        const;
+
+        ChartStatus
+        GetStatus(std::size_t chartRow, std::size_t versionIndex)
+        const;
+
+        ChartInfo
+        GetChartInfo(std::size_t chartRow, std::size_t versionIndex)
+        const;
+
+        std::size_t
+        GetChartIndex(std::size_t chartRow, std::size_t versionIndex)
+        const;
+
+    //! @brief Status column of versionIndex, Span of {Index=ChartRow, ChartStatus as std::uint8_t}.
+        std::span<const std::uint8_t>
+        GetStatusColumn(std::size_t versionIndex)
+        const;
+
+    //! @note Throws if level, note or chart index exceeds column storage.
+        void
+        Set(std::size_t chartRow, std::size_t versionIndex, const ChartAvailability &availability);
+
+        void
+        SetStatus(std::size_t chartRow, std::size_t versionIndex, ChartStatus status);
+
+    //! @brief Rebuild interval index of chartRow from its cells, call after all versions of chartRow are set.
+        void
+        IndexChartRow(std::size_t chartRow);
+
+    //! @brief Find version range [Begin, End) containing versionIndex of chart, from the nearest BeginAvailable
+    //! at or before versionIndex, to the first Removed after versionIndex (versionIndex+1 if no such Removed).
+    //! @return nullopt if chart is NotAvailable or Removed at versionIndex.
+        std::optional<ies::IndexRange>
+        FindContainingAvailableVersionRange(std::size_t chartRow, std::size_t versionIndex)
+        const;
+
+    //! @brief Get versions have same chart index as [versionIndex], Span of {VersionIndex} in ascending order.
+    //! @note Empty if chart is NotAvailable at [versionIndex].
+        std::span<const std::uint8_t>
+        GetSameChartVersions(std::size_t chartRow, std::size_t versionIndex)
+        const;
+
+private:
+    std::size_t mChartCount{0};
+    std::size_t mVersionCount{0};
+
+    //! @brief Columns of {Index=VersionIndex*ChartCount+ChartRow, Field}.
+    std::vector<std::uint8_t> mStatuses;
+    std::vector<std::uint8_t> mLevels;
+    std::vector<std::uint16_t> mNotes;
+    std::vector<std::uint8_t> mChartIndexes;
+
+    //! @brief Interval index columns of {Index=CellIndex, ContainingAvailableVersionRange Begin or End}.
+    std::vector<std::uint8_t> mContainingRangeBegins;
+    std::vector<std::uint8_t> mContainingRangeEnds;
+
+    //! @brief Vector of {Index=ChartRow*VersionCount+i, VersionIndex}, each row's versions sorted by {ChartIndex, VersionIndex}.
+    std::vector<std::uint8_t> mSameChartVersions;
+    //! @brief Interval index columns of {Index=CellIndex, Begin or End position of same chart versions in row}.
+    std::vector<std::uint8_t> mSameChartBegins;
+    std::vector<std::uint8_t> mSameChartEnds;
+
+        std::size_t
+        ToCellIndex(std::size_t chartRow, std::size_t versionIndex)
+        const;
+};
+
+}
@@ -0,0 +1,71 @@
+#include "score2dx/Iidx/ChartAvailabilityTable.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace score2dx
+{
+
+TEST(ChartAvailabilityTable, SetGet)
+{
+    ChartAvailabilityTable table{3, 4};
+    EXPECT_EQ(3u, table.GetChartCount());
+    EXPECT_EQ(4u, table.GetVersionCount());
+    EXPECT_EQ(ChartStatus::NotAvailable, table.GetStatus(2, 3));
+
+    table.Set(1, 2, {ChartStatus::BeginAvailable, {12, 2345}, 1});
+    auto availability = table.Get(1, 2);
+    EXPECT_EQ(ChartStatus::BeginAvailable, availability.ChartAvailableStatus);
+    EXPECT_EQ(ChartInfo(12, 2345), availability.ChartInfoProp);
+    EXPECT_EQ(1u, availability.ChartIndex);
+    EXPECT_EQ(ChartInfo(0, 0), table.GetChartInfo(1, 1));
+
+    table.SetStatus(0, 2, ChartStatus::Removed);
+    auto statuses = table.GetStatusColumn(2);
+    ASSERT_EQ(3u, statuses.size());
+    EXPECT_EQ(static_cast<std::uint8_t>(ChartStatus::Removed), statuses[0]);
+    EXPECT_EQ(static_cast<std::uint8_t>(ChartStatus::BeginAvailable), statuses[1]);
+    EXPECT_EQ(static_cast<std::uint8_t>(ChartStatus::NotAvailable), statuses[2]);
+
+    EXPECT_THROW(table.Get(3, 0), std::runtime_error);
+    EXPECT_THROW(table.GetStatusColumn(4), std::runtime_error);
+    ASSERT_THROW(table.Set(0, 0, {ChartStatus::Available, {1, 70000}, 0}), std::runtime_error);
+}
+
+TEST(ChartAvailabilityTable, IndexChartRow)
+{
+    //'' row 1: 0-2 chart 0, 4-5 chart 1.
+    //''     0  1  2  3  4  5  6  7
+    //''     BA A  A  RM BA A  RM RM
+    ChartAvailabilityTable table{2, 8};
+    table.Set(1, 0, {ChartStatus::BeginAvailable, {10, 1000}, 0});
+    table.Set(1, 1, {ChartStatus::Available, {10, 1000}, 0});
+    table.Set(1, 2, {ChartStatus::Available, {11, 1000}, 0});
+    table.SetStatus(1, 3, ChartStatus::Removed);
+    table.Set(1, 4, {ChartStatus::BeginAvailable, {11, 1200}, 1});
+    table.Set(1, 5, {ChartStatus::Available, {11, 1200}, 1});
+    table.SetStatus(1, 6, ChartStatus::Removed);
+    table.SetStatus(1, 7, ChartStatus::Removed);
+    table.IndexChartRow(1);
+
+    auto range1 = table.FindContainingAvailableVersionRange(1, 1).value();
+    EXPECT_EQ(0u, range1.GetMin());
+    EXPECT_EQ(2u, range1.GetMax());
+    auto range5 = table.FindContainingAvailableVersionRange(1, 5).value();
+    EXPECT_EQ(4u, range5.GetMin());
+    EXPECT_EQ(5u, range5.GetMax());
+    EXPECT_EQ(4u, table.FindContainingAvailableVersionRange(1, 4).value().GetMin());
+    EXPECT_FALSE(table.FindContainingAvailableVersionRange(1, 3));
+    EXPECT_FALSE(table.FindContainingAvailableVersionRange(0, 0));
+
+    //'' removed versions keep default chart index, so they are listed with chart 0.
+    auto chart0Versions = table.GetSameChartVersions(1, 2);
+    EXPECT_EQ((std::vector<std::uint8_t>{0, 1, 2, 3, 6, 7}), std::vector<std::uint8_t>(chart0Versions.begin(), chart0Versions.end()));
+    auto chart1Versions = table.GetSameChartVersions(1, 4);
+    EXPECT_EQ((std::vector<std::uint8_t>{4, 5}), std::vector<std::uint8_t>(chart1Versions.begin(), chart1Versions.end()));
+    EXPECT_TRUE(table.GetSameChartVersions(0, 0).empty());
+}
+
+}
@@ -16,13 +16,27 @@ namespace score2dx
 
 Music::
 Music(std::size_t musicId, const std::string &title)
-:   mMusicId(musicId)
+:   mMusicId(musicId),
+    mOwnedChartAvailabilityTable(std::make_unique<ChartAvailabilityTable>(StyleDifficultySmartEnum::Size(), VersionNames.size())),
+    mChartAvailabilityTable(mOwnedChartAvailabilityTable.get())
+{
+    mMusicInfo.SetField(MusicInfoField::Title, title);
+}
+
+Music::
+Music(std::size_t musicId,
+      const std::string &title,
+      ChartAvailabilityTable &chartAvailabilityTable,
+      std::size_t chartRowBegin)
+:   mMusicId(musicId),
+    mChartAvailabilityTable(&chartAvailabilityTable),
+    mChartRowBegin(chartRowBegin)
 {
     mMusicInfo.SetField(MusicInfoField::Title, title);
 
-    for (auto styleDifficulty : StyleDifficultySmartEnum::ToRange())
+    if (chartRowBegin+StyleDifficultySmartEnum::Size()>chartAvailabilityTable.GetChartCount())
     {
-        mChartAvailabilityTable[static_cast<std::size_t>(styleDifficulty)].resize(VersionNames.size());
+        throw std::runtime_error("Music::Music(): chart rows out of table bound.");
     }
 }
 
@@ -60,7 +74,9 @@ AddAvailability(StyleDifficulty styleDifficulty,
                 const std::map<std::string, ChartInfo> &chartInfoByChartVersions)
 {
     auto styleDifficultyIndex = static_cast<std::size_t>(styleDifficulty);
-    auto &verTable = mChartAvailabilityTable[styleDifficultyIndex];
+    auto &table = *mChartAvailabilityTable;
+    auto chartRow = GetChartRow(styleDifficulty);
+    auto versionCount = table.GetVersionCount();
     auto &chartNotes = mChartNoteByIndex[styleDifficultyIndex];
     chartNotes.reserve(chartInfoByChartVersions.size());
 
@@ -88,39 +104,66 @@ AddAvailability(StyleDifficulty styleDifficulty,
         {
             for (auto versionIndex : range)
             {
-                if (versionIndex>=verTable.size())
+                if (versionIndex>=versionCount)
                 {
                     throw std::runtime_error(fmt::format("Music::AddAvailabilityversion(): Index [{}] out of bound.", versionIndex));
                 }
 
-                auto &availability = verTable[versionIndex];
-                availability.ChartAvailableStatus = ChartStatus::Available;
-                availability.ChartIndex = chartIndex;
-                availability.ChartInfoProp = chartInfo;
+                table.Set(chartRow, versionIndex, {ChartStatus::Available, chartInfo, chartIndex});
             }
         }
     }
 
-    for (auto i : IndexRange{0, verTable.size()-1})
+    for (auto i : IndexRange{0, versionCount-1})
     {
-        auto &previousAvailability = verTable[i];
-        auto &currentAvailability = verTable[i+1];
+        auto previousStatus = table.GetStatus(chartRow, i);
+        auto currentStatus = table.GetStatus(chartRow, i+1);
 
-        if ((previousAvailability.ChartAvailableStatus==ChartStatus::NotAvailable
-                || previousAvailability.ChartAvailableStatus==ChartStatus::Removed)
-            &&currentAvailability.ChartAvailableStatus==ChartStatus::Available)
+        if ((previousStatus==ChartStatus::NotAvailable
+                || previousStatus==ChartStatus::Removed)
+            &&currentStatus==ChartStatus::Available)
         {
-            currentAvailability.ChartAvailableStatus = ChartStatus::BeginAvailable;
+            table.SetStatus(chartRow, i+1, ChartStatus::BeginAvailable);
         }
 
-        if ((previousAvailability.ChartAvailableStatus==ChartStatus::BeginAvailable
-                || previousAvailability.ChartAvailableStatus==ChartStatus::Available
-                || previousAvailability.ChartAvailableStatus==ChartStatus::Removed)
-            &&currentAvailability.ChartAvailableStatus==ChartStatus::NotAvailable)
+        if ((previousStatus==ChartStatus::BeginAvailable
+                || previousStatus==ChartStatus::Available
+                || previousStatus==ChartStatus::Removed)
+            &&currentStatus==ChartStatus::NotAvailable)
         {
-            currentAvailability.ChartAvailableStatus = ChartStatus::Removed;
+            table.SetStatus(chartRow, i+1, ChartStatus::Removed);
         }
     }
+
+    table.IndexChartRow(chartRow);
+}
+
+void
+Music::
+RestoreAvailability(StyleDifficulty styleDifficulty,
+                    const std::vector<ChartAvailability> &availabilities,
+                    std::vector<int> chartNotes)
+{
+    if (availabilities.size()!=mChartAvailabilityTable->GetVersionCount())
+    {
+        throw std::runtime_error("Music::RestoreAvailability(): availabilities size is not version count.");
+    }
+
+    auto chartRow = GetChartRow(styleDifficulty);
+    for (auto versionIndex : IndexRange{0, availabilities.size()})
+    {
+        mChartAvailabilityTable->Set(chartRow, versionIndex, availabilities[versionIndex]);
+    }
+    mChartAvailabilityTable->IndexChartRow(chartRow);
+    mChartNoteByIndex[static_cast<std::size_t>(styleDifficulty)] = std::move(chartNotes);
+}
+
+const std::vector<int> &
+Music::
+GetChartNotes(StyleDifficulty styleDifficulty)
+const
+{
+    return mChartNoteByIndex[static_cast<std::size_t>(styleDifficulty)];
 }
 
 std::vector<std::size_t>
@@ -137,22 +180,23 @@ const
 
     chartFirstVersions.reserve(chartNotes.size());
 
-    auto& verTable = mChartAvailabilityTable[static_cast<std::size_t>(styleDifficulty)];
+    auto chartRow = GetChartRow(styleDifficulty);
     //'' note: assume chart index is incrementally labelled.
-    for (auto& availability : verTable)
+    for (auto versionIndex : IndexRange{0, mChartAvailabilityTable->GetVersionCount()})
     {
-        if (availability.ChartIndex<chartFirstVersions.size())
+        auto chartIndex = mChartAvailabilityTable->GetChartIndex(chartRow, versionIndex);
+        if (chartIndex<chartFirstVersions.size())
         {
             continue;
         }
 
-        if (availability.ChartIndex==chartFirstVersions.size())
+        if (chartIndex==chartFirstVersions.size())
         {
-            chartFirstVersions.emplace_back(availability.ChartIndex);
+            chartFirstVersions.emplace_back(chartIndex);
             continue;
         }
 
-        if (availability.ChartIndex>chartFirstVersions.size())
+        if (chartIndex>chartFirstVersions.size())
         {
             throw std::runtime_error("chart index is not incrementall when traversing by version.");
         }
@@ -166,44 +210,54 @@ const
     return chartFirstVersions;
 }
 
-const ChartAvailability &
+ChartAvailability
 Music::
 GetChartAvailability(StyleDifficulty styleDifficulty, std::size_t versionIndex)
 const
 {
-    auto &verTable = mChartAvailabilityTable[static_cast<std::size_t>(styleDifficulty)];
-    if (versionIndex>=verTable.size())
+    if (versionIndex>=mChartAvailabilityTable->GetVersionCount())
     {
         throw std::runtime_error("GetChartAvailability: versionIndex is out of bound.");
     }
 
-    return verTable[versionIndex];
+    return mChartAvailabilityTable->Get(GetChartRow(styleDifficulty), versionIndex);
 }
 
-std::vector<std::size_t>
+ChartStatus
 Music::
-FindSameChartVersions(StyleDifficulty styleDifficulty, std::size_t versionIndex)
+GetChartStatus(StyleDifficulty styleDifficulty, std::size_t versionIndex)
 const
 {
-    std::vector<std::size_t> versions;
-    versions.reserve(VersionNames.size());
-    auto& availability = GetChartAvailability(styleDifficulty, versionIndex);
-    if (availability.ChartAvailableStatus==ChartStatus::NotAvailable)
+    if (versionIndex>=mChartAvailabilityTable->GetVersionCount())
     {
-        return versions;
+        throw std::runtime_error("GetChartStatus: versionIndex is out of bound.");
     }
 
-    auto& verTable = mChartAvailabilityTable[static_cast<std::size_t>(styleDifficulty)];
-    static const IndexRange VersionRange{0, VersionNames.size()};
-    for (auto ver : VersionRange)
-    {
-        if (verTable[ver].ChartIndex==availability.ChartIndex)
-        {
-            versions.emplace_back(ver);
-        }
-    }
+    return mChartAvailabilityTable->GetStatus(GetChartRow(styleDifficulty), versionIndex);
+}
 
-    return versions;
+std::size_t
+Music::
+GetChartRow(StyleDifficulty styleDifficulty)
+const
+{
+    return mChartRowBegin+static_cast<std::size_t>(styleDifficulty);
+}
+
+const ChartAvailabilityTable &
+Music::
+GetChartAvailabilityTable()
+const
+{
+    return *mChartAvailabilityTable;
+}
+
+std::span<const std::uint8_t>
+Music::
+FindSameChartVersions(StyleDifficulty styleDifficulty, std::size_t versionIndex)
+const
+{
+    return mChartAvailabilityTable->GetSameChartVersions(GetChartRow(styleDifficulty), versionIndex);
 }
 
 }
@@ -3,50 +3,32 @@
 #include <array>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
+#include <span>
 #include <vector>
 
-#include "ies/Common/SmartEnum.hxx"
-
+#include "score2dx/Iidx/ChartAvailabilityTable.hpp"
 #include "score2dx/Iidx/ChartInfo.hpp"
 #include "score2dx/Iidx/MusicInfo.hpp"
 
 namespace score2dx
 {
 
-//! @brief ChartStatus denotes chart's availbility in timeline.
-//! NotAvailable: before chart debut (all versions before music's version)
-//!     Exception: two copula music 'Routing' and 'Shakunetsu Pt.2 Long Train Running'
-//!     "previewed" in pendual, will have 22 as BeginAvailable.
-//! BeginAvailable denotes first debut or revived version.
-//! Available denotes continued available version after BeginAvailable.
-//! Removed denotes version after music removed (to before it's next revive).
-//! Example: DPN of 'LUV TO ME(disco mix)' has ChartVersions '00-04, 06, 10-15'
-//!     00 01 02 03 04 05 06 07 08 09 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29
-//!     BA A  A  A  A  RM BA RM RM RM BA A  A  A  A  A  RM RM RM RM RM RM RM RM RM RM RM RM RM RM
-IES_SMART_ENUM(ChartStatus,
-    NotAvailable,
-    BeginAvailable,
-    Available,
-    Removed
-);
-
-struct ChartAvailability
-{
-    ChartStatus ChartAvailableStatus{ChartStatus::NotAvailable};
-    //! @brief ChartInfo may change because level changed.
-    ChartInfo ChartInfoProp{0, 0};
-    //! @brief Two charts are regarded as same chart if they have same notes.
-    //! This Index point to unique note chart and can use to identify chart.
-    //! @note ChartInfo may be changed (level change).
-    std::size_t ChartIndex{0};
-};
-
+//! @brief Music info and view of its charts' rows in ChartAvailabilityTable.
+//! Chart rows of a music are [ChartRowBegin, ChartRowBegin+StyleDifficultySize), in StyleDifficulty order.
 class Music
 {
 public:
+    //! @brief Standalone music owns a table of its own charts.
         explicit Music(std::size_t musicId, const std::string &title);
 
+    //! @brief Music views chart rows begin at chartRowBegin of shared table, table must outlive music.
+        Music(std::size_t musicId,
+              const std::string &title,
+              ChartAvailabilityTable &chartAvailabilityTable,
+              std::size_t chartRowBegin);
+
         std::size_t
         GetMusicId()
         const;
@@ -63,6 +45,18 @@ public:
         AddAvailability(StyleDifficulty styleDifficulty,
                         const std::map<std::string, ChartInfo> &chartInfoByChartVersions);
 
+    //! @brief Restore styleDifficulty's availability table and chart notes previously built by AddAvailability.
+    //! e.g. from MusicDatabase snapshot. availabilities must have size of VersionNames.
+        void
+        RestoreAvailability(StyleDifficulty styleDifficulty,
+                            const std::vector<ChartAvailability> &availabilities,
+                            std::vector<int> chartNotes);
+
+    //! @brief Vector of {Index=ChartIndex, ChartNote}.
+        const std::vector<int> &
+        GetChartNotes(StyleDifficulty styleDifficulty)
+        const;
+
     //! @brief Get first version of each chart first available. Vector of {Index=ChartIndex, FirstVersionIndexChartAvailable}.
     //! @example
     //! Chart 0: {0, 1, 4, 5} (remove at 2, revived at 4)
@@ -74,14 +68,28 @@ public:
         GetChartFirstAvailableVersions(StyleDifficulty styleDifficulty)
         const;
 
-        const ChartAvailability &
+        ChartAvailability
         GetChartAvailability(StyleDifficulty styleDifficulty, std::size_t versionIndex)
         const;
 
+        ChartStatus
+        GetChartStatus(StyleDifficulty styleDifficulty, std::size_t versionIndex)
+        const;
+
+    //! @brief Get row of styleDifficulty in GetChartAvailabilityTable().
+        std::size_t
+        GetChartRow(StyleDifficulty styleDifficulty)
+        const;
+
+        const ChartAvailabilityTable &
+        GetChartAvailabilityTable()
+        const;
+
     //! @brief Find versions has same chart as [versionIndex].
     //! Version can be after [versionIndex]. Must contain versionIndex if available.
     //! @note Empty if chart is not available at [versionIndex].
-        std::vector<std::size_t>
+    //! Span of {VersionIndex} in ascending order, view into precomputed index of chart availability table.
+        std::span<const std::uint8_t>
         FindSameChartVersions(StyleDifficulty styleDifficulty, std::size_t versionIndex)
         const;
 
@@ -89,8 +97,10 @@ private:
     std::size_t mMusicId;
     MusicInfo mMusicInfo;
 
-    //! @brief Array of {Index=StyleDifficulty, Vector of {Index=VersionIndex, ChartAvailability}}.
-    std::array<std::vector<ChartAvailability>, StyleDifficultySmartEnum::Size()> mChartAvailabilityTable;
+    //! @brief Owned table of standalone music, nullptr if viewing shared table.
+    std::unique_ptr<ChartAvailabilityTable> mOwnedChartAvailabilityTable;
+    ChartAvailabilityTable* mChartAvailabilityTable{nullptr};
+    std::size_t mChartRowBegin{0};
 
     //! @brief Array of {Index=StyleDifficulty, Vector of {Index=ChartIndex, ChartNote}}.
     std::array<std::vector<int>, StyleDifficultySmartEnum::Size()> mChartNoteByIndex;
@@ -39,62 +39,62 @@ TEST(Music, AddAvailability)
     };
     music.AddAvailability(StyleDifficulty::DPH, dphChartInfos);
 
-    auto &ver00 = music.GetChartAvailability(StyleDifficulty::DPH, 0);
+    auto ver00 = music.GetChartAvailability(StyleDifficulty::DPH, 0);
     EXPECT_EQ(ChartStatus::NotAvailable, ver00.ChartAvailableStatus);
 
-    auto &ver01 = music.GetChartAvailability(StyleDifficulty::DPH, 1);
+    auto ver01 = music.GetChartAvailability(StyleDifficulty::DPH, 1);
     EXPECT_EQ(ChartStatus::BeginAvailable, ver01.ChartAvailableStatus);
     EXPECT_EQ(ChartInfo(4, 363), ver01.ChartInfoProp);
     EXPECT_EQ(0u, ver01.ChartIndex);
 
-    auto &ver02 = music.GetChartAvailability(StyleDifficulty::DPH, 2);
+    auto ver02 = music.GetChartAvailability(StyleDifficulty::DPH, 2);
     EXPECT_EQ(ChartStatus::Available, ver02.ChartAvailableStatus);
     EXPECT_EQ(ChartInfo(4, 363), ver02.ChartInfoProp);
     EXPECT_EQ(0u, ver01.ChartIndex);
 
-    auto &ver04 = music.GetChartAvailability(StyleDifficulty::DPH, 4);
+    auto ver04 = music.GetChartAvailability(StyleDifficulty::DPH, 4);
     EXPECT_EQ(ChartStatus::Available, ver04.ChartAvailableStatus);
     EXPECT_EQ(ChartInfo(4, 363), ver04.ChartInfoProp);
     EXPECT_EQ(0u, ver04.ChartIndex);
 
-    auto &ver05 = music.GetChartAvailability(StyleDifficulty::DPH, 5);
+    auto ver05 = music.GetChartAvailability(StyleDifficulty::DPH, 5);
     EXPECT_EQ(ChartStatus::Available, ver05.ChartAvailableStatus);
     EXPECT_EQ(ChartInfo(6, 363), ver05.ChartInfoProp);
     EXPECT_EQ(0u, ver05.ChartIndex);
 
-    auto &ver06 = music.GetChartAvailability(StyleDifficulty::DPH, 6);
+    auto ver06 = music.GetChartAvailability(StyleDifficulty::DPH, 6);
     EXPECT_EQ(ChartStatus::Removed, ver06.ChartAvailableStatus);
 
-    auto &ver09 = music.GetChartAvailability(StyleDifficulty::DPH, 9);
+    auto ver09 = music.GetChartAvailability(StyleDifficulty::DPH, 9);
     EXPECT_EQ(ChartStatus::Removed, ver09.ChartAvailableStatus);
 
-    auto &ver10 = music.GetChartAvailability(StyleDifficulty::DPH, 10);
+    auto ver10 = music.GetChartAvailability(StyleDifficulty::DPH, 10);
     EXPECT_EQ(ChartStatus::BeginAvailable, ver10.ChartAvailableStatus);
     EXPECT_EQ(ChartInfo(6, 363), ver10.ChartInfoProp);
     EXPECT_EQ(0u, ver10.ChartIndex);
 
-    auto &ver11 = music.GetChartAvailability(StyleDifficulty::DPH, 11);
+    auto ver11 = music.GetChartAvailability(StyleDifficulty::DPH, 11);
     EXPECT_EQ(ChartStatus::Available, ver11.ChartAvailableStatus);
     EXPECT_EQ(ChartInfo(5, 363), ver11.ChartInfoProp);
     EXPECT_EQ(0u, ver10.ChartIndex);
 
-    auto &ver25 = music.GetChartAvailability(StyleDifficulty::DPH, 25);
+    auto ver25 = music.GetChartAvailability(StyleDifficulty::DPH, 25);
     EXPECT_EQ(ChartStatus::Removed, ver25.ChartAvailableStatus);
 
-    auto &ver26 = music.GetChartAvailability(StyleDifficulty::DPH, 26);
+    auto ver26 = music.GetChartAvailability(StyleDifficulty::DPH, 26);
     EXPECT_EQ(ChartStatus::BeginAvailable, ver26.ChartAvailableStatus);
     EXPECT_EQ(ChartInfo(5, 400), ver26.ChartInfoProp);
     EXPECT_EQ(1u, ver26.ChartIndex);
 
-    auto &ver27 = music.GetChartAvailability(StyleDifficulty::DPH, 27);
+    auto ver27 = music.GetChartAvailability(StyleDifficulty::DPH, 27);
     EXPECT_EQ(ChartStatus::Removed, ver27.ChartAvailableStatus);
 
-    auto &ver28 = music.GetChartAvailability(StyleDifficulty::DPH, 28);
+    auto ver28 = music.GetChartAvailability(StyleDifficulty::DPH, 28);
     EXPECT_EQ(ChartStatus::BeginAvailable, ver28.ChartAvailableStatus);
     EXPECT_EQ(ChartInfo(5, 363), ver28.ChartInfoProp);
     EXPECT_EQ(0u, ver28.ChartIndex);
 
-    auto &ver29 = music.GetChartAvailability(StyleDifficulty::DPH, 29);
+    auto ver29 = music.GetChartAvailability(StyleDifficulty::DPH, 29);
     ASSERT_EQ(ChartStatus::Removed, ver29.ChartAvailableStatus);
 }
 
@@ -79,14 +79,15 @@ GetLatestVersionIndex()
 std::optional<std::size_t>
 FindVersionIndex(const std::string &dbVersionName)
 {
-    static std::map<std::string, std::size_t> VersionIndexMap;
-    if (VersionIndexMap.empty())
+    static const std::map<std::string, std::size_t> VersionIndexMap = []()
     {
+        std::map<std::string, std::size_t> versionIndexMap;
         for (auto index : IndexRange{0, VersionNames.size()})
         {
-            VersionIndexMap[VersionNames[index]] = index;
+            versionIndexMap[VersionNames[index]] = index;
         }
-    }
+        return versionIndexMap;
+    }();
 
     if (auto findIndex = ies::Find(VersionIndexMap, dbVersionName))
     {
@@ -28,6 +28,13 @@ const
     return mMusicId;
 }
 
+void
+MusicScore::
+SetMusicId(std::size_t musicId)
+{
+    mMusicId = musicId;
+}
+
 PlayStyle
 MusicScore::
 GetPlayStyle()
@@ -66,6 +73,14 @@ SetDateTime(const std::string &dateTime)
     mDateTime = dateTime;
 }
 
+ScoreSource
+MusicScore::
+GetScoreSource()
+const
+{
+    return mScoreSource;
+}
+
 ChartScore &
 MusicScore::
 EnableChartScore(Difficulty difficulty)
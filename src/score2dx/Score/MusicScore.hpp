@@ -31,6 +31,10 @@ public:
         GetMusicId()
         const;
 
+    //! @brief Set MusicId, e.g. same music has other MusicId in reloaded database.
+        void
+        SetMusicId(std::size_t musicId);
+
         PlayStyle
         GetPlayStyle()
         const;
@@ -49,6 +53,10 @@ public:
         void
         SetDateTime(const std::string &dateTime);
 
+        ScoreSource
+        GetScoreSource()
+        const;
+
     //! @brief ChartScore is default disabled, enable to use.
         ChartScore &
         EnableChartScore(Difficulty difficulty);
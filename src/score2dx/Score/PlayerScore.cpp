@@ -3,21 +3,62 @@
 #include <iostream>
 #include <optional>
 #include <stdexcept>
+#include <utility>
+
+#include "ies/Common/IntegralRangeUsing.hpp"
+
+#include "score2dx/Iidx/Version.hpp"
 
 namespace score2dx
 {
 
 PlayerScore::
-PlayerScore(const MusicDatabase &musicDatabase, const std::string &iidxId)
-:   mMusicDatabase(musicDatabase),
+PlayerScore(std::shared_ptr<const MusicDatabase> musicDatabase, const std::string &iidxId)
+:   mMusicDatabase(std::move(musicDatabase)),
     mIidxId(iidxId)
 {
+    if (!mMusicDatabase)
+    {
+        throw std::runtime_error("PlayerScore: musicDatabase is null.");
+    }
+
     if (!IsIidxId(iidxId))
     {
         throw std::runtime_error("["+iidxId+"] is not a valid IIDX ID.");
     }
 }
 
+PlayerScore::
+PlayerScore(std::shared_ptr<const MusicDatabase> musicDatabase, const PlayerScore &playerScore)
+:   PlayerScore(std::move(musicDatabase), playerScore.GetIidxId())
+{
+    auto &sourceDatabase = *playerScore.mMusicDatabase;
+    for (auto &[sourceMusicId, versionScoreTable] : playerScore.GetVersionScoreTables())
+    {
+        auto findMusicId = mMusicDatabase->FindMusicId(sourceDatabase, sourceMusicId);
+        if (!findMusicId)
+        {
+            std::cout << "PlayerScore: ["+mIidxId+"] scores of music ["+sourceDatabase.GetTitle(sourceMusicId)
+                         +"] are dropped, music is not found in database.\n";
+            continue;
+        }
+
+        for (auto playStyle : PlayStyleSmartEnum::ToRange())
+        {
+            for (auto scoreVersionIndex : IndexRange{0, VersionNames.size()})
+            {
+                for (auto &[dateTime, musicScore] : versionScoreTable.GetMusicScores(scoreVersionIndex, playStyle))
+                {
+                    (void)dateTime;
+                    auto remappedScore = musicScore;
+                    remappedScore.SetMusicId(findMusicId.value());
+                    AddMusicScore(scoreVersionIndex, remappedScore);
+                }
+            }
+        }
+    }
+}
+
 const std::string &
 PlayerScore::
 GetIidxId()
@@ -26,13 +67,21 @@ const
     return mIidxId;
 }
 
+const MusicDatabase &
+PlayerScore::
+GetMusicDatabase()
+const
+{
+    return *mMusicDatabase;
+}
+
 void
 PlayerScore::
 AddMusicScore(std::size_t scoreVersionIndex,
               const MusicScore &musicScore)
 {
     auto musicId = musicScore.GetMusicId();
-    auto& music = mMusicDatabase.GetMusic(musicId);
+    auto& music = mMusicDatabase->GetMusic(musicId);
     auto [it, flag] = mVersionScoreTables.emplace(musicId, music);
     auto& scoreTable = it->second;
     scoreTable.AddMusicScore(scoreVersionIndex, musicScore);
@@ -48,7 +97,7 @@ AddChartScore(std::size_t scoreVersionIndex,
               const std::string &dateTime,
               const ChartScore &chartScore)
 {
-    auto& music = mMusicDatabase.GetMusic(musicId);
+    auto& music = mMusicDatabase->GetMusic(musicId);
     auto [it, flag] = mVersionScoreTables.emplace(musicId, music);
     auto& scoreTable = it->second;
     scoreTable.AddChartScore(scoreVersionIndex, dateTime, playStyle, difficulty, chartScore);
@@ -62,7 +111,7 @@ Propagate()
 /*
     for (auto &[musicId, versionScoreTable] : mVersionScoreTables)
     {
-        auto &music = mMusicDatabase.GetMusic(musicId);
+        auto &music = mMusicDatabase->GetMusic(musicId);
         versionScoreTable.CleanupInVersionScores();
 
         for (auto playStyle : PlayStyleSmartEnum::ToRange())
@@ -74,7 +123,7 @@ Propagate()
                 std::optional<std::size_t> previousClearVersionIndex;
                 for (auto scoreVersionIndex : GetSupportScoreVersionRange())
                 {
-                    auto &availability = music.GetChartAvailability(styleDifficulty, scoreVersionIndex);
+                    auto availability = music.GetChartAvailability(styleDifficulty, scoreVersionIndex);
                     if (availability.ChartAvailableStatus!=ChartStatus::BeginAvailable
                         &&availability.ChartAvailableStatus!=ChartStatus::Available)
                     {
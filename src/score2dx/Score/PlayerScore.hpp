@@ -17,12 +17,22 @@ namespace score2dx
 class PlayerScore
 {
 public:
-        PlayerScore(const MusicDatabase &musicDatabase, const std::string &iidxId);
+        PlayerScore(std::shared_ptr<const MusicDatabase> musicDatabase, const std::string &iidxId);
+
+    //! @brief Rebuild playerScore with another MusicDatabase (e.g. reloaded database), scores are copied
+    //! with MusicId of same music in musicDatabase, see MusicDatabase::FindMusicId(sourceDatabase, sourceMusicId).
+    //! Scores of music not found in musicDatabase are dropped and reported.
+        PlayerScore(std::shared_ptr<const MusicDatabase> musicDatabase, const PlayerScore &playerScore);
 
         const std::string &
         GetIidxId()
         const;
 
+    //! @brief MusicDatabase which MusicIds of scores belong to.
+        const MusicDatabase &
+        GetMusicDatabase()
+        const;
+
     //! @brief Add MusicScore, usually from CSV data.
     //! @note Does nothing if exist MusicScore with same date time.
     //! (Not check if adding musicScore and existing MusicScore are same or not.)
@@ -53,7 +63,7 @@ public:
         const;
 
 private:
-    const MusicDatabase &mMusicDatabase;
+    std::shared_ptr<const MusicDatabase> mMusicDatabase;
     std::string mIidxId;
 
     //! @brief Map of {MusicId, VersionScoreTable}.